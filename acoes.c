@@ -0,0 +1,112 @@
+#include "acoes.h"
+
+// Com MATRIZ_BYTECODE as teclas 1 a 7 tocam os programas de animacoes.anim
+#if MATRIZ_BYTECODE
+#include "animacoes_bytecode.h"
+#define ANIMACAO(n) (&bytecode_animacao_##n)
+#else
+#define ANIMACAO(n) (&animacao_##n)
+#endif
+
+// Texto rolante da tecla 9. O número de quadros depende da largura do
+// texto, então os objetos não podem ser constantes como as demais animações.
+// Os comandos do console alteram o pendente; um aperto da tecla 9 depois de
+// uma mudança o copia para uma das duas cópias tocadas, alternando, para que
+// a que sai numa transição de 9 para 9 não mude no meio.
+static texto_rolante_t texto_pendente;
+static texto_rolante_t textos_tocados[2];
+static uint8_t texto_tocado;
+static bool texto_alterado;
+
+static void preparar_texto(void) {
+    static bool iniciado;
+    if (!iniciado) {
+        texto_rolante_iniciar(&texto_pendente, MATRIZ_TEXTO, 0, INTENSIDADE(0.5), INTENSIDADE(0.5), FPS_TEXTO);
+        texto_alterado = true;
+        iniciado = true;
+    }
+}
+
+const texto_rolante_t *acoes_texto(void) {
+    preparar_texto();
+    return &texto_pendente;
+}
+
+bool acoes_texto_comando(char comando, const char *argumento) {
+    preparar_texto();
+    if (!texto_rolante_comando(&texto_pendente, comando, argumento)) {
+        return false;
+    }
+    texto_alterado = true;
+    return true;
+}
+
+// Texto a tocar no aperto da tecla 9, com as mudanças pendentes aplicadas
+static const texto_rolante_t *texto_para_tocar(escalonador_t *escalonador) {
+    preparar_texto();
+    if (texto_alterado) {
+        texto_tocado ^= 1;
+        textos_tocados[texto_tocado] = texto_pendente;
+        if (escalonador->cache) {
+            // Os quadros guardados são de um texto, cor ou largura anteriores
+            cache_quadros_esquecer(escalonador->cache, &textos_tocados[texto_tocado].animacao);
+        }
+        texto_alterado = false;
+    }
+    return &textos_tocados[texto_tocado];
+}
+
+void executar_acao_tecla(char key, escalonador_t *escalonador, uint64_t agora) {
+    switch (key) {
+        case '1': // Executa a animação 1 com 10 fps
+            escalonador_tocar(escalonador, ANIMACAO(1), FPS(10), agora);
+            break;
+        case '2': // Executa a animação 2 com 5 fps
+            escalonador_tocar(escalonador, ANIMACAO(2), FPS(5), agora);
+            break;
+        case '3': // Executa a animação 3 com 2 fps
+            escalonador_tocar(escalonador, ANIMACAO(3), FPS(2), agora);
+            break;
+        case '4': // Executa a animação 4 com 10 fps
+            escalonador_tocar(escalonador, ANIMACAO(4), FPS(10), agora);
+            break;
+        case '5': // Executa a animação 5 com 10 fps 
+            escalonador_tocar(escalonador, ANIMACAO(5), FPS(10), agora);
+            break;
+        case '6': // Executa a animação 6 com 2 fps
+            escalonador_tocar(escalonador, ANIMACAO(6), FPS(2), agora);
+            break;
+        case '7': // Executa a animação 7 com 5 fps
+            escalonador_tocar(escalonador, ANIMACAO(7), FPS(5), agora);
+            break;
+        case '9': { // Passa o texto pela matriz, da direita para a esquerda
+            const texto_rolante_t *texto = texto_para_tocar(escalonador);
+            escalonador_tocar(escalonador, &texto->animacao, texto->mili_fps, agora);
+            break;
+        }
+        case '0': // Soma (ou retira) a contagem regressiva da animação 4 sobre o que estiver tocando
+            if (escalonador_camada_visivel(escalonador, CAMADA_SOBREPOSICAO)) {
+                escalonador_remover(escalonador, CAMADA_SOBREPOSICAO);
+            } else {
+                escalonador_sobrepor(escalonador, CAMADA_SOBREPOSICAO, ANIMACAO(4), FPS(10), MISTURA_SOMAR, 255, agora);
+            }
+            break;
+        case 'A': // Desliga todos os LEDs (cor preta)
+            escalonador_tocar(escalonador, &animacao_apagar, FPS_ESTATICO, agora);
+            break;
+        case 'B': // Configura todos os LEDs na cor azul
+            escalonador_tocar(escalonador, &animacao_azul_100, FPS_ESTATICO, agora);
+            break;
+        case 'C': // Configura todos os LEDs na cor vermelha
+            escalonador_tocar(escalonador, &animacao_vermelho_80, FPS_ESTATICO, agora);
+            break;
+        case 'D': // Configura todos os LEDs na cor verde
+            escalonador_tocar(escalonador, &animacao_verde_50, FPS_ESTATICO, agora);
+            break;
+        case '#': // Configura todos os LEDs com baixa intensidade branca
+            escalonador_tocar(escalonador, &animacao_branco_20, FPS_ESTATICO, agora);
+            break;
+        default: // Nenhuma ação para outras teclas
+            break;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef ACOES_H
+#define ACOES_H
+
+#include <stdint.h>
+#include "escalonador.h"
+#include "texto.h"
+
+// Taxa usada pelos quadros estáticos de cor única (teclas A, B, C, D e #)
+#define FPS_ESTATICO FPS(1)
+
+// Texto rolante da tecla 9 até ser trocado pelo console (comando t)
+#ifndef MATRIZ_TEXTO
+#define MATRIZ_TEXTO "MATRIZ DE LEDS"
+#endif
+
+// Velocidade inicial do texto rolante, em colunas por segundo
+#define FPS_TEXTO FPS(8)
+
+// Retorna a cópia do texto rolante da tecla 9 que os comandos do console
+// alteram, preparada na primeira chamada. As mudanças só chegam à animação
+// no próximo aperto da tecla 9.
+const texto_rolante_t *acoes_texto(void);
+
+// Função para aplicar um comando de texto do console (texto_rolante_comando())
+// à cópia de acoes_texto(). Só o núcleo que desenha deve chamá-la.
+// Parâmetros:
+// - comando: 't', 'v' ou 'k'
+// - argumento: Resto da linha
+// Retorna:
+// - false se o comando ou o argumento for inválido (nada muda)
+bool acoes_texto_comando(char comando, const char *argumento);
+
+// Função para executar a ação correspondente à tecla pressionada
+// Parâmetros:
+// - key: Caractere da tecla pressionada
+// - escalonador: Escalonador que passa a exibir a animação da tecla,
+//   interrompendo a que estiver em andamento (a tecla 0 sobrepõe em vez de trocar)
+// - agora: Instante atual em microssegundos
+void executar_acao_tecla(char key, escalonador_t *escalonador, uint64_t agora);
+
+#endif
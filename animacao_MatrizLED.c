@@ -1,540 +1,511 @@
-#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "hardware/adc.h"
 #include "hardware/clocks.h"
 #include "hardware/pio.h"
 #include "pico/bootrom.h"
 #include "pico/stdlib.h"
+#include "formato_pixel.h"
 #include "animacao_MatrizLED.pio.h"
+#include "acoes.h"
+#include "animacoes.h"
+#include "cache_quadros.h"
+#include "console.h"
+#include "escalonador.h"
+#include "fluxo_quadros.h"
+#include "pontilhamento.h"
+#include "repouso.h"
+#include "saida_leds.h"
+#include "sono.h"
+#include "teclado.h"
+#include "texto.h"
+#include "transporte_pio_dma.h"
+#include "uso_cpu.h"
+
+#if MATRIZ_DUAL_CORE
+#include "pico/multicore.h"
+#endif
+
+#if MATRIZ_MEDIR_CICLOS
+#include "hardware/structs/systick.h"
+#include "cor_referencia.h"
+#endif
 
 // Configurações gerais da matriz de LEDs
-#define NUM_PIXELS 25 // Número total de LEDs na matriz
-#define OUT_PIN 7 // GPIO usado para controlar a matriz de LEDs
-
-// Configurações para o teclado matricial
-#define TECLADO_PIN_1 28 // GPIO conectado à linha 1 
-#define TECLADO_PIN_2 27 // GPIO conectado à linha 2 
-#define TECLADO_PIN_3 26 // GPIO conectado à linha 3 
-#define TECLADO_PIN_4 22 // GPIO conectado à linha 4
-#define COL1_PIN 21 // GPIO conectado à coluna 1
-#define COL2_PIN 20 // GPIO conectado à coluna 2
-#define COL3_PIN 19 // GPIO conectado à coluna 3
-#define COL4_PIN 18 // GPIO conectado à coluna 4
-
-// Declaração das funções de animação (prototipadas)
-void animacao_1(PIO pio, uint sm, int fps);
-void animacao_2(PIO pio, uint sm, int fps);
-void animacao_3(PIO pio, uint sm, int fps);
-void animacao_4(PIO pio, uint sm, int fps);
-void animacao_5(PIO pio, uint sm, int fps);
-void animacao_6(PIO pio, uint sm, int fps);
-void animacao_7(PIO pio, uint sm, int fps);
-
-// Função para calcular a cor RGB para os LEDs
-// Parâmetros:
-// - b: Intensidade do canal azul (valor de 0.0 a 1.0)
-// - r: Intensidade do canal vermelho (valor de 0.0 a 1.0)
-// - g: Intensidade do canal verde (valor de 0.0 a 1.0)
-// Retorna:
-// - Valor de 32 bits no formato (G, R, B)
-uint32_t calcular_cor_rgb(double b, double r, double g) {
-    unsigned char R = r * 255;
-    unsigned char G = g * 255;
-    unsigned char B = b * 255;
-    return (G << 24) | (R << 16) | (B << 8);
-}
+#define OUT_PIN 7 // GPIO usado para controlar a matriz de LEDs (via 0; as demais vias usam os GPIOs seguintes)
+
+// Reenvio periódico do último quadro quando nada muda na matriz (0 desliga)
+#ifndef MATRIZ_INTERVALO_MANTER_MS
+#define MATRIZ_INTERVALO_MANTER_MS 0
+#endif
+
+// Duração do crossfade entre a animação que sai e a que entra (0 troca na hora)
+#ifndef MATRIZ_TRANSICAO_MS
+#define MATRIZ_TRANSICAO_MS 0
+#endif
+
+// Guarda os quadros já desenhados de cada animação (0 desenha sempre)
+#ifndef MATRIZ_CACHE_QUADROS
+#define MATRIZ_CACHE_QUADROS 0
+#endif
+
+// Inatividade até apagar a matriz e, depois de apagada, até o processador
+// dormir esperando uma tecla (0 desliga cada etapa)
+#ifndef MATRIZ_REPOUSO_APAGAR_S
+#define MATRIZ_REPOUSO_APAGAR_S 0
+#endif
+#ifndef MATRIZ_REPOUSO_DORMIR_S
+#define MATRIZ_REPOUSO_DORMIR_S 0
+#endif
+
+// Intervalo entre os relatórios de utilização dos núcleos no modo de dois núcleos
+#define INTERVALO_RELATORIO_USO_US 5000000
 
-// Função para configurar todos os LEDs da matriz com uma única cor
+// Função para configurar a GPIO e inicializar o PIO para controlar a matriz
 // Parâmetros:
 // - pio: Instância do bloco PIO
-// - sm: Máquina de estado utilizada
-// - r: Intensidade do vermelho (valor de 0.0 a 1.0)
-// - g: Intensidade do verde (valor de 0.0 a 1.0)
-// - b: Intensidade do azul (valor de 0.0 a 1.0)
-void configurar_todos_leds(PIO pio, uint sm, double r, double g, double b) {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        uint32_t color = calcular_cor_rgb(b, r, g);
-        pio_sm_put_blocking(pio, sm, color);
+// - sm: Vetor que recebe uma máquina de estado por via (MATRIZ_VIAS)
+// - pin: GPIO conectado ao controle da via 0 da matriz de LEDs
+void configurar_gpio_pio(PIO pio, uint *sm, uint pin) {
+    // O programa do tempo escolhido (formato_pixel.h) é carregado uma vez e
+    // compartilhado pelas máquinas de todas as vias
+    uint offset = pio_add_program(pio, &PROGRAMA_LEDS(_program));
+    for (int via = 0; via < MATRIZ_VIAS; via++) {
+        sm[via] = pio_claim_unused_sm(pio, true);
+        animacao_MatrizLED_program_init(pio, sm[via], offset, PROGRAMA_LEDS(_program_get_default_config)(offset),
+                                        pin + via, PIXEL_BITS);
     }
 }
 
-// Configura alguns LEDs para uma cor específica
-// Parâmetros:
-// - int *leds : ponteiro para vetor contendo os LEDs que serão acesos
-// - int quant_leds : quantidade de LEDs que acenderão
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - r: Intensidade da cor vermelha (0.0 a 1.0)
-// - g: Intensidade da cor verde (0.0 a 1.0)
-// - b: Intensidade da cor azul (0.0 a 1.0)
-void configurar_alguns_leds(int *leds,int quant_leds,PIO pio, uint sm, double r, double g, double b) {
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        bool selecionado = false;
-        for(int j=0;j<quant_leds;j++){
-            if(i==leds[j]){
-                selecionado=true;
-            }
-        }
-        if(selecionado){
-            uint32_t color = calcular_cor_rgb(b, r, g);
-            pio_sm_put_blocking(pio, sm, color);
-        }else{
-            pio_sm_put_blocking(pio, sm, 0);
-        }
-        
+#if MATRIZ_MEDIR_CICLOS
+// Mede com o SysTick (contador de ciclos do processador, 24 bits) quantos
+// ciclos custa desenhar um quadro da animação 5 no caminho de referência em
+// double e no caminho em ponto fixo, e imprime o resultado no stdio junto
+// com o custo do pontilhamento e o de compor todas as camadas.
+static void medir_ciclos_animacao_5(void) {
+    uint32_t quadro[NUM_PIXELS];
+
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    // O SysTick conta para baixo
+    uint32_t inicio = systick_hw->cvr;
+    referencia_animacao_5(quadro, NUM_PIXELS, 7);
+    uint32_t ciclos_double = (inicio - systick_hw->cvr) & 0x00FFFFFF;
+
+    inicio = systick_hw->cvr;
+    animacao_5.desenhar(&animacao_5, quadro, 7);
+    uint32_t ciclos_ponto_fixo = (inicio - systick_hw->cvr) & 0x00FFFFFF;
+
+    printf("animacao_5: %lu ciclos/quadro em double, %lu ciclos/quadro em ponto fixo\n",
+           (unsigned long)ciclos_double, (unsigned long)ciclos_ponto_fixo);
+
+#if MATRIZ_PONTILHAMENTO
+    // Custo de uma renovação (sem o envio), que se repete MATRIZ_PONTILHAMENTO_HZ vezes por segundo
+    static cor16_t conteudo[NUM_PIXELS], erro[NUM_PIXELS];
+    animacao_5.desenhar16(&animacao_5, conteudo, 7);
+    inicio = systick_hw->cvr;
+    pontilhamento_quantizar(conteudo, erro, quadro, NUM_PIXELS);
+    uint32_t ciclos_renovacao = (inicio - systick_hw->cvr) & 0x00FFFFFF;
+    printf("pontilhamento: %lu ciclos/renovacao, %lu.%02lu%% de um nucleo a %d Hz\n",
+           (unsigned long)ciclos_renovacao,
+           (unsigned long)((uint64_t)ciclos_renovacao * MATRIZ_PONTILHAMENTO_HZ * 100 / clock_get_hz(clk_sys)),
+           (unsigned long)((uint64_t)ciclos_renovacao * MATRIZ_PONTILHAMENTO_HZ * 10000 / clock_get_hz(clk_sys) % 100),
+           MATRIZ_PONTILHAMENTO_HZ);
+#endif
+
+    // Pior caso do compositor: as quatro camadas visíveis, nenhuma opaca
+    static camada_t camadas[COMPOSITOR_CAMADAS];
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        animacao_5.desenhar(&animacao_5, camadas[c].quadro.pixels, (uint16_t)(7 + c));
+        camadas[c].opacidade = 200;
+        camadas[c].modo = (modo_mistura_t)(c % 3);
+        camadas[c].visivel = true;
     }
+    inicio = systick_hw->cvr;
+    compositor_compor(camadas, COMPOSITOR_CAMADAS, quadro);
+    uint32_t ciclos_composicao = (inicio - systick_hw->cvr) & 0x00FFFFFF;
+    uint32_t periodo_ciclos = (uint32_t)((uint64_t)clock_get_hz(clk_sys) * 1000 / FPS_TRANSICAO);
+    printf("compositor: %lu ciclos para %d camadas, %lu.%02lu%% do periodo de uma transicao\n",
+           (unsigned long)ciclos_composicao, COMPOSITOR_CAMADAS,
+           (unsigned long)((uint64_t)ciclos_composicao * 100 / periodo_ciclos),
+           (unsigned long)((uint64_t)ciclos_composicao * 10000 / periodo_ciclos % 100));
+}
+#endif
+
+static transporte_pio_dma_t transporte; // Envio dos quadros por DMA
+static saida_leds_t saida; // Framebuffer duplo da matriz
+static escalonador_t escalonador; // Avança a animação ativa sem bloquear
+#if MATRIZ_CACHE_QUADROS
+static cache_quadros_t cache; // Quadros prontos das animações
+static uint8_t memoria_cache[MATRIZ_CACHE_BYTES];
+#endif
+#if MATRIZ_PONTILHAMENTO
+static pontilhamento_t pontilhamento; // Renova a matriz a partir dos quadros de 8.8 bits
+#endif
+#if !MATRIZ_DUAL_CORE
+static repouso_t repouso; // Apaga a matriz e dorme depois de um tempo sem teclas
+#endif
+static fluxo_quadros_t fluxo; // Recepção de quadros pelo stdio (tecla 8)
+static volatile bool fluxo_ativo; // Lido pelo núcleo do console no modo de dois núcleos
+
+// Tecla que liga o modo de recepção de quadros enviados pelo computador
+#define TECLA_FLUXO '8'
+
+static void relatar_fluxo(void) {
+    const fluxo_estatisticas_t *estatisticas = &fluxo.estatisticas;
+    printf("fluxo: recebidos %lu, perdidos %lu, corrompidos %lu, atrasados %lu\n",
+           (unsigned long)estatisticas->recebidos, (unsigned long)estatisticas->perdidos,
+           (unsigned long)estatisticas->corrompidos, (unsigned long)estatisticas->atrasados);
 }
 
-// Função para configurar a GPIO e inicializar o PIO para controlar a matriz
+// Função para aplicar um comando de linha do console (t, v ou k) ao texto
+// rolante da tecla 9, no núcleo que desenha; o texto que está passando não
+// muda até o próximo aperto da tecla 9
 // Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Ponteiro para a máquina de estado
-// - pin: GPIO conectado ao controle da matriz de LEDs
-void configurar_gpio_pio(PIO pio, uint *sm, uint pin) {
-    uint offset = pio_add_program(pio, &animacao_MatrizLED_program);
-    *sm = pio_claim_unused_sm(pio, true);
-    animacao_MatrizLED_program_init(pio, *sm, offset, pin);
+// - comando: Letra do comando
+// - argumento: Resto da linha
+static void aplicar_linha(char comando, const char *argumento) {
+    if (!acoes_texto_comando(comando, argumento)) {
+        printf("texto: argumento invalido para %c\n", comando);
+        return;
+    }
+    const texto_rolante_t *texto = acoes_texto();
+    printf("texto: %u quadros a %lu.%03lu colunas/s (vale no proximo aperto da tecla 9)\n",
+           (unsigned)texto->animacao.quant_quadros, (unsigned long)(texto->mili_fps / 1000),
+           (unsigned long)(texto->mili_fps % 1000));
 }
 
-// Função para configurar os pinos utilizados pelo teclado matricial
-// Configura as linhas como saída e as colunas como entrada
-void configurar_teclado() {
-    // Configurar pinos das linhas como saída
-    gpio_init(TECLADO_PIN_1);
-    gpio_init(TECLADO_PIN_2);
-    gpio_init(TECLADO_PIN_3);
-    gpio_init(TECLADO_PIN_4);
-
-    gpio_set_dir(TECLADO_PIN_1, GPIO_OUT);
-    gpio_set_dir(TECLADO_PIN_2, GPIO_OUT);
-    gpio_set_dir(TECLADO_PIN_3, GPIO_OUT);
-    gpio_set_dir(TECLADO_PIN_4, GPIO_OUT);
-
-    // Configurar pinos das colunas como entrada
-    gpio_init(COL1_PIN);
-    gpio_init(COL2_PIN);
-    gpio_init(COL3_PIN);
-    gpio_init(COL4_PIN);
-
-    gpio_set_dir(COL1_PIN, GPIO_IN);
-    gpio_set_dir(COL2_PIN, GPIO_IN);
-    gpio_set_dir(COL3_PIN, GPIO_IN);
-    gpio_set_dir(COL4_PIN, GPIO_IN);
-
-    gpio_pull_down(COL1_PIN);
-    gpio_pull_down(COL2_PIN);
-    gpio_pull_down(COL3_PIN);
-    gpio_pull_down(COL4_PIN);
+#if MATRIZ_DUAL_CORE
+// Marca enviada pela FIFO entre núcleos no lugar de uma tecla quando há uma
+// linha do console esperando o núcleo 1
+#define TECLA_LINHA_CONSOLE '\x01'
+
+// Bit das palavras da FIFO entre núcleos que levam um comando de uma letra
+// do console (d, p, c, b, r, z) em vez de uma tecla
+#define PALAVRA_COMANDO_CONSOLE 0x100u
+
+// Linha do console copiada pelo núcleo 0 para o núcleo 1 aplicar
+static char comando_pendente;
+static char argumento_pendente[MATRIZ_TEXTO_MAX + 1];
+static volatile bool linha_pendente;
+
+// Núcleo 0: o texto rolante pertence ao núcleo 1, então a linha só é
+// copiada e avisada pela FIFO
+static void encaminhar_linha(char comando, const char *argumento) {
+    if (linha_pendente || !multicore_fifo_wready()) {
+        printf("texto: comando anterior ainda pendente, tente de novo\n");
+        return;
+    }
+    comando_pendente = comando;
+    strncpy(argumento_pendente, argumento, MATRIZ_TEXTO_MAX);
+    argumento_pendente[MATRIZ_TEXTO_MAX] = '\0';
+    linha_pendente = true;
+    multicore_fifo_push_blocking(TECLA_LINHA_CONSOLE);
 }
 
-// Função para verificar qual tecla do teclado matricial foi pressionada
-// Retorna:
-// - Caractere correspondente à tecla pressionada
-// - 0 se nenhuma tecla foi pressionada
-char verificar_teclado() {
-    const char keys[4][4] = {
-        {'1', '2', '3', 'A'},
-        {'4', '5', '6', 'B'},
-        {'7', '8', '9', 'C'},
-        {'*', '0', '#', 'D'}};
-
-    for (int row = 0; row < 4; row++) {
-        gpio_put(TECLADO_PIN_1, row == 0);
-        gpio_put(TECLADO_PIN_2, row == 1);
-        gpio_put(TECLADO_PIN_3, row == 2);
-        gpio_put(TECLADO_PIN_4, row == 3);
-
-        sleep_us(10); // Tempo para estabilizar
-
-        if (gpio_get(COL1_PIN)) return keys[row][0];
-        if (gpio_get(COL2_PIN)) return keys[row][1];
-        if (gpio_get(COL3_PIN)) return keys[row][2];
-        if (gpio_get(COL4_PIN)) return keys[row][3];
+// Núcleo 0: os contadores da saída, do escalonador e da instrumentação são
+// escritos pelo núcleo 1, então os comandos que os leem ou alteram vão pela
+// FIFO e o núcleo 1 os executa entre um quadro e outro
+static void encaminhar_comando(char comando) {
+    if (!multicore_fifo_wready()) {
+        printf("console: nucleo 1 ocupado, tente de novo\n");
+        return;
     }
-
-    return 0; // Nenhuma tecla pressionada
+    multicore_fifo_push_blocking(PALAVRA_COMANDO_CONSOLE | (uint8_t)comando);
 }
+#endif
 
-// ANIMAÇÕES 
+// Acorde que reinicia a placa no modo BOOTSEL, para gravar pelo USB sem
+// apertar o botão: '*' segurado e '#' (só essas duas teclas)
+#define ACORDE_BOOTSEL (teclado_mascara('*') | teclado_mascara('#'))
 
-// Animação 1: alternância entre vermelho e verde
+// Função para tratar os acordes do teclado
 // Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_1(PIO pio, uint sm, int fps) {
-    for (int frame = 0; frame < 5; frame++) {
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            uint32_t color = (frame % 2 == 0) ? calcular_cor_rgb(0.5, 0.0, 0.0) : calcular_cor_rgb(0.0, 0.5, 0.0);
-            pio_sm_put_blocking(pio, sm, color);
-        }
-        sleep_ms(1000 / fps);
+// - evento: Evento de tecla retirado da fila
+// Retorna:
+// - true se o evento completou um acorde (a tecla não executa a sua ação)
+static bool tratar_acorde(const evento_tecla_t *evento) {
+    if (!evento->pressionada || evento->estado != ACORDE_BOOTSEL) {
+        return false;
     }
+    reset_usb_boot(0, 0);
+    return true;
 }
 
-// Animação 2: Efeito de onda de cores (alterna entre azul, verde e vermelho em sequência)
+// Função para tratar uma tecla apertada no núcleo que desenha
 // Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_2(PIO pio, uint sm, int fps) {
-    for (int frame = 0; frame < 50; frame++) { // Duração de 50 quadros
-        for (int i = 0; i < NUM_PIXELS; i++) {
-            double intensidade = 0.5 + 0.5 * sin((frame + i) * 0.3); // Onda de intensidade
-            uint32_t cor;
-
-            if ((frame / 10) % 3 == 0) {
-                // Azul com onda
-                cor = calcular_cor_rgb(intensidade, 0.0, 0.0);
-            } else if ((frame / 10) % 3 == 1) {
-                // Verde com onda
-                cor = calcular_cor_rgb(0.0, 0.0, intensidade);
-            } else {
-                // Vermelho com onda
-                cor = calcular_cor_rgb(0.0, intensidade, 0.0);
-            }
-
-            pio_sm_put_blocking(pio, sm, cor); // Envia cor para cada LED
+// - key: Caractere da tecla pressionada
+// A tecla 8 interrompe a animação e passa a exibir os quadros recebidos pelo
+// stdio; qualquer outra tecla encerra a recepção e executa a sua ação. No
+// modo de dois núcleos, TECLA_LINHA_CONSOLE aplica a linha do console pendente.
+static void tratar_tecla(char key) {
+#if MATRIZ_DUAL_CORE
+    if (key == TECLA_LINHA_CONSOLE) {
+        aplicar_linha(comando_pendente, argumento_pendente);
+        linha_pendente = false;
+        return;
+    }
+#endif
+    if (key == TECLA_FLUXO) {
+        if (!fluxo_ativo) {
+            escalonador_parar(&escalonador);
+            fluxo_iniciar(&fluxo, &saida);
+            fluxo_ativo = true;
         }
-        sleep_ms(1000 / fps); // Aguarda até o próximo quadro
+        return;
     }
+    if (fluxo_ativo) {
+        fluxo_ativo = false;
+        relatar_fluxo();
+    }
+    executar_acao_tecla(key, &escalonador, time_us_64());
 }
- 
-// Animação 3: Alternância entre as letras D(azul), A(amarelo), V(roxo), I(verde) e D(vermelho)
-// Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_3(PIO pio, uint sm, int fps) { 
-    for (int frame = 0; frame < 5; frame++) {
-        uint32_t color2 = calcular_cor_rgb(0.0, 0.0, 0.0);
-        
-        if (frame == 0)
-        {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.0, 0.0);
-                if (i==2 || i==3 || i==4 || i==8 || i==5 || i==10 || i==14 || i==18 || i==15 || i==22 || i==23 || i==24)
-                {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else if (frame == 1)
-        {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.5, 0.5);
-                if (i==0 || i==4 || i==5 || i==6 || i==7 || i==8 || i==9 || i==11 || i==13 || i==16 || i==18 || i==22)
-                {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        }else if (frame == 2)
-        {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.5, 0.0);
-                if (i==2 || i==6 || i==8 || i==11 || i==13 || i==15 || i==19 || i==20 || i==24)
-                {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else if (frame == 3)
-        {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.0, 0.5);
-                if (i==2 || i==7 || i==12 || i==17 || i==22)
-                {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else
-        {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.5, 0.0);
-                if (i==2 || i==3 || i==4 || i==8 || i==5 || i==10 || i==14 || i==18 || i==15 || i==22 || i==23 || i==24)
-                {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        }
-        sleep_ms(1000 / fps);
+
+// Entrega ao receptor tudo o que já chegou pelo stdio, sem bloquear
+static void receber_fluxo(void) {
+    char bloco[64];
+    int lidos;
+    while ((lidos = stdio_get_until(bloco, sizeof(bloco), get_absolute_time())) > 0) {
+        fluxo_receber(&fluxo, (const uint8_t *)bloco, (uint32_t)lidos, time_us_64());
     }
 }
 
-// Animação 4: Exibe uma contagem regressiva alternando entre as cores vermelho, azul, verde e branco
-// Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_4(PIO pio, uint sm, int fps){
-    
-    uint32_t delay = 1000/fps;
-    int numero0[12] = {23,22,21,18,11,8,1,2,3,6,13,16};
-    int numero1[5] = {21,18,11,8,1};
-    int numero2[11] = {23,22,21,18,11,12,13,6,3,2,1};
-    int numero3[11] = {23,22,21,18,11,12,13,8,1,2,3};
-    int numero4[9] = {23,16,13,12,11,18,21,8,1};
-    int numero5[11] = {21,22,23,16,13,12,11,8,1,2,3};
-    int numero6[12] = {21,22,23,16,13,6,3,2,1,8,11,12};
-    int numero7[7] = {23,22,21,18,11,8,1};
-    int numero8[13] = {23,22,21,18,11,8,1,2,3,6,13,16,12};
-    int numero9[12] = {12,13,16,23,22,21,18,11,8,1,2,3};
-
-    for(int i=1;i<=12;i++){configurar_alguns_leds(numero9,i,pio,sm,1.0,0.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=13;i++){configurar_alguns_leds(numero8,i,pio,sm,0.0,1.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=7;i++){configurar_alguns_leds(numero7,i,pio,sm,0.0,0.0,1.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=12;i++){configurar_alguns_leds(numero6,i,pio,sm,1.0,0.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=11;i++){configurar_alguns_leds(numero5,i,pio,sm,0.0,1.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=9;i++){configurar_alguns_leds(numero4,i,pio,sm,0.0,0.0,1.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=11;i++){configurar_alguns_leds(numero3,i,pio,sm,1.0,0.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=11;i++){configurar_alguns_leds(numero2,i,pio,sm,0.0,1.0,0.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=5;i++){configurar_alguns_leds(numero1,i,pio,sm,0.0,0.0,1.0);sleep_ms(delay);}sleep_ms(delay);
-    for(int i=1;i<=12;i++){configurar_alguns_leds(numero0,i,pio,sm,1.0,1.0,1.0);sleep_ms(delay);}sleep_ms(delay);
+// Próximo instante em que há trabalho para a saída: um quadro da animação
+// ou o reenvio periódico do último quadro
+static uint64_t proximo_prazo(void) {
+    uint64_t prazo = escalonador_prazo(&escalonador);
+    uint64_t manter = saida_leds_prazo_manter(&saida);
+    prazo = manter < prazo ? manter : prazo;
+#if MATRIZ_PONTILHAMENTO
+    uint64_t renovar = pontilhamento_prazo(&pontilhamento);
+    prazo = renovar < prazo ? renovar : prazo;
+#endif
+#if !MATRIZ_DUAL_CORE
+    uint64_t repousar = repouso_prazo(&repouso);
+    prazo = repousar < prazo ? repousar : prazo;
+#endif
+    return prazo;
+}
 
+// Apresenta o próximo quadro da animação e a próxima renovação do
+// pontilhamento, se os prazos chegaram, e reenvia o quadro parado
+static void atualizar_saida(void) {
+    escalonador_passo(&escalonador, time_us_64());
+#if MATRIZ_PONTILHAMENTO
+    pontilhamento_passo(&pontilhamento, time_us_64());
+#endif
+    saida_leds_manter(&saida, time_us_64());
 }
 
-/* Animação 5: Exibe uma onda senoidal de cores passando pelos LEDs, criando um efeito dinâmico e suave de transição 
-   entre as cores azul, vermelho e verde. A animação utiliza uma fórmula de onda senoidal para calcular as cores em cada LED.*/
-// Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_5(PIO pio, uint sm, int fps) {
-    const int delay = 1000 / fps;  // Calcula o intervalo de tempo por frame em milissegundos
-    const double pi = 3.14159265359; // Valor de pi
-    const int frames = 100;       // Número de frames para completar a animação
-    const double step = 2 * pi / NUM_PIXELS; // Distância entre os LEDs na onda senoidal
-
-    for (int frame = 0; frame < frames; frame++) { // Loop para cada frame da animação
-        for (int i = 0; i < NUM_PIXELS; i++) { // Loop para cada LED no display
-            // Calcula a posição da onda senoidal para o LED atual
-            double wave_position = frame * step + i * step;
-
-            // Calcula os valores normalizados (de 0 a 1) para as componentes de cor (R, G, B)
-            double r = (sin(wave_position) + 1) / 2;                 // Vermelho
-            double g = (sin(wave_position + 2 * pi / 3) + 1) / 2;   // Verde
-            double b = (sin(wave_position + 4 * pi / 3) + 1) / 2;   // Azul
-
-            // Combina as componentes R, G e B para formar a cor do LED
-            uint32_t color = calcular_cor_rgb(b, r, g);
-
-            // Envia a cor calculada para o LED atual
-            pio_sm_put_blocking(pio, sm, color);
-        }
+#if !MATRIZ_DUAL_CORE
+// Apaga a matriz ou dorme até uma tecla quando a política de repouso pede
+static void repousar(void) {
+    bool ocupado = fluxo_ativo || !escalonador_concluido(&escalonador);
+    uint64_t despertar_us;
 
-        // Pausa para respeitar a taxa de quadros por segundo (FPS)
-        sleep_ms(delay);
+    switch (repouso_passo(&repouso, ocupado, time_us_64())) {
+        case REPOUSO_APAGAR:
+            escalonador_tocar(&escalonador, &animacao_apagar, FPS(1), time_us_64());
+            break;
+        case REPOUSO_DORMIR:
+            if (sono_ate_tecla(&despertar_us)) {
+                repouso_despertou(&repouso, despertar_us, time_us_64());
+            } else {
+                repouso_atividade(&repouso, time_us_64()); // Tecla apertada bem na hora
+            }
+            break;
+        default:
+            break;
     }
 }
 
-/* Animação 6: Exibe uma sequência de quadros com padrões de cores em LEDs, simulando uma animação com mudanças graduais
-   entre as cores azul, amarelo, lilás, verde e vermelho. Cada quadro possui um padrão específico de LEDs iluminados.*/
-// Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_6(PIO pio, uint sm, int fps) { 
-    for (int frame = 0; frame < 5; frame++) {
-        uint32_t color2 = calcular_cor_rgb(0.0, 0.0, 0.0); // Cor de fundo (preto)
-        
-        if (frame == 0) { // Primeiro quadro: Um LED azul na posição 12
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.0, 0.5); // Azul
-                if (i == 12) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else if (frame == 1) { // Segundo quadro: LEDs amarelos em posições específicas
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.5, 0.0); // Amarelo
-                if (i == 6 || i == 7 || i == 8 || i == 11 || i == 12 || i == 13 || i == 16 || i == 17 || i == 18) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else if (frame == 2) { // Terceiro quadro: Todos os LEDs lilás
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.0, 0.5); // Lilás
-                if (i >= 0 && i <= 24) { // Todos os LEDs
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else if (frame == 3) { // Quarto quadro: LEDs verdes em um padrão específico
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.5, 0.0); // Verde
-                if (i == 0 || i == 1 || i == 2 || i == 3 || i == 4 || i == 5 || 
-                    i == 9 || i == 10 || i == 14 || i == 15 || i == 19 || 
-                    i == 20 || i == 21 || i == 22 || i == 23 || i == 24) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } else { // Quinto quadro: LEDs vermelhos em posições específicas
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.0, 0.0); // Vermelho
-                if (i == 6 || i == 7 || i == 8 || i == 11 || i == 13 || i == 16 || i == 17 || i == 18) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        }
-        sleep_ms(1000 / fps); // Pausa para controlar a taxa de quadros por segundo
+// Registra uma tecla na política de repouso e, se foi a que acordou o
+// processador, informa a latência do despertar
+static void relatar_atividade(void) {
+    if (!repouso_atividade(&repouso, time_us_64())) {
+        return;
     }
+    const repouso_estatisticas_t *estatisticas = &repouso.estatisticas;
+    printf("despertar: tecla tratada %lu us depois do aperto (maior %lu us, media %lu us em %lu)\n",
+           (unsigned long)estatisticas->ultima_latencia_us, (unsigned long)estatisticas->maior_latencia_us,
+           (unsigned long)(estatisticas->soma_latencia_us / estatisticas->despertares),
+           (unsigned long)estatisticas->despertares);
 }
+#endif
 
-// Animação 7: Exibe uma sequência de quadros com padrões de LEDs alternando entre diferentes cores
-// Parâmetros:
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado usada para o controle
-// - fps: Taxa de quadros por segundo da animação
-void animacao_7(PIO pio, uint sm, int fps) { 
-    for (int frame = 0; frame < 5; frame++) {
-        // Define a cor padrão (preta) para os LEDs que não estão ativos no padrão atual
-        uint32_t color2 = calcular_cor_rgb(0.0, 0.0, 0.0);
-        
-        // Quadro 0: Define LEDs ativos com a cor verde
-        if (frame == 0) {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.5, 0.0);
-                if (i == 2 || i == 3 || i == 4 || i == 8 || i == 5 || i == 10 || i == 14 || 
-                    i == 18 || i == 15 || i == 22 || i == 23 || i == 24) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        } 
-        // Quadro 1: Define LEDs ativos com a cor roxa
-        else if (frame == 1) {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.0, 0.5);
-                if (i == 0 || i == 4 || i == 5 || i == 6 || i == 7 || i == 8 || i == 9 || 
-                    i == 11 || i == 13 || i == 16 || i == 18 || i == 22) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
+#if MATRIZ_DUAL_CORE
+// Imprime a utilização de cada núcleo a cada INTERVALO_RELATORIO_USO_US
+static void relatar_uso_nucleos(void) {
+    static uso_cpu_amostra_t amostras[2];
+    static uint32_t ultimo_relatorio;
+    uint32_t agora = time_us_32();
+
+    if (agora - ultimo_relatorio < INTERVALO_RELATORIO_USO_US) {
+        return;
+    }
+    ultimo_relatorio = agora;
+
+    uint32_t uso0 = uso_cpu_medir(&uso_nucleos[0], &amostras[0], agora);
+    uint32_t uso1 = uso_cpu_medir(&uso_nucleos[1], &amostras[1], agora);
+    printf("uso: nucleo0 %lu.%lu%% nucleo1 %lu.%lu%%, teclas perdidas %lu\n",
+           (unsigned long)(uso0 / 10), (unsigned long)(uso0 % 10),
+           (unsigned long)(uso1 / 10), (unsigned long)(uso1 % 10),
+           (unsigned long)teclado_eventos_perdidos());
+}
+
+// Núcleo 1: gera e envia os quadros. Recebe do núcleo 0, pela FIFO entre
+// núcleos, as teclas apertadas, e entre um comando e outro dorme até o
+// prazo do próximo quadro.
+static void nucleo1_principal(void) {
+    uso_cpu_t *uso = &uso_nucleos[1];
+
+    while (true) {
+        uso_cpu_acordou(uso, time_us_32());
+
+        // Comandos do núcleo 0: uma tecla ou um comando do console por palavra da FIFO
+        bool retirou = false;
+        while (multicore_fifo_rvalid()) {
+            uint32_t palavra = multicore_fifo_pop_blocking();
+            if (palavra & PALAVRA_COMANDO_CONSOLE) {
+                console_executar((char)palavra);
+            } else {
+                tratar_tecla((char)palavra);
             }
+            retirou = true;
         }
-        // Quadro 2: Define LEDs ativos com a cor amarela
-        else if (frame == 2) {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.5, 0.5, 0.0);
-                if (i == 2 || i == 6 || i == 8 || i == 11 || i == 13 || i == 15 || i == 19 || 
-                    i == 20 || i == 24) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
+        if (retirou) {
+            __sev(); // Acorda o núcleo 0 se ele tinha teclas esperando vaga na FIFO
         }
-        // Quadro 3: Define LEDs ativos com a cor verde, formando um padrão vertical
-        else if (frame == 3) {
-            for (int i = 0; i < NUM_PIXELS - 1; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.5, 0.0);
-                if (i == 2 || i == 7 || i == 12 || i == 17 || i == 22) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
+        if (fluxo_ativo) {
+            receber_fluxo();
         }
-        // Quadro 4: Retorna ao padrão inicial com LEDs ativos na cor azul
-        else {
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                uint32_t color1 = calcular_cor_rgb(0.0, 0.0, 0.5);
-                if (i == 2 || i == 3 || i == 4 || i == 8 || i == 5 || i == 10 || i == 14 || 
-                    i == 18 || i == 15 || i == 22 || i == 23 || i == 24) {
-                    pio_sm_put_blocking(pio, sm, color1);
-                } else {
-                    pio_sm_put_blocking(pio, sm, color2);
-                }  
-            }
-        }
-        // Aguarda o próximo quadro, com a duração controlada pela taxa de quadros por segundo (fps)
-        sleep_ms(1000 / fps);
-    }
-}
 
-// Função para executar a ação correspondente à tecla pressionada
-// Parâmetros:
-// - key: Caractere da tecla pressionada
-// - pio: Instância do bloco PIO
-// - sm: Máquina de estado utilizada
-void executar_acao_tecla(char key, PIO pio, uint sm) {
-    switch (key) {
-        case '1': // Executa a animação 1 com 10 fps
-            animacao_1(pio, sm, 10);
-            break;
-        case '2': // Executa a animação 2 com 5 fps
-            animacao_2(pio, sm, 5);
-            break;
-        case '3': // Executa a animação 3 com 2 fps
-            animacao_3(pio, sm, 2);
-            break;
-        case '4': // Executa a animação 4 com 10 fps
-            animacao_4(pio, sm, 10);
-            break;
-        case '5': // Executa a animação 5 com 10 fps 
-            animacao_5(pio, sm, 10); 
-            break;
-        case '6': // Executa a animação 6 com 2 fps
-            animacao_6(pio, sm, 2);
-            break;
-        case '7': // Executa a animação 7 com 5 fps
-            animacao_7(pio, sm, 5);
-            break;
-        case 'A': // Desliga todos os LEDs (cor preta)
-            configurar_todos_leds(pio, sm, 0.0, 0.0, 0.0);
-            break;
-        case 'B': // Configura todos os LEDs na cor azul
-            configurar_todos_leds(pio, sm, 0.0, 0.0, 1.0);
-            break;
-        case 'C': // Configura todos os LEDs na cor vermelha
-            configurar_todos_leds(pio, sm, 0.8, 0.0, 0.0);
-            break;
-        case 'D': // Configura todos os LEDs na cor verde
-            configurar_todos_leds(pio, sm, 0.0, 0.5, 0.0);
-            break;
-        case '#': // Configura todos os LEDs com baixa intensidade branca
-            configurar_todos_leds(pio, sm, 0.2, 0.2, 0.2);
-            break;
-        default: // Nenhuma ação para outras teclas
-            break;
+        // Apresenta o próximo quadro se o prazo dele chegou
+        atualizar_saida();
+
+        uso_cpu_dormindo(uso, time_us_32());
+
+        // Um push na FIFO gera um evento, então o __wfe também acorda com novos comandos
+        uint64_t prazo = proximo_prazo();
+        if (prazo == UINT64_MAX) {
+            __wfe();
+        } else {
+            best_effort_wfe_or_timeout(from_us_since_boot(prazo));
+        }
     }
 }
+#endif
 
 // Função principal: Configura o sistema e entra no loop principal
 int main() {
     PIO pio = pio0; // Define o bloco PIO a ser usado
-    uint sm; // Máquina de estado
+    uint sm[MATRIZ_VIAS]; // Máquinas de estado, uma por via
+    evento_tecla_t evento;
 
     // Inicializa o hardware
     stdio_init_all();
-    configurar_gpio_pio(pio, &sm, OUT_PIN);
+    configurar_gpio_pio(pio, sm, OUT_PIN);
+    transporte_pio_dma_iniciar(&transporte, pio, sm);
+    saida_leds_iniciar(&saida, &transporte.base);
+    saida.intervalo_manter_us = MATRIZ_INTERVALO_MANTER_MS * 1000;
+    escalonador_iniciar(&escalonador, &saida);
+    escalonador.transicao_us = MATRIZ_TRANSICAO_MS * 1000;
+#if MATRIZ_CACHE_QUADROS
+#if MATRIZ_QUADROS_FLASH
+    if (!cache_quadros_iniciar(&cache, memoria_cache, sizeof(memoria_cache), quadros_flash, quant_quadros_flash,
+                               quadros_flash_mapa)) {
+        printf("quadros em flash gerados para outro mapa de LEDs, ignorados\n");
+    }
+#else
+    cache_quadros_iniciar(&cache, memoria_cache, sizeof(memoria_cache), NULL, 0, NULL);
+#endif
+    escalonador.cache = &cache;
+#endif
+#if MATRIZ_PONTILHAMENTO
+    pontilhamento_iniciar(&pontilhamento, &saida, FPS(MATRIZ_PONTILHAMENTO_HZ));
+    escalonador.pontilhamento = &pontilhamento;
+#endif
     configurar_teclado();
+#if MATRIZ_DUAL_CORE
+    console_iniciar(&saida, &escalonador, encaminhar_comando, encaminhar_linha);
+#else
+    console_iniciar(&saida, &escalonador, NULL, aplicar_linha);
+#endif
+
+#if MATRIZ_MEDIR_CICLOS
+    sleep_ms(2000); // Tempo para o terminal USB conectar
+    medir_ciclos_animacao_5();
+#endif
+
+#if MATRIZ_DUAL_CORE
+    // O núcleo 1 passa a ser o dono do escalonador e da saída; o núcleo 0
+    // fica só com o teclado
+    multicore_launch_core1(nucleo1_principal);
+
+    while (true) {
+        uso_cpu_acordou(&uso_nucleos[0], time_us_32());
+
+        // Entrega ao núcleo 1 as teclas apertadas desde a última volta. Com a
+        // FIFO cheia os eventos ficam na fila do teclado até a próxima volta
+        // (o núcleo 1 gera um evento depois de esvaziar a FIFO, o que acorda
+        // este laço); só o que transbordar a fila do teclado se perde, e a
+        // contagem sai no relatório de uso
+        while (multicore_fifo_wready() && teclado_obter_evento(&evento)) {
+            if (evento.pressionada && !tratar_acorde(&evento)) {
+                multicore_fifo_push_blocking(evento.tecla);
+            }
+        }
+        if (!fluxo_ativo) {
+            console_processar(); // No modo de recepção o stdio pertence ao núcleo 1
+        }
+        relatar_uso_nucleos();
+
+        uso_cpu_dormindo(&uso_nucleos[0], time_us_32());
+
+        // A fila do teclado e o console geram eventos; o prazo só garante o relatório
+        best_effort_wfe_or_timeout(make_timeout_time_us(INTERVALO_RELATORIO_USO_US));
+    }
+#else
+    repouso_iniciar(&repouso, MATRIZ_REPOUSO_APAGAR_S * 1000000ull, MATRIZ_REPOUSO_DORMIR_S * 1000000ull,
+                    time_us_64());
 
     while (true) {
-        char key = verificar_teclado(); // Verifica a tecla pressionada
-        if (key) {
-            executar_acao_tecla(key, pio, sm); // Executa a ação correspondente
+        uso_cpu_acordou(&uso_nucleos[0], time_us_32());
+
+        // Só reage ao aperto: segurar a tecla não reinicia a animação
+        while (teclado_obter_evento(&evento)) {
+            if (evento.pressionada) {
+                relatar_atividade();
+                if (!tratar_acorde(&evento)) {
+                    tratar_tecla(evento.tecla); // Executa a ação correspondente
+                }
+            }
+        }
+
+        // No modo de recepção o stdio carrega quadros, não comandos
+        if (fluxo_ativo) {
+            receber_fluxo();
+        } else {
+            console_processar();
+        }
+
+        // Apresenta o próximo quadro se o prazo dele chegou
+        atualizar_saida();
+        repousar();
+
+        uso_cpu_dormindo(&uso_nucleos[0], time_us_32());
+
+        // Dorme até o próximo quadro; a fila do teclado e o console geram
+        // eventos, então o __wfe também acorda com um aperto ou um comando
+        uint64_t prazo = proximo_prazo();
+        if (prazo == UINT64_MAX) {
+            __wfe();
+        } else {
+            best_effort_wfe_or_timeout(from_us_since_boot(prazo));
         }
-        sleep_ms(100); // Atraso para evitar sobrecarga
     }
+#endif
 }
@@ -0,0 +1,200 @@
+#include "animacoes.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "glifos_gerados.h"
+
+void configurar_todos_leds(saida_leds_t *saida, intensidade_t r, intensidade_t g, intensidade_t b) {
+    saida_leds_preencher(saida, calcular_cor_rgb(b, r, g));
+    saida_leds_apresentar(saida);
+}
+
+void configurar_alguns_leds(int *leds,int quant_leds,saida_leds_t *saida, intensidade_t r, intensidade_t g, intensidade_t b) {
+    // Apaga o quadro e acende só os índices pedidos, na ordem da fita
+    uint32_t *quadro = saida_leds_quadro(saida);
+    uint32_t color = calcular_cor_rgb(b, r, g);
+    memset(quadro, 0, NUM_PIXELS * sizeof(quadro[0]));
+    for (int j = 0; j < quant_leds; j++) {
+        if (leds[j] >= 0 && leds[j] < NUM_PIXELS) { // Índices fora da fita são ignorados
+            quadro[leds[j]] = color;
+        }
+    }
+    saida_leds_apresentar(saida);
+}
+
+// Animação 1: alternância entre azul e vermelho
+static cor_paleta_t cor_animacao_1(uint16_t frame) {
+    cor_paleta_t azul = {INTENSIDADE(0.0), INTENSIDADE(0.0), INTENSIDADE(0.5)};
+    cor_paleta_t vermelho = {INTENSIDADE(0.5), INTENSIDADE(0.0), INTENSIDADE(0.0)};
+    return (frame % 2 == 0) ? azul : vermelho;
+}
+
+static void desenhar_animacao_1(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    (void)animacao;
+    cor_paleta_t cor = cor_animacao_1(frame);
+    uint32_t color = calcular_cor_rgb(cor.b, cor.r, cor.g);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = color;
+    }
+}
+
+static void desenhar16_animacao_1(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    (void)animacao;
+    cor_paleta_t cor = cor_animacao_1(frame);
+    cor16_t color = calcular_cor16(cor.b, cor.r, cor.g);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = color;
+    }
+}
+
+// Animação 2: Efeito de onda de cores (alterna entre azul, verde e vermelho em sequência)
+static inline cor_paleta_t cor_animacao_2(uint16_t frame, int i) {
+    // Onda de intensidade: 0.5 + 0.5 * sin((frame + i) * 0.3)
+    intensidade_t intensidade = onda_seno(fase32_passos((uint32_t)(frame + i), FASE32_RADIANOS(0.3)));
+    cor_paleta_t cor = {0, 0, 0};
+
+    if ((frame / 10) % 3 == 0) {
+        cor.b = intensidade; // Azul com onda
+    } else if ((frame / 10) % 3 == 1) {
+        cor.g = intensidade; // Verde com onda
+    } else {
+        cor.r = intensidade; // Vermelho com onda
+    }
+    return cor;
+}
+
+static void desenhar_animacao_2(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    (void)animacao;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        cor_paleta_t cor = cor_animacao_2(frame, i);
+        quadro[i] = calcular_cor_rgb(cor.b, cor.r, cor.g); // Desenha a cor de cada LED no quadro
+    }
+}
+
+static void desenhar16_animacao_2(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    (void)animacao;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        cor_paleta_t cor = cor_animacao_2(frame, i);
+        quadro[i] = calcular_cor16(cor.b, cor.r, cor.g);
+    }
+}
+
+// Animações 3, 6 e 7: sequências de quadros estáticos definidas em glifos.txt
+static void desenhar_glifos(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    const quadro_glifo_t *glifos = animacao->dados;
+    glifo_desenhar(quadro, glifos[frame]);
+}
+
+static void desenhar16_glifos(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    const quadro_glifo_t *glifos = animacao->dados;
+    glifo_desenhar16(quadro, glifos[frame]);
+}
+
+// Animação 4: contagem regressiva em que cada dígito é desenhado traço a traço.
+// Cada dígito ocupa tamanho + 1 quadros: um por LED revelado e mais um em que
+// o dígito completo permanece na matriz.
+static uint32_t mascara_contagem(const animacao_t *animacao, uint16_t frame, uint8_t *paleta) {
+    const revelacao_glifo_t *revelacao = animacao->dados;
+    while (frame > revelacao->tamanho) {
+        frame -= revelacao->tamanho + 1;
+        revelacao++;
+    }
+
+    int acesos = frame < revelacao->tamanho ? frame + 1 : revelacao->tamanho;
+    uint32_t mascara = 0;
+    for (int i = 0; i < acesos; i++) {
+        mascara |= 1u << revelacao->ordem[i];
+    }
+    *paleta = revelacao->paleta;
+    return mascara;
+}
+
+static void desenhar_contagem(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    uint8_t paleta;
+    uint32_t mascara = mascara_contagem(animacao, frame, &paleta);
+    glifo_expandir(quadro, mascara, glifo_cor(paleta));
+}
+
+static void desenhar16_contagem(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    uint8_t paleta;
+    uint32_t mascara = mascara_contagem(animacao, frame, &paleta);
+    glifo_expandir16(quadro, mascara, glifo_cor16(paleta));
+}
+
+/* Animação 5: Exibe uma onda senoidal de cores passando pelos LEDs, criando um efeito dinâmico e suave de transição 
+   entre as cores azul, vermelho e verde. A animação utiliza uma fórmula de onda senoidal para calcular as cores em cada LED.*/
+static inline cor_paleta_t cor_animacao_5(uint16_t frame, int i) {
+    const fase_t terco = 65536 / 3; // 2 * pi / 3 em fase_t
+
+    // Calcula a posição da onda senoidal para o LED atual: (frame + i) * 2 * pi / NUM_PIXELS.
+    // A onda repete a cada NUM_PIXELS passos, então só o resto da divisão importa.
+    fase_t wave_position = (fase_t)(((uint32_t)((frame + i) % NUM_PIXELS) << 16) / NUM_PIXELS);
+
+    // Calcula os valores normalizados (de 0 a 1) para as componentes de cor (R, G, B)
+    cor_paleta_t cor;
+    cor.r = onda_seno(wave_position);                      // Vermelho
+    cor.g = onda_seno((fase_t)(wave_position + terco));     // Verde
+    cor.b = onda_seno((fase_t)(wave_position + 2 * terco)); // Azul
+    return cor;
+}
+
+static void desenhar_animacao_5(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    (void)animacao;
+    for (int i = 0; i < NUM_PIXELS; i++) { // Loop para cada LED no display
+        // Combina as componentes R, G e B para formar a cor do LED
+        cor_paleta_t cor = cor_animacao_5(frame, i);
+        quadro[i] = calcular_cor_rgb(cor.b, cor.r, cor.g);
+    }
+}
+
+static void desenhar16_animacao_5(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    (void)animacao;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        cor_paleta_t cor = cor_animacao_5(frame, i);
+        quadro[i] = calcular_cor16(cor.b, cor.r, cor.g);
+    }
+}
+
+// Quadro único com todos os LEDs na cor de animacao->dados
+static void desenhar_cor_solida(const animacao_t *animacao, uint32_t *quadro, uint16_t frame) {
+    (void)frame;
+    const cor_paleta_t *cor = animacao->dados;
+    uint32_t color = calcular_cor_rgb(cor->b, cor->r, cor->g);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = color;
+    }
+}
+
+static void desenhar16_cor_solida(const animacao_t *animacao, cor16_t *quadro, uint16_t frame) {
+    (void)frame;
+    const cor_paleta_t *cor = animacao->dados;
+    cor16_t color = calcular_cor16(cor->b, cor->r, cor->g);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = color;
+    }
+}
+
+const animacao_t animacao_1 = {desenhar_animacao_1, desenhar16_animacao_1, NULL, 5, "animacao_1"};
+const animacao_t animacao_2 = {desenhar_animacao_2, desenhar16_animacao_2, NULL, 50, "animacao_2"};
+const animacao_t animacao_3 = {desenhar_glifos, desenhar16_glifos, glifos_animacao_3, ANIMACAO_3_TAMANHO, "animacao_3"};
+const animacao_t animacao_4 = {desenhar_contagem, desenhar16_contagem, glifos_contagem_regressiva,
+                               CONTAGEM_REGRESSIVA_LEDS + CONTAGEM_REGRESSIVA_TAMANHO, "animacao_4"};
+const animacao_t animacao_5 = {desenhar_animacao_5, desenhar16_animacao_5, NULL, 100, "animacao_5"};
+const animacao_t animacao_6 = {desenhar_glifos, desenhar16_glifos, glifos_animacao_6, ANIMACAO_6_TAMANHO, "animacao_6"};
+const animacao_t animacao_7 = {desenhar_glifos, desenhar16_glifos, glifos_animacao_7, ANIMACAO_7_TAMANHO, "animacao_7"};
+
+// Cores das teclas A, B, C, D e # (r, g, b)
+static const cor_paleta_t apagado = {INTENSIDADE(0.0), INTENSIDADE(0.0), INTENSIDADE(0.0)};
+static const cor_paleta_t azul_100 = {INTENSIDADE(0.0), INTENSIDADE(0.0), INTENSIDADE(1.0)};
+static const cor_paleta_t vermelho_80 = {INTENSIDADE(0.8), INTENSIDADE(0.0), INTENSIDADE(0.0)};
+static const cor_paleta_t verde_50 = {INTENSIDADE(0.0), INTENSIDADE(0.5), INTENSIDADE(0.0)};
+static const cor_paleta_t branco_20 = {INTENSIDADE(0.2), INTENSIDADE(0.2), INTENSIDADE(0.2)};
+
+const animacao_t animacao_apagar = {desenhar_cor_solida, desenhar16_cor_solida, &apagado, 1, "animacao_apagar"};
+const animacao_t animacao_azul_100 = {desenhar_cor_solida, desenhar16_cor_solida, &azul_100, 1, "animacao_azul_100"};
+const animacao_t animacao_vermelho_80 = {desenhar_cor_solida, desenhar16_cor_solida, &vermelho_80, 1,
+                                         "animacao_vermelho_80"};
+const animacao_t animacao_verde_50 = {desenhar_cor_solida, desenhar16_cor_solida, &verde_50, 1, "animacao_verde_50"};
+const animacao_t animacao_branco_20 = {desenhar_cor_solida, desenhar16_cor_solida, &branco_20, 1,
+                                       "animacao_branco_20"};
@@ -0,0 +1,58 @@
+#ifndef ANIMACOES_H
+#define ANIMACOES_H
+
+#include <stdint.h>
+#include "cor.h"
+#include "saida_leds.h"
+
+// Animação descrita quadro a quadro: desenhar() produz o quadro "indice"
+// sem depender dos quadros anteriores, o que permite ao escalonador
+// avançar, pausar ou interromper a animação a qualquer momento.
+typedef struct animacao {
+    // Desenha o quadro "indice" (0 a quant_quadros - 1) em NUM_PIXELS posições
+    void (*desenhar)(const struct animacao *animacao, uint32_t *quadro, uint16_t indice);
+    // Mesmo quadro com 8.8 bits por canal, para o pontilhamento temporal
+    // (NULL se a animação só desenha em 8 bits)
+    void (*desenhar16)(const struct animacao *animacao, cor16_t *quadro, uint16_t indice);
+    const void *dados; // Dados próprios da animação (glifos, cor, ...)
+    uint16_t quant_quadros;
+    const char *nome; // Nome usado nos relatórios de instrumentação
+} animacao_t;
+
+// Animações das teclas 1 a 7
+extern const animacao_t animacao_1;
+extern const animacao_t animacao_2;
+extern const animacao_t animacao_3;
+extern const animacao_t animacao_4;
+extern const animacao_t animacao_5;
+extern const animacao_t animacao_6;
+extern const animacao_t animacao_7;
+
+// Quadros estáticos de cor única das teclas A, B, C, D e #
+extern const animacao_t animacao_apagar;
+extern const animacao_t animacao_azul_100;
+extern const animacao_t animacao_vermelho_80;
+extern const animacao_t animacao_verde_50;
+extern const animacao_t animacao_branco_20;
+
+// Função para configurar todos os LEDs da matriz com uma única cor
+// Parâmetros:
+// - saida: Saída da matriz onde o quadro é desenhado e apresentado
+// - r: Intensidade do vermelho
+// - g: Intensidade do verde
+// - b: Intensidade do azul
+void configurar_todos_leds(saida_leds_t *saida, intensidade_t r, intensidade_t g, intensidade_t b);
+
+// Configura alguns LEDs para uma cor específica e apaga os demais
+// Parâmetros:
+// - int *leds : ponteiro para vetor contendo os LEDs que serão acesos, como
+//   índices na fita (0 a NUM_PIXELS - 1, na ordem em que os pixels são
+//   enviados, sem passar pela geometria); índices fora disso são ignorados
+// - int quant_leds : quantidade de LEDs que acenderão
+// - saida: Saída da matriz onde o quadro é desenhado e apresentado
+// - r: Intensidade da cor vermelha
+// - g: Intensidade da cor verde
+// - b: Intensidade da cor azul
+void configurar_alguns_leds(int *leds,int quant_leds,saida_leds_t *saida, intensidade_t r, intensidade_t g, intensidade_t b);
+
+#endif
@@ -0,0 +1,174 @@
+#include "cache_quadros.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "geometria.h"
+
+bool cache_quadros_iniciar(cache_quadros_t *cache, uint8_t *memoria, uint32_t tamanho_memoria,
+                           const sequencia_flash_t *flash, int quant_flash, const uint16_t *mapa_flash) {
+    cache->memoria = memoria;
+    cache->tamanho_memoria = tamanho_memoria;
+    memset(cache->entradas, 0, sizeof(cache->entradas));
+    memset(&cache->estatisticas, 0, sizeof(cache->estatisticas));
+    cache->relogio_uso = 0;
+    cache->flash = NULL;
+    cache->quant_flash = 0;
+    if (flash == NULL) {
+        return true;
+    }
+    // Quadros gerados para outra geometria teriam os pixels fora do lugar
+    if (memcmp(mapa_flash, mapa_leds, sizeof(mapa_leds)) != 0) {
+        return false;
+    }
+    cache->flash = flash;
+    cache->quant_flash = quant_flash;
+    return true;
+}
+
+void cache_quadros_empacotar(uint8_t *destino, const uint32_t *quadro) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        for (int b = 0; b < PIXEL_BYTES; b++) {
+            *destino++ = (uint8_t)(quadro[i] >> (24 - 8 * b));
+        }
+    }
+}
+
+static void desempacotar(uint32_t *quadro, const uint8_t *origem) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        uint32_t pixel = 0;
+        for (int b = 0; b < PIXEL_BYTES; b++) {
+            pixel |= (uint32_t)*origem++ << (24 - 8 * b);
+        }
+        quadro[i] = pixel;
+    }
+}
+
+static uint32_t bytes_presenca(const animacao_t *animacao) {
+    return (animacao->quant_quadros + 7u) / 8u;
+}
+
+static uint32_t tamanho_entrada(const animacao_t *animacao) {
+    return bytes_presenca(animacao) + (uint32_t)animacao->quant_quadros * CACHE_BYTES_QUADRO;
+}
+
+uint32_t cache_quadros_bytes_em_uso(const cache_quadros_t *cache) {
+    uint32_t total = 0;
+    for (int e = 0; e < CACHE_ENTRADAS; e++) {
+        total += cache->entradas[e].animacao ? cache->entradas[e].tamanho : 0;
+    }
+    return total;
+}
+
+// Junta as entradas no começo da memória, na ordem em que já estão, e
+// retorna onde começa o espaço livre
+static uint32_t compactar(cache_quadros_t *cache) {
+    uint32_t fim = 0;
+    while (true) {
+        // Próxima entrada depois de "fim" na memória
+        entrada_cache_t *proxima = NULL;
+        for (int e = 0; e < CACHE_ENTRADAS; e++) {
+            entrada_cache_t *entrada = &cache->entradas[e];
+            if (entrada->animacao && entrada->inicio >= fim && (!proxima || entrada->inicio < proxima->inicio)) {
+                proxima = entrada;
+            }
+        }
+        if (proxima == NULL) {
+            return fim;
+        }
+        if (proxima->inicio != fim) {
+            memmove(cache->memoria + fim, cache->memoria + proxima->inicio, proxima->tamanho);
+            proxima->inicio = fim;
+        }
+        fim += proxima->tamanho;
+    }
+}
+
+// Abre espaço para a animação, retirando as usadas há mais tempo
+static entrada_cache_t *alocar(cache_quadros_t *cache, const animacao_t *animacao) {
+    uint32_t tamanho = tamanho_entrada(animacao);
+    if (tamanho > cache->tamanho_memoria) {
+        return NULL;
+    }
+
+    while (true) {
+        entrada_cache_t *livre = NULL, *antiga = NULL;
+        for (int e = 0; e < CACHE_ENTRADAS; e++) {
+            entrada_cache_t *entrada = &cache->entradas[e];
+            if (entrada->animacao == NULL) {
+                livre = livre ? livre : entrada;
+            } else if (!antiga || entrada->uso < antiga->uso) {
+                antiga = entrada;
+            }
+        }
+
+        uint32_t inicio = compactar(cache);
+        if (livre && cache->tamanho_memoria - inicio >= tamanho) {
+            livre->animacao = animacao;
+            livre->inicio = inicio;
+            livre->tamanho = tamanho;
+            memset(cache->memoria + inicio, 0, bytes_presenca(animacao));
+            return livre;
+        }
+
+        antiga->animacao = NULL;
+        cache->estatisticas.despejos++;
+    }
+}
+
+static const sequencia_flash_t *procurar_flash(const cache_quadros_t *cache, const animacao_t *animacao) {
+    for (int s = 0; s < cache->quant_flash; s++) {
+        if (cache->flash[s].animacao == animacao) {
+            return &cache->flash[s];
+        }
+    }
+    return NULL;
+}
+
+static entrada_cache_t *procurar(cache_quadros_t *cache, const animacao_t *animacao) {
+    for (int e = 0; e < CACHE_ENTRADAS; e++) {
+        if (cache->entradas[e].animacao == animacao) {
+            return &cache->entradas[e];
+        }
+    }
+    return NULL;
+}
+
+void cache_quadros_desenhar(cache_quadros_t *cache, const animacao_t *animacao, uint32_t *quadro, uint16_t indice) {
+    const sequencia_flash_t *sequencia = procurar_flash(cache, animacao);
+    if (sequencia) {
+        desempacotar(quadro, sequencia->quadros + (uint32_t)indice * CACHE_BYTES_QUADRO);
+        cache->estatisticas.acertos_flash++;
+        return;
+    }
+
+    entrada_cache_t *entrada = procurar(cache, animacao);
+    if (entrada == NULL) {
+        entrada = alocar(cache, animacao);
+    }
+    if (entrada == NULL) {
+        animacao->desenhar(animacao, quadro, indice);
+        cache->estatisticas.sem_espaco++;
+        return;
+    }
+    entrada->uso = ++cache->relogio_uso;
+
+    uint8_t *presenca = cache->memoria + entrada->inicio;
+    uint8_t *empacotado = presenca + bytes_presenca(animacao) + (uint32_t)indice * CACHE_BYTES_QUADRO;
+    uint8_t bit = (uint8_t)(1u << (indice & 7));
+    if (presenca[indice >> 3] & bit) {
+        desempacotar(quadro, empacotado);
+        cache->estatisticas.acertos++;
+    } else {
+        animacao->desenhar(animacao, quadro, indice);
+        cache_quadros_empacotar(empacotado, quadro);
+        presenca[indice >> 3] |= bit;
+        cache->estatisticas.falhas++;
+    }
+}
+
+void cache_quadros_esquecer(cache_quadros_t *cache, const animacao_t *animacao) {
+    entrada_cache_t *entrada = procurar(cache, animacao);
+    if (entrada) {
+        entrada->animacao = NULL;
+    }
+}
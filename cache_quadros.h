@@ -0,0 +1,92 @@
+#ifndef CACHE_QUADROS_H
+#define CACHE_QUADROS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "animacoes.h"
+
+// Memória reservada na placa para os quadros guardados em RAM (as teclas
+// 1 a 7 da matriz 5x5 ocupam 21264 bytes)
+#ifndef MATRIZ_CACHE_BYTES
+#define MATRIZ_CACHE_BYTES 24576
+#endif
+
+// Animações guardadas ao mesmo tempo em RAM
+#define CACHE_ENTRADAS 8
+
+// Bytes de um quadro empacotado (G, R, B por pixel, na ordem do framebuffer)
+#define CACHE_BYTES_QUADRO (NUM_PIXELS * PIXEL_BYTES)
+
+// Sequência pré-renderizada em flash por host/gerar_quadros_flash
+typedef struct {
+    const animacao_t *animacao;
+    const uint8_t *quadros; // quant_quadros * CACHE_BYTES_QUADRO bytes
+} sequencia_flash_t;
+
+// Sequências geradas por host/gerar_quadros_flash, compiladas na placa com
+// -DMATRIZ_QUADROS_FLASH=<arquivo gerado>
+extern const sequencia_flash_t quadros_flash[];
+extern const int quant_quadros_flash;
+extern const uint16_t quadros_flash_mapa[NUM_PIXELS];
+
+// Quadros de uma animação em RAM: um mapa de bits dos quadros já
+// desenhados seguido dos quadros empacotados, a partir de "inicio"
+typedef struct {
+    const animacao_t *animacao; // NULL se a entrada está livre
+    uint32_t inicio;
+    uint32_t tamanho;
+    uint32_t uso; // Valor de relogio_uso no último acesso (LRU)
+} entrada_cache_t;
+
+typedef struct {
+    uint32_t acertos;       // Quadros copiados da RAM
+    uint32_t acertos_flash; // Quadros copiados da flash
+    uint32_t falhas;        // Quadros desenhados e guardados
+    uint32_t despejos;      // Animações retiradas pelo LRU para abrir espaço
+    uint32_t sem_espaco;    // Quadros de animações maiores que o cache (desenhados sem guardar)
+} cache_quadros_estatisticas_t;
+
+// Cache de quadros prontos: cada animação é desenhada uma vez, no primeiro
+// pedido de cada quadro, e guardada empacotada; daí em diante o quadro é só
+// copiado para a saída. As animações desenham um quadro só a partir do
+// índice, então o mesmo quadro vale para qualquer fps. Quando falta espaço
+// sai a animação usada há mais tempo.
+typedef struct {
+    uint8_t *memoria;
+    uint32_t tamanho_memoria;
+    entrada_cache_t entradas[CACHE_ENTRADAS];
+    uint32_t relogio_uso;
+    const sequencia_flash_t *flash;
+    int quant_flash;
+    cache_quadros_estatisticas_t estatisticas;
+} cache_quadros_t;
+
+// Inicializa o cache vazio
+// Parâmetros:
+// - cache: Cache a ser inicializado
+// - memoria: Memória para os quadros em RAM
+// - tamanho_memoria: Tamanho da memória em bytes
+// - flash: Sequências pré-renderizadas (NULL se nenhuma)
+// - quant_flash: Número de sequências
+// - mapa_flash: Mapa de LEDs com que as sequências foram geradas; se não
+//   for igual a mapa_leds as sequências são ignoradas
+// Retorna:
+// - false se as sequências em flash foram ignoradas
+bool cache_quadros_iniciar(cache_quadros_t *cache, uint8_t *memoria, uint32_t tamanho_memoria,
+                           const sequencia_flash_t *flash, int quant_flash, const uint16_t *mapa_flash);
+
+// Coloca em "quadro" o quadro "indice" da animação, copiado do cache ou
+// desenhado e guardado
+void cache_quadros_desenhar(cache_quadros_t *cache, const animacao_t *animacao, uint32_t *quadro, uint16_t indice);
+
+// Retira os quadros guardados em RAM de uma animação que mudou (como o
+// texto rolante com um texto novo); os próximos pedidos desenham de novo
+void cache_quadros_esquecer(cache_quadros_t *cache, const animacao_t *animacao);
+
+// Bytes da memória ocupados pelas animações guardadas
+uint32_t cache_quadros_bytes_em_uso(const cache_quadros_t *cache);
+
+// Empacota um quadro no formato das sequências (PIXEL_BYTES bytes por pixel)
+void cache_quadros_empacotar(uint8_t *destino, const uint32_t *quadro);
+
+#endif
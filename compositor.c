@@ -0,0 +1,40 @@
+#include "compositor.h"
+
+#include <string.h>
+
+// Um laço por modo, com o modo resolvido fora do laço dos pixels
+static void misturar_camada(const camada_t *camada, uint32_t *destino) {
+    const uint32_t *frente = camada->quadro.pixels;
+    uint32_t alfa = mistura_alfa(camada->opacidade);
+
+    switch (camada->modo) {
+        case MISTURA_SOBREPOR:
+            if (alfa == 256) {
+                memcpy(destino, frente, sizeof(framebuffer_t));
+                break;
+            }
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                destino[i] = misturar_sobrepor(destino[i], frente[i], alfa);
+            }
+            break;
+        case MISTURA_SOMAR:
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                destino[i] = misturar_somar(destino[i], frente[i], alfa);
+            }
+            break;
+        case MISTURA_MULTIPLICAR:
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                destino[i] = misturar_multiplicar(destino[i], frente[i], alfa);
+            }
+            break;
+    }
+}
+
+void compositor_compor(const camada_t *camadas, int quant_camadas, uint32_t *destino) {
+    memset(destino, 0, sizeof(framebuffer_t));
+    for (int c = 0; c < quant_camadas; c++) {
+        if (camadas[c].visivel && camadas[c].opacidade) {
+            misturar_camada(&camadas[c], destino);
+        }
+    }
+}
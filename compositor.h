@@ -0,0 +1,99 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "saida_leds.h"
+
+// Camadas compostas de baixo para cima sobre a matriz apagada
+#define COMPOSITOR_CAMADAS 4
+
+// Como uma camada se combina com o que está abaixo dela
+typedef enum {
+    MISTURA_SOBREPOR,    // Frente com a opacidade da camada sobre o fundo
+    MISTURA_SOMAR,       // Soma com saturação em 255
+    MISTURA_MULTIPLICAR, // Produto dos canais (branco mantém o fundo, preto apaga)
+} modo_mistura_t;
+
+typedef struct {
+    framebuffer_t quadro; // Último quadro desenhado na camada
+    uint8_t opacidade;    // 0 (invisível) a 255 (opaca)
+    modo_mistura_t modo;
+    bool visivel;
+} camada_t;
+
+// As misturas trabalham direto nas palavras de calcular_cor_rgb, dois
+// canais por multiplicação: a máscara 0x00FF00FF separa o primeiro e o
+// terceiro canais (palavra deslocada 8 bits) e o segundo e o quarto (palavra
+// sem deslocar; sem branco o byte baixo é sempre zero) em faixas de 16
+// bits, com espaço para o produto de 8 x 9 bits de cada canal sem invadir o
+// vizinho. Como nenhum canal é extraído, a ordem das cores não importa.
+#define MISTURA_CANAIS 0x00FF00FFu
+
+// Converte uma opacidade de 0 a 255 no peso alfa das misturas (0 a 256)
+static inline uint32_t mistura_alfa(uint8_t opacidade) {
+    return opacidade + (opacidade >> 7);
+}
+
+// Função para misturar a frente sobre o fundo
+// Parâmetros:
+// - fundo: Cor de baixo no formato de calcular_cor_rgb
+// - frente: Cor de cima no mesmo formato
+// - alfa: Peso da frente, de 0 (só o fundo) a 256 (só a frente)
+static inline uint32_t misturar_sobrepor(uint32_t fundo, uint32_t frente, uint32_t alfa) {
+    uint32_t beta = 256 - alfa;
+    uint32_t impares = ((frente >> 8) & MISTURA_CANAIS) * alfa + ((fundo >> 8) & MISTURA_CANAIS) * beta;
+    uint32_t pares = (frente & MISTURA_CANAIS) * alfa + (fundo & MISTURA_CANAIS) * beta;
+    return (impares & ~MISTURA_CANAIS) | ((pares >> 8) & MISTURA_CANAIS);
+}
+
+// Soma duas palavras de canais separados por MISTURA_CANAIS, saturando cada
+// canal em 255 pelo bit de transporte que sobra acima dele
+static inline uint32_t somar_canais_saturado(uint32_t a, uint32_t b) {
+    uint32_t soma = a + b;
+    uint32_t transporte = soma & 0x01000100u;
+    return (soma | (transporte - (transporte >> 8))) & MISTURA_CANAIS;
+}
+
+// Função para somar a frente, escalada por alfa, ao fundo
+// Parâmetros:
+// - fundo: Cor de baixo no formato de calcular_cor_rgb
+// - frente: Cor de cima no mesmo formato
+// - alfa: Peso da frente, de 0 a 256
+static inline uint32_t misturar_somar(uint32_t fundo, uint32_t frente, uint32_t alfa) {
+    uint32_t impares = ((((frente >> 8) & MISTURA_CANAIS) * alfa) >> 8) & MISTURA_CANAIS;
+    uint32_t pares = (((frente & MISTURA_CANAIS) * alfa) >> 8) & MISTURA_CANAIS;
+    impares = somar_canais_saturado(impares, (fundo >> 8) & MISTURA_CANAIS);
+    pares = somar_canais_saturado(pares, fundo & MISTURA_CANAIS);
+    return (impares << 8) | pares;
+}
+
+// Função para multiplicar o fundo pela frente, canal a canal. Cada canal
+// tem o seu fator, então há uma multiplicação por canal, mas o fundo
+// continua empacotado e nenhum canal é extraído para um inteiro próprio.
+// Parâmetros:
+// - fundo: Cor de baixo no formato de calcular_cor_rgb
+// - frente: Cor de cima no mesmo formato
+// - alfa: Peso do produto, de 0 (só o fundo) a 256 (só o produto)
+static inline uint32_t misturar_multiplicar(uint32_t fundo, uint32_t frente, uint32_t alfa) {
+    uint32_t impares = (fundo >> 8) & MISTURA_CANAIS;
+    uint32_t pares = fundo & MISTURA_CANAIS;
+    uint32_t fator_1 = mistura_alfa((uint8_t)(frente >> 24));
+    uint32_t fator_2 = mistura_alfa((uint8_t)(frente >> 16));
+    uint32_t fator_3 = mistura_alfa((uint8_t)(frente >> 8));
+    uint32_t produto = ((impares * fator_1) & 0xFF000000u) | ((impares * fator_3) & 0x0000FF00u) |
+                       (((pares * fator_2) >> 8) & 0x00FF0000u);
+#if PIXEL_CANAIS == 4
+    produto |= ((pares * mistura_alfa((uint8_t)frente)) >> 8) & 0x000000FFu;
+#endif
+    return alfa >= 256 ? produto : misturar_sobrepor(fundo, produto, alfa);
+}
+
+// Função para compor as camadas visíveis, da primeira à última
+// Parâmetros:
+// - camadas: Vetor de camadas
+// - quant_camadas: Número de camadas no vetor
+// - destino: Quadro de NUM_PIXELS posições que recebe o resultado
+void compositor_compor(const camada_t *camadas, int quant_camadas, uint32_t *destino);
+
+#endif
@@ -0,0 +1,154 @@
+#include "console.h"
+
+#include <stdio.h>
+#include "cache_quadros.h"
+#include "hardware/sync.h"
+#include "instrumentacao.h"
+#include "pico/stdlib.h"
+#include "texto.h"
+
+static saida_leds_t *saida_console;
+static const escalonador_t *escalonador_console;
+static console_comando_t comando_console;
+static console_linha_t linha_console;
+
+// Comando de linha em andamento (0 se nenhum) e o argumento já recebido;
+// o que passar de MATRIZ_TEXTO_MAX caracteres é descartado
+static char comando_linha;
+static char argumento_linha[MATRIZ_TEXTO_MAX + 1];
+static uint32_t tamanho_linha;
+
+static void caracteres_disponiveis(void *parametro) {
+    (void)parametro;
+    __sev(); // Acorda o laço principal se ele estiver em __wfe()
+}
+
+void console_iniciar(saida_leds_t *saida, const escalonador_t *escalonador, console_comando_t comando,
+                     console_linha_t linha) {
+    saida_console = saida;
+    escalonador_console = escalonador;
+    comando_console = comando;
+    linha_console = linha;
+    stdio_set_chars_available_callback(caracteres_disponiveis, NULL);
+}
+
+void console_executar(char comando) {
+    switch (comando) {
+#if MATRIZ_INSTRUMENTACAO
+        case 'c':
+            instrumentacao_exportar_csv();
+            break;
+        case 'b':
+            instrumentacao_exportar_binario();
+            break;
+        case 'r':
+            instrumentacao_imprimir_resumo();
+            break;
+        case 'z':
+            instrumentacao_zerar();
+            break;
+#else
+        case 'c':
+        case 'b':
+        case 'r':
+        case 'z':
+            printf("instrumentacao desligada (compile com MATRIZ_INSTRUMENTACAO)\n");
+            break;
+#endif
+        case 'd': {
+            const saida_leds_estatisticas_t *estatisticas = &saida_console->estatisticas;
+            printf("apresentados %lu, enviados %lu, suprimidos %lu, reenvios %lu, prazos perdidos %lu",
+                   (unsigned long)estatisticas->apresentados, (unsigned long)estatisticas->enviados,
+                   (unsigned long)estatisticas->suprimidos, (unsigned long)estatisticas->reenvios,
+                   (unsigned long)escalonador_console->prazos_perdidos);
+            if (saida_console->contar_alterados) {
+                printf(", pixels alterados: ultimo %lu total %llu", (unsigned long)estatisticas->ultimo_alterados,
+                       (unsigned long long)estatisticas->total_alterados);
+            }
+            printf("\n");
+            const pontilhamento_t *pontilhamento = escalonador_console->pontilhamento;
+            if (pontilhamento) {
+                uint32_t taxa = pontilhamento_taxa_medida(pontilhamento);
+                printf("pontilhamento: renovacoes %lu a %lu.%03lu Hz (pedido %lu.%03lu), prazos perdidos %lu\n",
+                       (unsigned long)pontilhamento->estatisticas.renovacoes, (unsigned long)(taxa / 1000),
+                       (unsigned long)(taxa % 1000), (unsigned long)(pontilhamento->mili_fps / 1000),
+                       (unsigned long)(pontilhamento->mili_fps % 1000),
+                       (unsigned long)pontilhamento->relogio.perdidos);
+            }
+            const cache_quadros_t *cache = escalonador_console->cache;
+            if (cache) {
+                const cache_quadros_estatisticas_t *c = &cache->estatisticas;
+                printf("cache: acertos %lu, acertos flash %lu, falhas %lu, despejos %lu, sem espaco %lu, "
+                       "%lu de %lu bytes\n",
+                       (unsigned long)c->acertos, (unsigned long)c->acertos_flash, (unsigned long)c->falhas,
+                       (unsigned long)c->despejos, (unsigned long)c->sem_espaco,
+                       (unsigned long)cache_quadros_bytes_em_uso(cache), (unsigned long)cache->tamanho_memoria);
+            }
+            break;
+        }
+        case 'p':
+            saida_console->contar_alterados = !saida_console->contar_alterados;
+            printf("contagem de pixels alterados %s\n", saida_console->contar_alterados ? "ligada" : "desligada");
+            break;
+        default:
+            break;
+    }
+}
+
+// Os comandos de linha e a ajuda ficam no núcleo que processa o console; os
+// que mexem na saída ou na instrumentação vão para console_executar(), direto
+// ou pelo encaminhamento de console_iniciar()
+static void executar_comando(int comando) {
+    switch (comando) {
+        case 'c':
+        case 'b':
+        case 'r':
+        case 'z':
+        case 'd':
+        case 'p':
+            if (comando_console) {
+                comando_console((char)comando);
+            } else {
+                console_executar((char)comando);
+            }
+            break;
+        case 't':
+        case 'v':
+        case 'k':
+            comando_linha = (char)comando;
+            tamanho_linha = 0;
+            break;
+        case '?':
+            printf("c: quadros em CSV, b: quadros em binario, r: resumo, z: zerar resumo, "
+                   "d: contadores da saida, p: contar pixels alterados, "
+                   "t <texto>, v <colunas/s>, k <RRGGBB>: texto rolante da tecla 9\n");
+            break;
+        default: // Ignora quebras de linha e caracteres desconhecidos
+            break;
+    }
+}
+
+// Acumula um caractere do argumento do comando de linha em andamento e,
+// no fim da linha, entrega o comando
+static void receber_linha(int caractere) {
+    if (caractere == '\n' || caractere == '\r') {
+        argumento_linha[tamanho_linha] = '\0';
+        linha_console(comando_linha, argumento_linha);
+        comando_linha = 0;
+    } else if (caractere == ' ' && tamanho_linha == 0) {
+        // Espaço entre a letra e o argumento
+    } else if (tamanho_linha < MATRIZ_TEXTO_MAX) {
+        argumento_linha[tamanho_linha++] = (char)caractere;
+    }
+}
+
+void console_processar(void) {
+    int caractere;
+    while ((caractere = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (comando_linha) {
+            receber_linha(caractere);
+        } else {
+            executar_comando(caractere);
+        }
+    }
+}
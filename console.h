@@ -0,0 +1,56 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+// Console de comandos de uma letra pelo stdio (USB ou UART):
+//   c - esvazia os registros de quadros em CSV
+//   b - esvazia os registros de quadros em binário
+//   r - imprime o resumo por animação
+//   z - zera os resumos
+//   d - contadores da saída (enviados, suprimidos, reenvios, pixels alterados)
+//       e prazos de quadro perdidos pelo escalonador; com o pontilhamento,
+//       também a taxa de renovação obtida, e com o cache de quadros os
+//       acertos, falhas e despejos
+//   p - liga/desliga a contagem de pixels alterados por quadro
+//   ? - lista os comandos
+// e de linha, com o argumento no resto da linha (até '\n' ou '\r'):
+//   t <texto> - troca o texto rolante da tecla 9
+//   v <colunas/s> - velocidade do texto rolante (aceita fração com ponto)
+//   k <RRGGBB> - cor do texto rolante, em hexadecimal
+// (os três valem a partir do próximo aperto da tecla 9)
+
+#include "escalonador.h"
+#include "saida_leds.h"
+
+// Recebe um comando de uma letra que consulta ou altera o estado do núcleo
+// que desenha (d, p e os da instrumentação), para executá-lo nesse núcleo
+// com console_executar()
+// Parâmetros:
+// - comando: Letra do comando
+typedef void (*console_comando_t)(char comando);
+
+// Recebe um comando de linha completo
+// Parâmetros:
+// - comando: Letra do comando (t, v ou k)
+// - argumento: Resto da linha, sem os espaços depois da letra
+typedef void (*console_linha_t)(char comando, const char *argumento);
+
+// Registra a chegada de caracteres como evento para acordar o laço principal
+// Parâmetros:
+// - saida: Saída cujos contadores os comandos d e p consultam
+// - escalonador: Escalonador cujos prazos perdidos o comando d mostra
+// - comando: Chamada com os comandos d, p, c, b, r e z, no núcleo que
+//   processa o console; NULL os executa na hora
+// - linha: Chamada com cada comando de linha, no núcleo que processa o console
+void console_iniciar(saida_leds_t *saida, const escalonador_t *escalonador, console_comando_t comando,
+                     console_linha_t linha);
+
+// Executa os comandos recebidos desde a última chamada, sem bloquear
+void console_processar(void);
+
+// Executa um comando de uma letra encaminhado por console_comando_t, no
+// núcleo dono da saída e do escalonador
+// Parâmetros:
+// - comando: Letra do comando
+void console_executar(char comando);
+
+#endif
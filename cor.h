@@ -0,0 +1,140 @@
+#ifndef COR_H
+#define COR_H
+
+#include <stdint.h>
+#include "formato_pixel.h"
+
+// Intensidade de um canal em ponto fixo sem sinal de 16 bits: 0 representa
+// 0.0 e 65535 representa 1.0. Os 8 bits altos são o valor enviado ao LED.
+typedef uint16_t intensidade_t;
+
+// Converte uma constante entre 0.0 e 1.0 em intensidade_t. Com argumentos
+// constantes a conta é resolvida pelo compilador, sem ponto flutuante no RP2040.
+#define INTENSIDADE(x) ((intensidade_t)((x) * 65535.0))
+
+// Fase de onda em ponto fixo: 65536 unidades correspondem a uma volta (2*pi)
+typedef uint16_t fase_t;
+
+// Converte uma constante em radianos para fase_t (resolvida em compilação)
+#define FASE_RADIANOS(x) ((fase_t)((uint32_t)((x) * 65536.0 / 6.283185307179586 + 0.5)))
+
+// Fase de onda com 16 bits de fração além dos de fase_t: 2^32 unidades por
+// volta, então o estouro de 32 bits é a própria volta. Um passo constante
+// multiplicado pelo índice do LED acumula o erro de arredondamento, que com
+// fase_t passa de 1 LSB na cor nos painéis grandes; em fase32_t ele fica
+// abaixo de uma unidade de fase_t mesmo em 65536 passos.
+typedef uint32_t fase32_t;
+
+// Converte uma constante em radianos (menor que uma volta) para fase32_t
+#define FASE32_RADIANOS(x) ((fase32_t)((x) * 4294967296.0 / 6.283185307179586 + 0.5))
+
+// Fase "n" passos à frente da fase zero, em fase_t
+static inline fase_t fase32_passos(uint32_t n, fase32_t passo) {
+    return (fase_t)((n * passo) >> 16);
+}
+
+// Aplica a correção gama (tabela_gama) aos canais em calcular_cor_rgb.
+// Desligada por padrão para manter o brilho original das animações.
+#ifndef MATRIZ_CORRECAO_GAMA
+#define MATRIZ_CORRECAO_GAMA 0
+#endif
+
+// Tabelas geradas em compilação por ferramentas/gerar_tabelas_cor.py
+extern const intensidade_t tabela_seno[257]; // (sin + 1) / 2 em 256 passos
+extern const uint8_t tabela_gama[256];
+
+// Função para calcular a cor RGB para os LEDs
+// Parâmetros:
+// - b: Intensidade do canal azul
+// - r: Intensidade do canal vermelho
+// - g: Intensidade do canal verde
+// Retorna:
+// - Valor de 32 bits no formato da fita (formato_pixel.h; GRB nos bits 31..8 por padrão)
+static inline uint32_t calcular_cor_rgb(intensidade_t b, intensidade_t r, intensidade_t g) {
+    uint32_t R = r >> 8;
+    uint32_t G = g >> 8;
+    uint32_t B = b >> 8;
+#if MATRIZ_CORRECAO_GAMA
+    R = tabela_gama[R];
+    G = tabela_gama[G];
+    B = tabela_gama[B];
+#endif
+    return empacotar_pixel(R, G, B);
+}
+
+// Cor com 8 bits inteiros e 8 fracionários por canal (8.8), usada pelo
+// pontilhamento temporal (pontilhamento.h). Os canais ficam em metades de
+// 16 bits para que o acúmulo do erro some dois canais numa só operação:
+// canais_1_3 tem o primeiro canal enviado (bits 31..24 do pixel) na metade
+// alta e o terceiro (bits 15..8) na baixa, canais_2_4 tem o segundo (bits
+// 23..16) na alta e o branco, se houver, na baixa. Cada canal vai de 0 a
+// 0xFF00, então somar um erro de até 0xFF não transborda para a metade vizinha.
+typedef struct {
+    uint32_t canais_1_3;
+    uint32_t canais_2_4;
+} cor16_t;
+
+// Coloca um canal 8.8 na metade de cor16_t que corresponde ao seu
+// deslocamento "d" no pixel (resolvido em compilação)
+static inline void cor16_colocar(cor16_t *cor, uint32_t valor, int d) {
+    if (d == 24 || d == 8) {
+        cor->canais_1_3 |= valor << (d >= 16 ? 16 : 0);
+    } else {
+        cor->canais_2_4 |= valor << (d >= 16 ? 16 : 0);
+    }
+}
+
+// Converte uma intensidade para 8.8 (0 a 0xFF00), com a mesma parte inteira
+// que calcular_cor_rgb usaria e a fração que ela descarta
+static inline uint32_t intensidade_8_8(intensidade_t v) {
+#if MATRIZ_CORRECAO_GAMA
+    // Interpola entre as entradas vizinhas da tabela de gama
+    uint32_t indice = v >> 8;
+    uint32_t a = tabela_gama[indice];
+    uint32_t b = tabela_gama[indice < 255 ? indice + 1 : 255];
+    return (a << 8) + (b - a) * (v & 0xFF);
+#else
+    return v - (v >> 8);
+#endif
+}
+
+// Função para calcular a cor em 8.8 bits por canal, na ordem de argumentos
+// de calcular_cor_rgb
+// Parâmetros:
+// - b: Intensidade do canal azul
+// - r: Intensidade do canal vermelho
+// - g: Intensidade do canal verde
+static inline cor16_t calcular_cor16(intensidade_t b, intensidade_t r, intensidade_t g) {
+    uint32_t R = intensidade_8_8(r);
+    uint32_t G = intensidade_8_8(g);
+    uint32_t B = intensidade_8_8(b);
+    cor16_t cor = {0, 0};
+#if PIXEL_CANAIS == 4
+    // Mesma extração do branco de empacotar_pixel(), com a fração
+    uint32_t W = R < G ? R : G;
+    W = W < B ? W : B;
+    R -= W;
+    G -= W;
+    B -= W;
+    cor16_colocar(&cor, W, PIXEL_DESLOCAMENTO_W);
+#endif
+    cor16_colocar(&cor, R, PIXEL_DESLOCAMENTO_R);
+    cor16_colocar(&cor, G, PIXEL_DESLOCAMENTO_G);
+    cor16_colocar(&cor, B, PIXEL_DESLOCAMENTO_B);
+    return cor;
+}
+
+// Calcula (sin(fase) + 1) / 2 pela tabela, com interpolação linear
+// Parâmetros:
+// - fase: Ângulo em fase_t
+// Retorna:
+// - Intensidade entre 0.0 e 1.0
+static inline intensidade_t onda_seno(fase_t fase) {
+    uint32_t indice = fase >> 8;
+    int32_t fracao = fase & 0xFF;
+    int32_t a = tabela_seno[indice];
+    int32_t b = tabela_seno[indice + 1];
+    return (intensidade_t)(a + (((b - a) * fracao) >> 8));
+}
+
+#endif
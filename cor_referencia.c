@@ -0,0 +1,60 @@
+#include "cor_referencia.h"
+
+#include <math.h>
+
+uint32_t calcular_cor_rgb_ref(double b, double r, double g) {
+    unsigned char R = r * 255;
+    unsigned char G = g * 255;
+    unsigned char B = b * 255;
+    return empacotar_pixel(R, G, B);
+}
+
+void referencia_animacao_2(uint32_t *quadro, int num_pixels, int frame) {
+    for (int i = 0; i < num_pixels; i++) {
+        double intensidade = 0.5 + 0.5 * sin((frame + i) * 0.3);
+
+        if ((frame / 10) % 3 == 0) {
+            quadro[i] = calcular_cor_rgb_ref(intensidade, 0.0, 0.0);
+        } else if ((frame / 10) % 3 == 1) {
+            quadro[i] = calcular_cor_rgb_ref(0.0, 0.0, intensidade);
+        } else {
+            quadro[i] = calcular_cor_rgb_ref(0.0, intensidade, 0.0);
+        }
+    }
+}
+
+void referencia_animacao_5(uint32_t *quadro, int num_pixels, int frame) {
+    const double pi = 3.14159265359;
+    const double step = 2 * pi / num_pixels;
+
+    for (int i = 0; i < num_pixels; i++) {
+        double wave_position = frame * step + i * step;
+        double r = (sin(wave_position) + 1) / 2;
+        double g = (sin(wave_position + 2 * pi / 3) + 1) / 2;
+        double b = (sin(wave_position + 4 * pi / 3) + 1) / 2;
+        quadro[i] = calcular_cor_rgb_ref(b, r, g);
+    }
+}
+
+uint32_t misturar_ref(uint32_t fundo, uint32_t frente, uint8_t opacidade, modo_mistura_t modo) {
+    double alfa = opacidade / 255.0;
+    uint32_t resultado = 0;
+    for (int deslocamento = PIXEL_DESLOCAMENTO_MINIMO; deslocamento < 32; deslocamento += 8) {
+        double d = (fundo >> deslocamento) & 0xFF;
+        double f = (frente >> deslocamento) & 0xFF;
+        double c;
+        switch (modo) {
+            case MISTURA_SOMAR:
+                c = fmin(255.0, d + f * alfa);
+                break;
+            case MISTURA_MULTIPLICAR:
+                c = d + (d * f / 255.0 - d) * alfa;
+                break;
+            default:
+                c = d + (f - d) * alfa;
+                break;
+        }
+        resultado |= (uint32_t)lround(c) << deslocamento;
+    }
+    return resultado;
+}
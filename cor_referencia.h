@@ -0,0 +1,24 @@
+#ifndef COR_REFERENCIA_H
+#define COR_REFERENCIA_H
+
+#include <stdint.h>
+#include "compositor.h"
+
+// Caminho de referência em ponto flutuante (double), igual ao cálculo
+// original das animações. Não é usado na placa; serve para comparar o
+// pipeline em ponto fixo de cor.h em testes e medições.
+
+// Versão em double de calcular_cor_rgb (intensidades de 0.0 a 1.0)
+uint32_t calcular_cor_rgb_ref(double b, double r, double g);
+
+// Desenha o quadro "frame" da animação 2 (onda de intensidade) com sin() em double
+void referencia_animacao_2(uint32_t *quadro, int num_pixels, int frame);
+
+// Desenha o quadro "frame" da animação 5 (onda de cores) com sin() em double
+void referencia_animacao_5(uint32_t *quadro, int num_pixels, int frame);
+
+// Mistura de compositor.h canal a canal em double: opacidade de 0 a 255,
+// produto normalizado por 255 e resultado arredondado
+uint32_t misturar_ref(uint32_t fundo, uint32_t frente, uint8_t opacidade, modo_mistura_t modo);
+
+#endif
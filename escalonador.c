@@ -0,0 +1,281 @@
+#include "escalonador.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "instrumentacao.h"
+
+void escalonador_iniciar(escalonador_t *escalonador, saida_leds_t *saida) {
+    memset(escalonador, 0, sizeof(*escalonador));
+    escalonador->saida = saida;
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        relogio_quadros_iniciar(&escalonador->faixas[c].relogio, FPS(1), 0);
+    }
+    relogio_quadros_iniciar(&escalonador->relogio_transicao, FPS_TRANSICAO, 0);
+}
+
+static void iniciar_faixa(faixa_t *faixa, const animacao_t *animacao, uint32_t mili_fps, uint64_t agora_us) {
+    faixa->animacao = animacao;
+    faixa->quadro = 0;
+    relogio_quadros_iniciar(&faixa->relogio, mili_fps, agora_us);
+}
+
+// Passa a compor as camadas. O fundo começa com o que está na matriz, já
+// que até aqui a animação dele desenhava direto na saída.
+static void entrar_composicao(escalonador_t *escalonador) {
+    if (escalonador->compondo) {
+        return;
+    }
+    saida_leds_t *saida = escalonador->saida;
+    camada_t *fundo = &escalonador->camadas[CAMADA_FUNDO];
+    memcpy(fundo->quadro.pixels, saida->buffers[saida->desenho ^ 1].pixels, sizeof(framebuffer_t));
+    fundo->opacidade = 255;
+    fundo->modo = MISTURA_SOBREPOR;
+    fundo->visivel = true;
+    escalonador->compondo = true;
+    if (escalonador->pontilhamento) {
+        pontilhamento_parar(escalonador->pontilhamento);
+    }
+}
+
+// A animação que entrou vira o fundo (a composição não muda)
+static void concluir_transicao(escalonador_t *escalonador) {
+    escalonador->faixas[CAMADA_FUNDO] = escalonador->faixas[CAMADA_ENTRADA];
+    escalonador->camadas[CAMADA_FUNDO] = escalonador->camadas[CAMADA_ENTRADA];
+    escalonador->camadas[CAMADA_FUNDO].opacidade = 255;
+    escalonador->faixas[CAMADA_ENTRADA].animacao = NULL;
+    escalonador->camadas[CAMADA_ENTRADA].visivel = false;
+    escalonador->em_transicao = false;
+}
+
+// Volta a desenhar o fundo direto na saída quando só ele está visível
+static void atualizar_composicao(escalonador_t *escalonador) {
+    bool sobreposicao = false;
+    for (int c = CAMADA_SOBREPOSICAO; c < COMPOSITOR_CAMADAS; c++) {
+        sobreposicao |= escalonador->camadas[c].visivel;
+    }
+    escalonador->compondo = sobreposicao || escalonador->em_transicao;
+}
+
+void escalonador_tocar(escalonador_t *escalonador, const animacao_t *animacao, uint32_t mili_fps, uint64_t agora_us) {
+    if (escalonador->em_transicao) {
+        concluir_transicao(escalonador);
+    }
+
+    // Sem nada na matriz não há de onde fazer a transição
+    if (escalonador->transicao_us == 0 || !escalonador->saida->transmitido) {
+        iniciar_faixa(&escalonador->faixas[CAMADA_FUNDO], animacao, mili_fps, agora_us);
+        atualizar_composicao(escalonador);
+        return;
+    }
+
+    entrar_composicao(escalonador);
+    iniciar_faixa(&escalonador->faixas[CAMADA_ENTRADA], animacao, mili_fps, agora_us);
+    camada_t *entrada = &escalonador->camadas[CAMADA_ENTRADA];
+    entrada->opacidade = 0;
+    entrada->modo = MISTURA_SOBREPOR;
+    entrada->visivel = true;
+    escalonador->em_transicao = true;
+    escalonador->inicio_transicao_us = agora_us;
+    relogio_quadros_iniciar(&escalonador->relogio_transicao, FPS_TRANSICAO, agora_us);
+}
+
+void escalonador_sobrepor(escalonador_t *escalonador, int camada, const animacao_t *animacao, uint32_t mili_fps,
+                          modo_mistura_t modo, uint8_t opacidade, uint64_t agora_us) {
+    if (camada < CAMADA_SOBREPOSICAO || camada >= COMPOSITOR_CAMADAS) {
+        return;
+    }
+    entrar_composicao(escalonador);
+    iniciar_faixa(&escalonador->faixas[camada], animacao, mili_fps, agora_us);
+    escalonador->camadas[camada].opacidade = opacidade;
+    escalonador->camadas[camada].modo = modo;
+    // Fica invisível até desenhar o primeiro quadro
+    escalonador->camadas[camada].visivel = false;
+}
+
+void escalonador_remover(escalonador_t *escalonador, int camada) {
+    if (camada < CAMADA_SOBREPOSICAO || camada >= COMPOSITOR_CAMADAS || !escalonador->compondo) {
+        return;
+    }
+    escalonador->faixas[camada].animacao = NULL;
+    escalonador->camadas[camada].visivel = false;
+    escalonador->recompor = true;
+}
+
+bool escalonador_camada_visivel(const escalonador_t *escalonador, int camada) {
+    return camada >= 0 && camada < COMPOSITOR_CAMADAS &&
+           (escalonador->camadas[camada].visivel || escalonador->faixas[camada].animacao != NULL);
+}
+
+void escalonador_parar(escalonador_t *escalonador) {
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        escalonador->faixas[c].animacao = NULL;
+        escalonador->camadas[c].visivel = false;
+    }
+    escalonador->em_transicao = false;
+    escalonador->compondo = false;
+    escalonador->recompor = false;
+    if (escalonador->pontilhamento) {
+        pontilhamento_parar(escalonador->pontilhamento);
+    }
+}
+
+// Avança uma faixa cujo prazo chegou. Retorna true se um quadro foi desenhado
+// em "quadro" ou "quadro16" (o que não for NULL).
+static bool avancar_faixa(escalonador_t *escalonador, faixa_t *faixa, uint64_t agora_us,
+                          uint32_t *quadro, cor16_t *quadro16) {
+    const animacao_t *animacao = faixa->animacao;
+    if (animacao == NULL || agora_us < relogio_quadros_prazo(&faixa->relogio)) {
+        return false;
+    }
+
+    // O último quadro fica na matriz por um período antes de a animação terminar
+    if (faixa->quadro >= animacao->quant_quadros) {
+        faixa->animacao = NULL;
+        return false;
+    }
+
+    if (quadro16) {
+        animacao->desenhar16(animacao, quadro16, faixa->quadro);
+    } else if (escalonador->cache) {
+        cache_quadros_desenhar(escalonador->cache, animacao, quadro, faixa->quadro);
+    } else {
+        animacao->desenhar(animacao, quadro, faixa->quadro);
+    }
+    return true;
+}
+
+static void concluir_quadro(escalonador_t *escalonador, faixa_t *faixa, uint64_t agora_us) {
+    faixa->quadro++;
+    escalonador->prazos_perdidos += relogio_quadros_avancar(&faixa->relogio, agora_us);
+}
+
+// Só o fundo visível: a animação desenha direto na saída ou no pontilhamento
+static bool passo_direto(escalonador_t *escalonador, uint64_t agora_us) {
+    faixa_t *faixa = &escalonador->faixas[CAMADA_FUNDO];
+    const animacao_t *animacao = faixa->animacao;
+    uint64_t prazo_us = relogio_quadros_prazo(&faixa->relogio);
+    saida_leds_t *saida = escalonador->saida;
+    pontilhamento_t *pontilhamento = escalonador->pontilhamento;
+    bool alta_precisao = pontilhamento && animacao && animacao->desenhar16;
+    uint32_t suprimidos = saida->estatisticas.suprimidos;
+
+    uint32_t inicio_desenho = instrumentacao_agora();
+    if (!avancar_faixa(escalonador, faixa, agora_us, saida_leds_quadro(saida),
+                       alta_precisao ? pontilhamento_quadro(pontilhamento) : NULL)) {
+        return false;
+    }
+    uint32_t fim_desenho = instrumentacao_agora();
+
+    // No pontilhamento o quadro só troca de buffer; a matriz é renovada em pontilhamento_passo()
+    if (alta_precisao) {
+        pontilhamento_apresentar(pontilhamento, agora_us);
+    } else {
+        if (pontilhamento) {
+            pontilhamento_parar(pontilhamento);
+        }
+        saida_leds_apresentar(saida);
+    }
+    bool contar = saida->contar_alterados && !alta_precisao;
+    instrumentacao_registrar_quadro(animacao, faixa->quadro, relogio_quadros_periodo_us(&faixa->relogio),
+                                    (uint32_t)prazo_us, (uint32_t)agora_us,
+                                    inicio_desenho, fim_desenho, instrumentacao_agora(),
+                                    contar ? saida->estatisticas.ultimo_alterados : UINT16_MAX,
+                                    saida->estatisticas.suprimidos != suprimidos);
+
+    concluir_quadro(escalonador, faixa, agora_us);
+    return true;
+}
+
+// Com camadas: cada faixa desenha no quadro da sua camada e o resultado é
+// composto no quadro da saída
+static bool passo_composto(escalonador_t *escalonador, uint64_t agora_us) {
+    saida_leds_t *saida = escalonador->saida;
+    bool recompor = escalonador->recompor;
+    // Primeira faixa que desenhou, para a instrumentação (a transição pode mudar as faixas de lugar)
+    const animacao_t *registrada = NULL;
+    uint16_t quadro_registrado = 0;
+    uint32_t periodo_registrado = 0;
+    uint64_t prazo_registrado = agora_us;
+    uint32_t suprimidos = saida->estatisticas.suprimidos;
+
+    uint32_t inicio_desenho = instrumentacao_agora();
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        faixa_t *faixa = &escalonador->faixas[c];
+        uint64_t prazo_us = relogio_quadros_prazo(&faixa->relogio);
+        bool tocando = faixa->animacao != NULL;
+        bool desenhou = avancar_faixa(escalonador, faixa, agora_us, escalonador->camadas[c].quadro.pixels, NULL);
+
+        // Uma sobreposição que terminou sai da composição
+        if (tocando && faixa->animacao == NULL && c >= CAMADA_SOBREPOSICAO) {
+            escalonador->camadas[c].visivel = false;
+            recompor = true;
+        }
+        if (desenhou) {
+            if (registrada == NULL) {
+                registrada = faixa->animacao;
+                quadro_registrado = faixa->quadro;
+                periodo_registrado = relogio_quadros_periodo_us(&faixa->relogio);
+                prazo_registrado = prazo_us;
+            }
+            escalonador->camadas[c].visivel = true;
+            concluir_quadro(escalonador, faixa, agora_us);
+            recompor = true;
+        }
+    }
+
+    // A opacidade da animação que entra sobe linearmente com o tempo
+    if (escalonador->em_transicao && agora_us >= relogio_quadros_prazo(&escalonador->relogio_transicao)) {
+        uint64_t decorrido = agora_us - escalonador->inicio_transicao_us;
+        if (decorrido >= escalonador->transicao_us) {
+            concluir_transicao(escalonador);
+        } else {
+            escalonador->camadas[CAMADA_ENTRADA].opacidade = (uint8_t)(decorrido * 255 / escalonador->transicao_us);
+            relogio_quadros_avancar(&escalonador->relogio_transicao, agora_us);
+        }
+        recompor = true;
+    }
+
+    if (!recompor) {
+        return false;
+    }
+    compositor_compor(escalonador->camadas, COMPOSITOR_CAMADAS, saida_leds_quadro(saida));
+    uint32_t fim_desenho = instrumentacao_agora();
+    saida_leds_apresentar(saida);
+    escalonador->recompor = false;
+    atualizar_composicao(escalonador);
+
+    if (registrada) {
+        instrumentacao_registrar_quadro(registrada, quadro_registrado, periodo_registrado,
+                                        (uint32_t)prazo_registrado, (uint32_t)agora_us,
+                                        inicio_desenho, fim_desenho, instrumentacao_agora(),
+                                        saida->contar_alterados ? saida->estatisticas.ultimo_alterados : UINT16_MAX,
+                                        saida->estatisticas.suprimidos != suprimidos);
+    }
+    return true;
+}
+
+bool escalonador_passo(escalonador_t *escalonador, uint64_t agora_us) {
+    return escalonador->compondo ? passo_composto(escalonador, agora_us) : passo_direto(escalonador, agora_us);
+}
+
+bool escalonador_concluido(const escalonador_t *escalonador) {
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        if (escalonador->faixas[c].animacao) {
+            return false;
+        }
+    }
+    return !escalonador->em_transicao && !escalonador->recompor;
+}
+
+uint64_t escalonador_prazo(const escalonador_t *escalonador) {
+    if (escalonador->recompor) {
+        return 0;
+    }
+    uint64_t prazo = escalonador->em_transicao ? relogio_quadros_prazo(&escalonador->relogio_transicao) : UINT64_MAX;
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        uint64_t faixa = escalonador->faixas[c].animacao ? relogio_quadros_prazo(&escalonador->faixas[c].relogio)
+                                                          : UINT64_MAX;
+        prazo = faixa < prazo ? faixa : prazo;
+    }
+    return prazo;
+}
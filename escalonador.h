@@ -0,0 +1,105 @@
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "animacoes.h"
+#include "cache_quadros.h"
+#include "compositor.h"
+#include "pontilhamento.h"
+#include "relogio_quadros.h"
+#include "saida_leds.h"
+
+// Camadas do escalonador: a animação de escalonador_tocar() fica no fundo,
+// a que entra numa transição logo acima dele e as sobreposições por cima
+#define CAMADA_FUNDO 0
+#define CAMADA_ENTRADA 1
+#define CAMADA_SOBREPOSICAO 2 // Primeira camada de escalonador_sobrepor()
+
+// Taxa em que a composição é refeita durante uma transição
+#define FPS_TRANSICAO FPS(50)
+
+// Animação tocando numa camada
+typedef struct {
+    const animacao_t *animacao; // NULL quando concluída
+    uint16_t quadro;            // Próximo quadro a ser desenhado
+    relogio_quadros_t relogio;  // Prazo do próximo quadro (ou do fim da animação)
+} faixa_t;
+
+// Escalonador não bloqueante: avança as animações um quadro por vez, só
+// quando o prazo do próximo quadro chega, e deixa o laço principal livre
+// para ler o teclado entre um quadro e outro. Os prazos vêm de um
+// relogio_quadros_t por camada, então a taxa medida é a pedida.
+//
+// Com só o fundo visível a animação desenha direto no quadro da saída. Com
+// uma transição ou sobreposição cada camada desenha no próprio quadro, e o
+// compositor monta o quadro da saída (em 8 bits, sem pontilhamento).
+typedef struct {
+    saida_leds_t *saida;
+    faixa_t faixas[COMPOSITOR_CAMADAS];
+    camada_t camadas[COMPOSITOR_CAMADAS];
+    bool compondo;            // Alguma camada além do fundo está visível
+    bool recompor;            // A composição mudou sem um quadro novo
+    uint32_t prazos_perdidos; // Soma dos prazos perdidos de todas as animações
+
+    // Duração do crossfade de escalonador_tocar() (0 troca a animação na hora)
+    uint32_t transicao_us;
+    bool em_transicao;
+    uint64_t inicio_transicao_us;
+    relogio_quadros_t relogio_transicao;
+
+    // Com um pontilhamento, animações com desenhar16 desenham em 8.8 bits e
+    // o pontilhamento renova a matriz; NULL desenha sempre em 8 bits
+    pontilhamento_t *pontilhamento;
+
+    // Com um cache, os quadros de 8 bits vêm de cache_quadros_desenhar()
+    // (os de 8.8 bits do pontilhamento são sempre desenhados)
+    cache_quadros_t *cache;
+} escalonador_t;
+
+// Inicializa o escalonador sem nenhuma animação ativa
+void escalonador_iniciar(escalonador_t *escalonador, saida_leds_t *saida);
+
+// Troca a animação do fundo. Sem transição a anterior é interrompida e o
+// primeiro quadro é apresentado no próximo escalonador_passo(); com
+// transicao_us a nova animação aparece aos poucos sobre a anterior, que
+// continua tocando até a transição terminar.
+// Parâmetros:
+// - animacao: Animação a ser exibida
+// - mili_fps: Taxa da animação em milésimos de quadro por segundo (use FPS())
+// - agora_us: Instante atual em microssegundos
+void escalonador_tocar(escalonador_t *escalonador, const animacao_t *animacao, uint32_t mili_fps, uint64_t agora_us);
+
+// Toca uma animação numa camada de sobreposição, acima do fundo. Quando a
+// animação termina (ou com escalonador_remover()) a camada sai da composição.
+// Parâmetros:
+// - camada: CAMADA_SOBREPOSICAO a COMPOSITOR_CAMADAS - 1
+// - animacao: Animação a ser exibida
+// - mili_fps: Taxa da animação em milésimos de quadro por segundo
+// - modo: Mistura da camada com as de baixo
+// - opacidade: 0 a 255
+// - agora_us: Instante atual em microssegundos
+void escalonador_sobrepor(escalonador_t *escalonador, int camada, const animacao_t *animacao, uint32_t mili_fps,
+                          modo_mistura_t modo, uint8_t opacidade, uint64_t agora_us);
+
+// Retira uma camada de sobreposição; a matriz é recomposta sem ela
+void escalonador_remover(escalonador_t *escalonador, int camada);
+
+// Retorna true se a camada está visível ou com a animação em andamento
+bool escalonador_camada_visivel(const escalonador_t *escalonador, int camada);
+
+// Interrompe todas as animações, as camadas e o pontilhamento, deixando o último quadro na matriz
+void escalonador_parar(escalonador_t *escalonador);
+
+// Apresenta o próximo quadro se o seu prazo já chegou
+// Retorna:
+// - true se um quadro foi apresentado
+bool escalonador_passo(escalonador_t *escalonador, uint64_t agora_us);
+
+// Retorna true quando não há animação nem transição em andamento
+bool escalonador_concluido(const escalonador_t *escalonador);
+
+// Instante em que escalonador_passo() terá trabalho a fazer (UINT64_MAX se nenhum)
+uint64_t escalonador_prazo(const escalonador_t *escalonador);
+
+#endif
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Roda host/bancada_desempenho em vários tamanhos de matriz.
+
+O tamanho da matriz é fixado na compilação, então cada tamanho tem a sua
+compilação MATRIZ_HOST (Release) em um subdiretório de --compilacao. A
+bancada roda --repeticoes vezes e vale o menor tempo de cada caso, o que
+descarta os trechos em que a máquina estava ocupada com outra coisa. As
+medições de todos os tamanhos saem juntas em um só CSV, no formato de
+bancada/referencia.csv. Com --comparar, mostra a variação de cada caso
+contra um CSV anterior e termina com erro se algum ficar mais lento que a
+tolerância.
+
+Uso: bancada_desempenho.py [--tamanhos 5x5,16x16,32x32,64x64] [--repeticoes 5]
+                           [--saida arquivo.csv] [--comparar bancada/referencia.csv] [--tolerancia 15]
+
+Exemplo, atualizando a referência:
+     bancada_desempenho.py --saida bancada/referencia.csv
+"""
+
+import argparse
+import csv
+import io
+import os
+import subprocess
+import sys
+
+RAIZ = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def medir(largura, altura, compilacao, ms_lote, repeticoes):
+    """Compila a bancada para a matriz pedida e retorna as linhas do CSV."""
+    destino = os.path.join(compilacao, f"{largura}x{altura}")
+    subprocess.run(["cmake", "-S", RAIZ, "-B", destino, "-DMATRIZ_HOST=ON", "-DCMAKE_BUILD_TYPE=Release",
+                    f"-DMATRIZ_LARGURA={largura}", f"-DMATRIZ_ALTURA={altura}"],
+                   check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(["cmake", "--build", destino, "--target", "bancada_desempenho", "-j", str(os.cpu_count() or 1)],
+                   check=True, stdout=subprocess.DEVNULL)
+    melhores = {}
+    for _ in range(repeticoes):
+        saida = subprocess.run([os.path.join(destino, "host", "bancada_desempenho"), str(ms_lote)],
+                               check=True, capture_output=True, text=True).stdout
+        for linha in csv.DictReader(io.StringIO(saida)):
+            anterior = melhores.get(linha["caso"])
+            if anterior is None or float(linha["ns_por_quadro"]) < float(anterior["ns_por_quadro"]):
+                melhores[linha["caso"]] = linha
+    return list(melhores.values())
+
+
+def comparar(linhas, arquivo, tolerancia):
+    """Imprime a variação de cada caso; retorna quantos passaram da tolerância."""
+    with open(arquivo, newline="") as f:
+        anteriores = {(l["caso"], l["pixels"]): float(l["ns_por_quadro"]) for l in csv.DictReader(f)}
+    piores = 0
+    for linha in linhas:
+        anterior = anteriores.get((linha["caso"], linha["pixels"]))
+        if anterior is None:
+            continue
+        variacao = 100.0 * (float(linha["ns_por_quadro"]) / anterior - 1.0)
+        marca = "  MAIS LENTO" if variacao > tolerancia else ""
+        piores += bool(marca)
+        print(f"{linha['caso']:28} {linha['pixels']:>5} px {anterior:12.1f} -> {float(linha['ns_por_quadro']):12.1f} ns"
+              f" {variacao:+7.1f}%{marca}", file=sys.stderr)
+    return piores
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--tamanhos", default="5x5,16x16,32x32,64x64", help="matrizes LARGURAxALTURA")
+    parser.add_argument("--compilacao", default=os.path.join(RAIZ, "build_bancada"),
+                        help="diretório das compilações de cada tamanho")
+    parser.add_argument("--ms-lote", type=int, default=10, help="duração de cada lote medido, em ms")
+    parser.add_argument("--repeticoes", type=int, default=5, help="execuções da bancada por tamanho")
+    parser.add_argument("--saida", default="-", help="CSV gerado ('-' para a saída padrão)")
+    parser.add_argument("--comparar", help="CSV anterior para comparar")
+    parser.add_argument("--tolerancia", type=float, default=15.0, help="aumento tolerado no --comparar, em %%")
+    args = parser.parse_args()
+
+    linhas = []
+    for tamanho in args.tamanhos.split(","):
+        largura, altura = (int(x) for x in tamanho.lower().split("x"))
+        linhas += medir(largura, altura, args.compilacao, args.ms_lote, args.repeticoes)
+
+    destino = sys.stdout if args.saida == "-" else open(args.saida, "w", newline="")
+    escritor = csv.DictWriter(destino, fieldnames=["caso", "pixels", "ns_por_quadro", "pixels_por_s"],
+                              lineterminator="\n")
+    escritor.writeheader()
+    escritor.writerows(linhas)
+    if destino is not sys.stdout:
+        destino.close()
+
+    if args.comparar and comparar(linhas, args.comparar, args.tolerancia):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Envia quadros para a matriz no modo de recepção (tecla 8).
+
+Gera um padrão animado e o transmite no protocolo descrito em
+fluxo_quadros.h, no ritmo pedido, para a porta USB da placa, para um pty ou
+para a saída padrão (que pode ser ligada ao receptor_fluxo da compilação
+MATRIZ_HOST). Ao final informa a taxa efetivamente sustentada pelo envio.
+
+Uso: enviar_quadros.py [--pixels N] [--fps F] [--quadros Q] [destino]
+     destino: dispositivo (ex.: /dev/ttyACM0), caminho de pty ou '-' (padrão)
+
+Exemplo sem placa:
+     enviar_quadros.py --pixels 25 --fps 60 --quadros 600 | receptor_fluxo
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import time
+
+MAGICO = b"QD"
+
+
+def crc16_ccitt(dados, crc=0xFFFF):
+    for byte in dados:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def quadro(pixels, sequencia, fps):
+    """Um quadro completo: onda de cores que corre ao longo da fita."""
+    cores = bytearray()
+    for i in range(pixels):
+        fase = (sequencia + i) * 0.2
+        r = int((math.sin(fase) + 1) * 63)
+        g = int((math.sin(fase + 2.09) + 1) * 63)
+        b = int((math.sin(fase + 4.19) + 1) * 63)
+        cores += bytes((g, r, b))
+    corpo = struct.pack("<HHBB", pixels, sequencia & 0xFFFF, min(fps, 255), 0) + cores
+    return MAGICO + corpo + struct.pack("<H", crc16_ccitt(corpo))
+
+
+def abrir(destino):
+    if destino == "-":
+        return sys.stdout.buffer
+    fd = os.open(destino, os.O_WRONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        import termios
+        import tty
+        tty.setraw(fd, termios.TCSANOW)  # Sem tradução de fim de linha nem eco
+    return os.fdopen(fd, "wb", buffering=0)
+
+
+def main():
+    argumentos = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    argumentos.add_argument("--pixels", type=int, default=25, help="NUM_PIXELS do firmware")
+    argumentos.add_argument("--fps", type=int, default=30)
+    argumentos.add_argument("--quadros", type=int, default=300)
+    argumentos.add_argument("destino", nargs="?", default="-")
+    opcoes = argumentos.parse_args()
+
+    # Os quadros são gerados antes, para que o envio meça só o transporte
+    quadros = [quadro(opcoes.pixels, n, opcoes.fps) for n in range(min(opcoes.quadros, 256))]
+    saida = abrir(opcoes.destino)
+    periodo = 1.0 / opcoes.fps if opcoes.fps else 0.0
+
+    inicio = time.perf_counter()
+    atrasados = 0
+    for n in range(opcoes.quadros):
+        prazo = inicio + n * periodo
+        espera = prazo - time.perf_counter()
+        if espera > 0:
+            time.sleep(espera)
+        elif periodo and -espera > periodo:
+            atrasados += 1
+        dados = bytearray(quadros[n % len(quadros)])
+        struct.pack_into("<H", dados, 4, n & 0xFFFF)  # Sequência real
+        struct.pack_into("<H", dados, len(dados) - 2, crc16_ccitt(dados[2:-2]))
+        saida.write(dados)
+        saida.flush()
+    duracao = time.perf_counter() - inicio
+
+    fps = (opcoes.quadros - 1) / duracao if duracao > 0 and opcoes.quadros > 1 else 0.0
+    bytes_por_quadro = len(quadros[0])
+    print("enviados %d quadros de %d pixels (%d bytes): %.1f fps, %.1f kB/s, %d fora do ritmo"
+          % (opcoes.quadros, opcoes.pixels, bytes_por_quadro, fps, fps * bytes_por_quadro / 1000, atrasados),
+          file=sys.stderr)
+    return 0 if atrasados == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Converte fonte.txt no atlas de bits usado pelo texto rolante.
+
+Executado pelo CMake durante a compilação. Gera um cabeçalho com as
+dimensões do atlas e um .c com o atlas (as linhas de todos os caracteres
+lado a lado, 1 bit por pixel, o pixel x no bit 31 - x % 32 da palavra
+x / 32, como em sprite.h) e a tabela com a coluna e a largura de cada
+caractere imprimível (' ' a '~').
+
+Uso: gerar_fonte.py <fonte.txt> <saida.h> <saida.c>
+"""
+
+import sys
+
+ALTURA = 5
+LARGURA_MAXIMA = 8
+PRIMEIRO = 32
+ULTIMO = 126
+SUBSTITUTO = "?"
+
+
+class ErroFonte(Exception):
+    pass
+
+
+def ler(caminho):
+    caracteres = []  # (caractere, linhas)
+    with open(caminho, encoding="utf-8") as f:
+        linhas = [(n + 1, l.strip()) for n, l in enumerate(f)]
+
+    # Como em glifos.txt, as linhas de desenho são lidas pelo comando
+    # "caractere", então podem começar por '#'
+    i = 0
+    while i < len(linhas):
+        num, texto = linhas[i]
+        i += 1
+        if not texto or texto.startswith("#"):
+            continue
+        partes = texto.split()
+        if partes[0] != "caractere" or len(partes) != 2:
+            raise ErroFonte("%s:%d: esperado 'caractere <c>'" % (caminho, num))
+        c = " " if partes[1] == "espaco" else partes[1]
+        if len(c) != 1 or not PRIMEIRO <= ord(c) <= ULTIMO:
+            raise ErroFonte("%s:%d: caractere inválido '%s'" % (caminho, num, partes[1]))
+        if any(c == existente for existente, _ in caracteres):
+            raise ErroFonte("%s:%d: caractere '%s' repetido" % (caminho, num, c))
+        desenho = [linhas[i + k][1] for k in range(ALTURA)]
+        largura = len(desenho[0])
+        if not 1 <= largura <= LARGURA_MAXIMA or any(len(l) != largura for l in desenho):
+            raise ErroFonte("%s:%d: o desenho deve ter %d linhas da mesma largura (1 a %d)"
+                            % (caminho, num, ALTURA, LARGURA_MAXIMA))
+        if any(ch not in "#." for l in desenho for ch in l):
+            raise ErroFonte("%s:%d: use só '#' e '.' no desenho" % (caminho, num))
+        i += ALTURA
+        caracteres.append((c, desenho))
+    return caracteres
+
+
+def main():
+    entrada, saida_h, saida_c = sys.argv[1:4]
+    caracteres = ler(entrada)
+
+    # Atlas: os caracteres lado a lado, na ordem do arquivo
+    colunas = {}
+    linhas_atlas = ["" for _ in range(ALTURA)]
+    for c, desenho in caracteres:
+        colunas[c] = (len(linhas_atlas[0]), len(desenho[0]))
+        for y in range(ALTURA):
+            linhas_atlas[y] += desenho[y]
+    if SUBSTITUTO not in colunas:
+        raise ErroFonte("%s: falta o caractere '%s', usado no lugar dos que não têm desenho"
+                        % (entrada, SUBSTITUTO))
+    largura_atlas = len(linhas_atlas[0])
+    palavras = (largura_atlas + 31) // 32
+
+    h = ["// Arquivo gerado por ferramentas/gerar_fonte.py a partir de fonte.txt; não edite.",
+         "", "#ifndef FONTE_GERADA_H", "#define FONTE_GERADA_H", "", '#include "texto.h"', "",
+         "#define FONTE_ATLAS_LARGURA %d" % largura_atlas,
+         "#define FONTE_ATLAS_PALAVRAS %d // Palavras por linha do atlas" % palavras, "",
+         "extern const uint32_t fonte_atlas[FONTE_ALTURA * FONTE_ATLAS_PALAVRAS];",
+         "extern const glifo_fonte_t fonte_glifos[FONTE_CARACTERES];", "", "#endif"]
+
+    c = ["// Arquivo gerado por ferramentas/gerar_fonte.py a partir de fonte.txt; não edite.",
+         "", '#include "fonte_gerada.h"', "",
+         "const uint32_t fonte_atlas[FONTE_ALTURA * FONTE_ATLAS_PALAVRAS] = {"]
+    for linha in linhas_atlas:
+        bits = linha.ljust(palavras * 32, ".")
+        valores = ["0x%08xu" % int(bits[p * 32:p * 32 + 32].replace("#", "1").replace(".", "0"), 2)
+                   for p in range(palavras)]
+        c.append("    " + ", ".join(valores) + ",")
+    c.append("};")
+    c.append("")
+    c.append("const glifo_fonte_t fonte_glifos[FONTE_CARACTERES] = {")
+    for codigo in range(PRIMEIRO, ULTIMO + 1):
+        ch = chr(codigo)
+        origem = ch if ch in colunas else ch.upper() if ch.upper() in colunas else SUBSTITUTO
+        x, largura = colunas[origem]
+        nota = "" if origem == ch else " -> %r" % origem
+        c.append("    {%d, %d}, // %r%s" % (x, largura, ch, nota))
+    c.append("};")
+
+    with open(saida_h, "w", encoding="utf-8") as f:
+        f.write("\n".join(h) + "\n")
+    with open(saida_c, "w", encoding="utf-8") as f:
+        f.write("\n".join(c) + "\n")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ErroFonte as erro:
+        sys.exit(str(erro))
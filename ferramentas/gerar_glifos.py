@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Converte glifos.txt nas tabelas C usadas pelas animações de glifos.
+
+Executado pelo CMake durante a compilação. Gera um cabeçalho com as
+declarações e um .c com a paleta, as sequências de quadros (máscara de 25
+bits + índice da paleta numa palavra de 32 bits) e as listas de ordem das
+revelações progressivas.
+
+Máscaras e ordens usam a posição lógica do glifo (bit y * 5 + x, com (0, 0)
+no canto superior esquerdo); a conversão para o índice do LED é feita em
+tempo de execução pelo mapa da geometria (geometria.h).
+
+Uso: gerar_glifos.py <glifos.txt> <saida.h> <saida.c>
+"""
+
+import sys
+
+LARGURA = 5
+ALTURA = 5
+ORDEM = "0123456789abcdefghijklmno"
+BITS_MASCARA = 25
+
+
+def posicao(x, y):
+    """Bit do glifo correspondente à posição (x, y) vista de frente."""
+    return y * LARGURA + x
+
+
+class ErroGlifo(Exception):
+    pass
+
+
+def ler(caminho):
+    cores = {}
+    blocos = []  # (tipo, nome, [(cor, linhas)])
+    with open(caminho, encoding="utf-8") as f:
+        linhas = [(n + 1, l.strip()) for n, l in enumerate(f)]
+
+    # Fora dos quadros, linhas iniciadas por '#' são comentários; as linhas
+    # de desenho são lidas diretamente pelo comando "quadro".
+    i = 0
+    while i < len(linhas):
+        num, texto = linhas[i]
+        i += 1
+        if not texto or texto.startswith("#"):
+            continue
+        partes = texto.split()
+        if partes[0] == "cor":
+            cores[partes[1]] = (len(cores), [float(v) for v in partes[2:5]])
+        elif partes[0] in ("sequencia", "revelacao"):
+            blocos.append((partes[0], partes[1], []))
+        elif partes[0] == "quadro":
+            if not blocos:
+                raise ErroGlifo("%s:%d: quadro fora de sequência" % (caminho, num))
+            if partes[1] not in cores:
+                raise ErroGlifo("%s:%d: cor desconhecida '%s'" % (caminho, num, partes[1]))
+            desenho = [linhas[i + k][1] for k in range(ALTURA)]
+            if any(len(l) != LARGURA for l in desenho):
+                raise ErroGlifo("%s:%d: quadro deve ter %dx%d caracteres" % (caminho, num, LARGURA, ALTURA))
+            i += ALTURA
+            blocos[-1][2].append((partes[1], desenho))
+        else:
+            raise ErroGlifo("%s:%d: comando desconhecido '%s'" % (caminho, num, partes[0]))
+    return cores, blocos
+
+
+def mascara(desenho):
+    m = 0
+    for y, linha in enumerate(desenho):
+        for x, c in enumerate(linha):
+            if c == "#":
+                m |= 1 << posicao(x, y)
+    return m
+
+
+def ordem(desenho):
+    posicoes = {}
+    for y, linha in enumerate(desenho):
+        for x, c in enumerate(linha):
+            if c != ".":
+                posicoes[ORDEM.index(c)] = posicao(x, y)
+    return [posicoes[k] for k in sorted(posicoes)]
+
+
+def main():
+    entrada, saida_h, saida_c = sys.argv[1:4]
+    cores, blocos = ler(entrada)
+
+    h = ["// Arquivo gerado por ferramentas/gerar_glifos.py a partir de glifos.txt; não edite.",
+         "", "#ifndef GLIFOS_GERADOS_H", "#define GLIFOS_GERADOS_H", "", '#include "glifos.h"', ""]
+    c = ["// Arquivo gerado por ferramentas/gerar_glifos.py a partir de glifos.txt; não edite.",
+         "", '#include "glifos_gerados.h"', "", "const cor_paleta_t paleta_glifos[] = {"]
+    for nome, (indice, (r, g, b)) in sorted(cores.items(), key=lambda e: e[1][0]):
+        c.append("    {INTENSIDADE(%.3f), INTENSIDADE(%.3f), INTENSIDADE(%.3f)}, // %d: %s" % (r, g, b, indice, nome))
+    c.append("};")
+
+    for tipo, nome, quadros in blocos:
+        c.append("")
+        tamanho = "%s_TAMANHO" % nome.upper()
+        h.append("#define %s %d" % (tamanho, len(quadros)))
+        if tipo == "sequencia":
+            h.append("extern const quadro_glifo_t glifos_%s[%s];" % (nome, tamanho))
+            c.append("const quadro_glifo_t glifos_%s[%s] = {" % (nome, tamanho))
+            for cor, desenho in quadros:
+                c.append("    0x%08xu, // %s" % (cores[cor][0] << BITS_MASCARA | mascara(desenho), cor))
+            c.append("};")
+        else:
+            h.append("#define %s_LEDS %d // Total de LEDs revelados na sequência"
+                     % (nome.upper(), sum(len(ordem(d)) for _, d in quadros)))
+            h.append("extern const revelacao_glifo_t glifos_%s[%s];" % (nome, tamanho))
+            for n, (cor, desenho) in enumerate(quadros):
+                c.append("static const uint8_t %s_%d[] = {%s};" % (nome, n, ", ".join(str(v) for v in ordem(desenho))))
+            c.append("const revelacao_glifo_t glifos_%s[%s] = {" % (nome, tamanho))
+            for n, (cor, desenho) in enumerate(quadros):
+                c.append("    {%s_%d, %d, %d}, // %s" % (nome, n, len(ordem(desenho)), cores[cor][0], cor))
+            c.append("};")
+        h.append("")
+
+    h.append("#endif")
+    with open(saida_h, "w", encoding="utf-8") as f:
+        f.write("\n".join(h) + "\n")
+    with open(saida_c, "w", encoding="utf-8") as f:
+        f.write("\n".join(c) + "\n")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ErroGlifo as erro:
+        sys.exit(str(erro))
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Gera o mapa de posições lógicas para índices físicos dos LEDs.
+
+Executado pelo CMake durante a compilação. A matriz lógica tem LARGURA x
+ALTURA pixels, com (0, 0) no canto superior esquerdo visto de frente. Ela é
+dividida em VIAS faixas horizontais de mesma altura; cada faixa é uma fita
+ligada a uma saída própria e ocupa um trecho contínuo do framebuffer.
+
+Dentro de cada faixa, a fita começa no canto ORIGEM e corre ao longo das
+linhas; com serpentina as linhas alternam de sentido, sem ela todas correm
+no mesmo sentido da primeira.
+
+Uso: gerar_mapa_leds.py <saida.c> <largura> <altura> <vias> <origem> <serpentina>
+     origem: inferior_direita | inferior_esquerda | superior_direita | superior_esquerda
+     serpentina: 1 ou 0
+"""
+
+import sys
+
+ORIGENS = ("inferior_direita", "inferior_esquerda", "superior_direita", "superior_esquerda")
+MAX_VIAS = 4
+
+
+def mapa(largura, altura, vias, origem, serpentina):
+    altura_via = altura // vias
+    por_via = largura * altura_via
+    de_baixo = origem.startswith("inferior")
+    da_direita = origem.endswith("direita")
+
+    indices = [0] * (largura * altura)
+    for via in range(vias):
+        topo = via * altura_via
+        for linha in range(altura_via):  # Linha na ordem da fita
+            y = topo + (altura_via - 1 - linha if de_baixo else linha)
+            invertida = da_direita != (serpentina and linha % 2 == 1)
+            for coluna in range(largura):
+                x = largura - 1 - coluna if invertida else coluna
+                indices[y * largura + x] = via * por_via + linha * largura + coluna
+    return indices
+
+
+def main():
+    saida = sys.argv[1]
+    largura, altura, vias = (int(v) for v in sys.argv[2:5])
+    origem = sys.argv[5]
+    serpentina = sys.argv[6] not in ("0", "OFF", "off", "FALSE", "false")
+
+    if origem not in ORIGENS:
+        sys.exit("origem desconhecida '%s' (use %s)" % (origem, ", ".join(ORIGENS)))
+    if not 1 <= vias <= MAX_VIAS or altura % vias:
+        sys.exit("a altura (%d) deve ser divisível pelo número de vias (1 a %d)" % (altura, MAX_VIAS))
+
+    indices = mapa(largura, altura, vias, origem, serpentina)
+    linhas = ["// Arquivo gerado por ferramentas/gerar_mapa_leds.py; não edite.",
+              "",
+              '#include "geometria.h"',
+              "",
+              "#if MATRIZ_LARGURA != %d || MATRIZ_ALTURA != %d || MATRIZ_VIAS != %d" % (largura, altura, vias),
+              '#error "mapa_leds.c foi gerado para outra geometria"',
+              "#endif",
+              "",
+              "// %dx%d, %d via(s), origem %s, %s" % (largura, altura, vias, origem,
+                                                       "serpentina" if serpentina else "progressiva"),
+              "const uint16_t mapa_leds[NUM_PIXELS] = {"]
+    for y in range(altura):
+        linhas.append("    " + ", ".join(str(v) for v in indices[y * largura:(y + 1) * largura]) + ",")
+    linhas.append("};")
+
+    with open(saida, "w", encoding="utf-8") as f:
+        f.write("\n".join(linhas) + "\n")
+
+
+if __name__ == "__main__":
+    main()
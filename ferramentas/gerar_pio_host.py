@@ -0,0 +1,337 @@
+#!/usr/bin/env python3
+"""Monta um programa .pio no cabeçalho que o pioasm geraria para o host.
+
+Na placa o Pico SDK roda o pioasm (pico_generate_pio_header); no computador
+(MATRIZ_HOST) não há SDK, então o CMake roda este script para que o emulador
+do PIO sempre execute as instruções do .pio atual. A saída tem o mesmo
+formato do pioasm, sem a parte c-sdk (que só existe na placa) e sem
+..._program_get_default_config: o emulador recebe a configuração de pinos
+direto de cada ferramenta.
+
+Cobre o conjunto de instruções do RP2040 (pio_version 0): jmp, wait, in, out,
+push, pull, mov, irq, set e nop, com atrasos, side-set (opt e pindirs),
+.define (public), rótulos (public), .wrap_target, .wrap e .origin.
+
+Uso: gerar_pio_host.py <entrada.pio> <saida.h>
+"""
+
+import os
+import re
+import sys
+
+CONDICOES_JMP = {"": 0, "!x": 1, "x--": 2, "!y": 3, "y--": 4, "x!=y": 5, "pin": 6, "!osre": 7}
+FONTES_IN = {"pins": 0, "x": 1, "y": 2, "null": 3, "isr": 6, "osr": 7}
+DESTINOS_OUT = {"pins": 0, "x": 1, "y": 2, "null": 3, "pindirs": 4, "pc": 5, "isr": 6, "exec": 7}
+DESTINOS_MOV = {"pins": 0, "x": 1, "y": 2, "exec": 4, "pc": 5, "isr": 6, "osr": 7}
+FONTES_MOV = {"pins": 0, "x": 1, "y": 2, "null": 3, "status": 5, "isr": 6, "osr": 7}
+DESTINOS_SET = {"pins": 0, "x": 1, "y": 2, "pindirs": 4}
+FONTES_WAIT = {"gpio": 0, "pin": 1, "irq": 2}
+
+# Nomes usados na desmontagem dos comentários, na grafia do pioasm
+NOMES_JMP = {0: "", 1: "!x", 2: "x--", 3: "!y", 4: "y--", 5: "x != y", 6: "pin", 7: "!osre"}
+
+
+class ErroPio(Exception):
+    pass
+
+
+class Programa:
+    def __init__(self, nome):
+        self.nome = nome
+        self.bits_sideset = 0
+        self.sideset_opcional = False
+        self.sideset_direcoes = False
+        self.origem = -1
+        self.inicio_wrap = None
+        self.fim_wrap = None
+        self.simbolos = {}
+        self.publicos = []  # (nome, valor) na ordem do arquivo
+        self.rotulos_publicos = []
+        self.linhas = []  # (número da linha, mnemônico, argumentos, lado, atraso)
+
+
+def avaliar(expressao, simbolos, linha):
+    # Só inteiros, símbolos e + - * / ( ); o resto é erro de sintaxe
+    def trocar(m):
+        nome = m.group(0)
+        if re.fullmatch(r"0[xX][0-9a-fA-F]+|0[bB][01]+|\d+", nome):
+            return str(int(nome, 0))
+        if nome not in simbolos:
+            raise ErroPio("linha %d: símbolo desconhecido '%s'" % (linha, nome))
+        return "(%d)" % simbolos[nome]
+
+    texto = re.sub(r"[A-Za-z_][A-Za-z0-9_]*|0[xX][0-9a-fA-F]+|0[bB][01]+|\d+", trocar, expressao)
+    if not re.fullmatch(r"[\d\s()+\-*/]*", texto) or not texto.strip():
+        raise ErroPio("linha %d: expressão inválida '%s'" % (linha, expressao))
+    return int(eval(texto.replace("/", "//")))
+
+
+def ler(caminho):
+    programas = []
+    atual = None
+    bloco = False
+    with open(caminho, encoding="utf-8") as f:
+        for numero, linha in enumerate(f, 1):
+            if bloco:
+                bloco = not linha.strip().startswith("%}")
+                continue
+            if linha.strip().startswith("%"):
+                bloco = True
+                continue
+            linha = re.split(r";|//", linha, 1)[0].strip()
+            if not linha:
+                continue
+
+            # Rótulos, com ou sem "public", antes da instrução da mesma linha
+            m = re.match(r"(public\s+)?([A-Za-z_][A-Za-z0-9_]*):\s*(.*)", linha)
+            if m:
+                if atual is None:
+                    raise ErroPio("linha %d: rótulo fora de um .program" % numero)
+                atual.simbolos[m.group(2)] = len(atual.linhas)
+                if m.group(1):
+                    atual.rotulos_publicos.append((m.group(2), len(atual.linhas)))
+                linha = m.group(3)
+                if not linha:
+                    continue
+
+            palavras = linha.split()
+            if palavras[0] == ".program":
+                atual = Programa(palavras[1])
+                programas.append(atual)
+            elif atual is None:
+                raise ErroPio("linha %d: '%s' fora de um .program" % (numero, palavras[0]))
+            elif palavras[0] == ".side_set":
+                atual.bits_sideset = int(palavras[1], 0)
+                atual.sideset_opcional = "opt" in palavras[2:]
+                atual.sideset_direcoes = "pindirs" in palavras[2:]
+            elif palavras[0] == ".define":
+                publico = palavras[1] == "public"
+                nome, expressao = palavras[2 if publico else 1], " ".join(palavras[3 if publico else 2:])
+                atual.simbolos[nome] = avaliar(expressao, atual.simbolos, numero)
+                if publico:
+                    atual.publicos.append((nome, atual.simbolos[nome]))
+            elif palavras[0] == ".wrap_target":
+                atual.inicio_wrap = len(atual.linhas)
+            elif palavras[0] == ".wrap":
+                atual.fim_wrap = len(atual.linhas) - 1
+            elif palavras[0] == ".origin":
+                atual.origem = avaliar(" ".join(palavras[1:]), atual.simbolos, numero)
+            elif palavras[0].startswith("."):
+                raise ErroPio("linha %d: diretiva não suportada %s" % (numero, palavras[0]))
+            else:
+                atual.linhas.append((numero,) + separar(linha, numero))
+    return programas
+
+
+def separar(linha, numero):
+    # Tira "[atraso]" e "side valor" do fim; o resto é mnemônico e argumentos
+    atraso = None
+    m = re.search(r"\[([^\]]*)\]\s*$", linha)
+    if m:
+        atraso = m.group(1)
+        linha = linha[:m.start()].strip()
+    lado = None
+    m = re.search(r"\s(side|sideset)\s+(\S+)\s*$", linha)
+    if m:
+        lado = m.group(2)
+        linha = linha[:m.start()].strip()
+    partes = linha.split(None, 1)
+    argumentos = [a.strip() for a in partes[1].split(",")] if len(partes) > 1 else []
+    return partes[0].lower(), argumentos, lado, atraso
+
+
+def codificar(programa, numero, mnemonico, argumentos, valor):
+    def arg(i):
+        if i >= len(argumentos):
+            raise ErroPio("linha %d: faltam argumentos em %s" % (numero, mnemonico))
+        return argumentos[i].lower()
+
+    def escolher(tabela, nome):
+        if nome not in tabela:
+            raise ErroPio("linha %d: operando inválido '%s' em %s" % (numero, nome, mnemonico))
+        return tabela[nome]
+
+    def contagem(i):
+        n = valor(argumentos[i])
+        if not 1 <= n <= 32:
+            raise ErroPio("linha %d: contagem de bits fora de 1 a 32" % numero)
+        return n & 31
+
+    if mnemonico == "nop":
+        return 0xA042
+    if mnemonico == "jmp":
+        # A vírgula entre a condição e o destino é opcional
+        m = re.fullmatch(r"(?:(!x|x--|!y|y--|x\s*!=\s*y|pin|!osre)(?:\s*,\s*|\s+))?(.+)", " ".join(argumentos))
+        condicao = "".join((m.group(1) or "").split())
+        return 0x0000 | escolher(CONDICOES_JMP, condicao) << 5 | valor(m.group(2))
+    if mnemonico == "wait":
+        partes = arg(0).split()
+        polaridade, fonte = int(partes[0]), partes[1]
+        indice = valor(" ".join(partes[2:]).replace(" rel", ""))
+        if fonte == "irq" and partes[-1] == "rel":
+            indice |= 0x10
+        return 0x2000 | polaridade << 7 | escolher(FONTES_WAIT, fonte) << 5 | indice
+    if mnemonico == "in":
+        return 0x4000 | escolher(FONTES_IN, arg(0)) << 5 | contagem(1)
+    if mnemonico == "out":
+        return 0x6000 | escolher(DESTINOS_OUT, arg(0)) << 5 | contagem(1)
+    if mnemonico in ("push", "pull"):
+        opcoes = " ".join(argumentos).lower().split()
+        condicional = ("iffull" if mnemonico == "push" else "ifempty") in opcoes
+        bloqueia = "noblock" not in opcoes
+        return 0x8000 | (mnemonico == "pull") << 7 | condicional << 6 | bloqueia << 5
+    if mnemonico == "mov":
+        fonte = arg(1).replace(" ", "")
+        operacao = 0
+        if fonte.startswith("::"):
+            operacao, fonte = 2, fonte[2:]
+        elif fonte[:1] in "!~":
+            operacao, fonte = 1, fonte[1:]
+        return 0xA000 | escolher(DESTINOS_MOV, arg(0)) << 5 | operacao << 3 | escolher(FONTES_MOV, fonte)
+    if mnemonico == "irq":
+        partes = " ".join(argumentos).lower().split()
+        modo = partes[0] if partes[0] in ("set", "nowait", "wait", "clear") else "set"
+        resto = [p for p in partes if p not in ("set", "nowait", "wait", "clear", "rel")]
+        indice = valor(" ".join(resto)) | (0x10 if "rel" in partes else 0)
+        return 0xC000 | (modo == "clear") << 6 | (modo == "wait") << 5 | indice
+    if mnemonico == "set":
+        dado = valor(argumentos[1])
+        if not 0 <= dado <= 31:
+            raise ErroPio("linha %d: valor do set fora de 0 a 31" % numero)
+        return 0xE000 | escolher(DESTINOS_SET, arg(0)) << 5 | dado
+    raise ErroPio("linha %d: instrução desconhecida '%s'" % (numero, mnemonico))
+
+
+def montar(programa):
+    # Campo de atraso/side-set (bits 12 a 8): bit de opcional, side-set e atraso
+    bits_lado = programa.bits_sideset + (1 if programa.sideset_opcional else 0)
+    bits_atraso = 5 - bits_lado
+    palavras = []
+    for numero, mnemonico, argumentos, lado, atraso in programa.linhas:
+        def valor(expressao):
+            return avaliar(expressao, programa.simbolos, numero)
+
+        instrucao = codificar(programa, numero, mnemonico, argumentos, valor)
+        campo = 0
+        if lado is not None:
+            if not programa.bits_sideset:
+                raise ErroPio("linha %d: side sem .side_set" % numero)
+            lado = valor(lado)
+            if lado >= 1 << programa.bits_sideset:
+                raise ErroPio("linha %d: side-set fora do limite" % numero)
+            campo |= lado << bits_atraso
+            if programa.sideset_opcional:
+                campo |= 1 << 4
+        elif programa.bits_sideset and not programa.sideset_opcional:
+            raise ErroPio("linha %d: side-set obrigatório" % numero)
+        if atraso is not None:
+            atraso = valor(atraso)
+            if not 0 <= atraso < 1 << bits_atraso:
+                raise ErroPio("linha %d: atraso fora de 0 a %d" % (numero, (1 << bits_atraso) - 1))
+            campo |= atraso
+        palavras.append(instrucao | campo << 8)
+    return palavras
+
+
+def desmontar(programa, instrucao):
+    # Mesmo texto dos comentários do pioasm
+    bits_lado = programa.bits_sideset + (1 if programa.sideset_opcional else 0)
+    bits_atraso = 5 - bits_lado
+    campo = instrucao >> 8 & 0x1F
+    atraso = campo & ((1 << bits_atraso) - 1)
+    lado = None
+    if programa.bits_sideset and (not programa.sideset_opcional or campo & 0x10):
+        lado = campo >> bits_atraso & ((1 << programa.bits_sideset) - 1)
+
+    codigo, a, b, c = instrucao >> 13, instrucao >> 5 & 7, instrucao >> 3 & 3, instrucao & 0x1F
+
+    def nome(tabela, chave):
+        return {v: k for k, v in tabela.items()}[chave]
+
+    if instrucao & 0xE0FF == 0xA042:
+        texto = "nop"
+    elif codigo == 0:
+        texto = "jmp    " + (NOMES_JMP[a] + ", " if a else "") + str(c)
+    elif codigo == 1:
+        fonte = nome(FONTES_WAIT, a & 3)
+        texto = "wait   %d %s %d" % (a >> 2, fonte, c & (0xF if fonte == "irq" else 0x1F))
+        if fonte == "irq" and c & 0x10:
+            texto += " rel"
+    elif codigo == 2:
+        texto = "in     %s, %d" % (nome(FONTES_IN, a), c or 32)
+    elif codigo == 3:
+        texto = "out    %s, %d" % (nome(DESTINOS_OUT, a), c or 32)
+    elif codigo == 4:
+        opcoes = []
+        if instrucao & 0x40:
+            opcoes.append("ifempty" if instrucao & 0x80 else "iffull")
+        opcoes.append("block" if instrucao & 0x20 else "noblock")
+        texto = ("pull   " if instrucao & 0x80 else "push   ") + " ".join(opcoes)
+    elif codigo == 5:
+        texto = "mov    %s, %s%s" % (nome(DESTINOS_MOV, a), ["", "!", "::", ""][b], nome(FONTES_MOV, instrucao & 7))
+    elif codigo == 6:
+        modo = "clear" if instrucao & 0x40 else "wait" if instrucao & 0x20 else "nowait"
+        texto = "irq    %s %d%s" % (modo, c & 0xF, " rel" if c & 0x10 else "")
+    else:
+        texto = "set    %s, %d" % (nome(DESTINOS_SET, a), c)
+
+    sufixo = ("side %d " % lado if lado is not None else "") + ("[%d]" % atraso if atraso else "")
+    return texto.ljust(23) + sufixo.strip() if sufixo else texto
+
+
+def escrever(caminho, entrada, programas):
+    nome_entrada = os.path.basename(entrada)
+    saida = [
+        "// Arquivo gerado por ferramentas/gerar_pio_host.py a partir de %s;" % nome_entrada,
+        "// não edite. É o cabeçalho do pioasm sem a parte c-sdk, que só existe",
+        "// na placa.",
+        "",
+        "#pragma once",
+        "",
+        '#include "hardware/pio.h"',
+        "",
+    ]
+    for programa in programas:
+        palavras = montar(programa)
+        if not palavras:
+            raise ErroPio("programa %s vazio" % programa.nome)
+        inicio = programa.inicio_wrap or 0
+        fim = len(palavras) - 1 if programa.fim_wrap is None else programa.fim_wrap
+        traco = "-" * len(programa.nome)
+        saida += ["// %s //" % traco, "// %s //" % programa.nome, "// %s //" % traco, ""]
+        saida += ["#define %s_wrap_target %d" % (programa.nome, inicio),
+                  "#define %s_wrap %d" % (programa.nome, fim),
+                  "#define %s_pio_version 0" % programa.nome, ""]
+        if programa.publicos:
+            saida += ["#define %s_%s %d" % (programa.nome, n, v) for n, v in programa.publicos] + [""]
+        if programa.rotulos_publicos:
+            saida += ["#define %s_offset_%s %du" % (programa.nome, n, v) for n, v in programa.rotulos_publicos]
+            saida.append("")
+        saida.append("static const uint16_t %s_program_instructions[] = {" % programa.nome)
+        for i, palavra in enumerate(palavras):
+            if i == inicio:
+                saida.append("            //     .wrap_target")
+            saida.append("    0x%04x, // %2d: %s" % (palavra, i, desmontar(programa, palavra)))
+            if i == fim:
+                saida.append("            //     .wrap")
+        saida += ["};", "",
+                  "static const struct pio_program %s_program = {" % programa.nome,
+                  "    .instructions = %s_program_instructions," % programa.nome,
+                  "    .length = %d," % len(palavras),
+                  "    .origin = %d," % programa.origem,
+                  "};", ""]
+    with open(caminho, "w", encoding="utf-8") as f:
+        f.write("\n".join(saida))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    try:
+        escrever(sys.argv[2], sys.argv[1], ler(sys.argv[1]))
+    except ErroPio as erro:
+        sys.exit("%s: %s" % (sys.argv[1], erro))
+
+
+if __name__ == "__main__":
+    main()
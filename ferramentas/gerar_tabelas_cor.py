@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Gera as tabelas de seno e de correção gama usadas pelas funções inline de
+cor.h (calcular_cor_rgb, intensidade_8_8 e onda_seno).
+
+Executado pelo CMake durante a compilação; a saída é um arquivo .c com as
+tabelas em flash, para que nenhuma conta em ponto flutuante seja feita no
+RP2040 (que não tem FPU).
+
+Uso: gerar_tabelas_cor.py <saida.c> [gama]
+"""
+
+import math
+import sys
+
+PASSOS_SENO = 256  # Entradas por volta completa (mais uma para interpolação)
+
+
+def tabela_seno():
+    # (sin(x) + 1) / 2 na escala de intensidade_t (0 a 65535)
+    return [int((math.sin(2 * math.pi * i / PASSOS_SENO) + 1) / 2 * 65535 + 0.5)
+            for i in range(PASSOS_SENO + 1)]
+
+
+def tabela_gama(gama):
+    return [int(math.pow(i / 255, gama) * 255 + 0.5) for i in range(256)]
+
+
+def formatar(valores, por_linha):
+    linhas = []
+    for i in range(0, len(valores), por_linha):
+        linhas.append("    " + ", ".join(str(v) for v in valores[i:i + por_linha]) + ",")
+    return "\n".join(linhas)
+
+
+def main():
+    saida = sys.argv[1]
+    gama = float(sys.argv[2]) if len(sys.argv) > 2 else 2.2
+
+    with open(saida, "w", encoding="utf-8") as f:
+        f.write("// Arquivo gerado por ferramentas/gerar_tabelas_cor.py; não edite.\n\n")
+        f.write('#include "cor.h"\n\n')
+        f.write("// (sin(2*pi*i/%d) + 1) / 2, em intensidade_t\n" % PASSOS_SENO)
+        f.write("const intensidade_t tabela_seno[%d] = {\n" % (PASSOS_SENO + 1))
+        f.write(formatar(tabela_seno(), 8))
+        f.write("\n};\n\n")
+        f.write("// Correção gama com expoente %.2f\n" % gama)
+        f.write("const uint8_t tabela_gama[256] = {\n")
+        f.write(formatar(tabela_gama(gama), 16))
+        f.write("\n};\n")
+
+
+if __name__ == "__main__":
+    main()
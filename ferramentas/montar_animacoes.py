@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""Monta animacoes.anim no bytecode executado por interpretador.c.
+
+Executado pelo CMake durante a compilação. Gera um cabeçalho com os
+descritores animacao_t dos programas e um .c com o código de cada um (em
+flash) e os estados de execução (em RAM). As cores e os glifos de glifos.txt
+podem ser importados com "glifos".
+
+Linguagem (uma instrução por linha, '#' inicia comentário):
+
+  glifos <arquivo>          Importa cores e sequências de glifos.txt
+  cor <nome> <r> <g> <b>    Define uma cor, intensidades de 0.0 a 1.0
+  animacao <nome>           Início de um programa
+  preencher <cor>           Todos os LEDs numa cor
+  mascara <cor> [valor]     Glifo 5x5: o valor (bit y * 5 + x) ou as 5 linhas seguintes
+  acender <cor> <x> <y>     Acende mais um LED na máscara atual
+  onda canais=<rgb> passo=<n|Xrad> [periodo=<n|pixels>] [divisor=<n|pixels>]
+       [fases=<r>,<g>,<b>]  Onda senoidal: fase do LED i no quadro t =
+                            ((t + i) mod periodo) * passo / divisor (um
+                            passo em radianos tem 16 bits de fração)
+  quadro [n]                Emite n quadros (padrão 1) com o desenho atual
+  repetir <n> ... fim       Repete o bloco n vezes
+  sequencia <nome>          Quadros estáticos de uma sequência de glifos.txt
+  revelacao <nome>          Revelações progressivas de glifos.txt
+
+Os registradores de cor são alocados pelo montador: cada programa carrega no
+início as cores que usa.
+
+Uso: montar_animacoes.py <animacoes.anim> <saida.h> <saida.c> [--resumo]
+"""
+
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gerar_glifos  # noqa: E402
+
+# Deve acompanhar o enum de interpretador.h
+OP_PALETA, OP_PREENCHER, OP_MASCARA, OP_ACENDER, OP_ONDA, OP_QUADRO, OP_REPETIR, OP_FIM = range(1, 9)
+REGISTRADORES = 8
+PROFUNDIDADE = 4
+NUM_PIXELS = 0xFFFF  # ONDA_NUM_PIXELS
+CANAIS = {"r": 1, "g": 2, "b": 4}
+ONDA_FRACAO = 8
+
+
+class ErroMontagem(Exception):
+    pass
+
+
+def intensidade(v):
+    """Mesmo valor que INTENSIDADE(x) em cor.h, com a precisão de gerar_glifos.py."""
+    return int(float("%.3f" % v) * 65535.0)
+
+
+def fase_radianos(x):
+    """Mesmo valor que FASE_RADIANOS(x) em cor.h."""
+    return int(x * 65536.0 / 6.283185307179586 + 0.5) & 0xFFFF
+
+
+def fase32_radianos(x):
+    """Mesmo valor que FASE32_RADIANOS(x) em cor.h."""
+    return int(x * 4294967296.0 / 6.283185307179586 + 0.5) & 0xFFFFFFFF
+
+
+class Programa:
+    def __init__(self, nome):
+        self.nome = nome
+        self.corpo = []      # Instruções: (op, bytes dos operandos)
+        self.cores = []      # Cores na ordem de alocação dos registradores
+        self.quadros = 0
+        self.lacos = []      # (quadros antes do laço, repetições)
+
+    def registrador(self, cor):
+        if cor not in self.cores:
+            if len(self.cores) == REGISTRADORES:
+                raise ErroMontagem("mais de %d cores em %s" % (REGISTRADORES, self.nome))
+            self.cores.append(cor)
+        return self.cores.index(cor)
+
+    def emitir(self, op, operandos=b""):
+        self.corpo.append((op, operandos))
+
+    def quadro(self, n):
+        self.quadros += n
+        while n > 0:  # Até 255 quadros por instrução
+            self.emitir(OP_QUADRO, bytes([min(n, 255)]))
+            n -= 255
+
+    def repetir(self, n):
+        if len(self.lacos) == PROFUNDIDADE:
+            raise ErroMontagem("mais de %d laços aninhados em %s" % (PROFUNDIDADE, self.nome))
+        if not 1 <= n <= 255:
+            raise ErroMontagem("'repetir' aceita de 1 a 255 repetições")
+        self.emitir(OP_REPETIR, bytes([n]))
+        self.lacos.append((self.quadros, n))
+
+    def fim(self):
+        if not self.lacos:
+            raise ErroMontagem("'fim' sem 'repetir' em %s" % self.nome)
+        antes, n = self.lacos.pop()
+        self.quadros = antes + (self.quadros - antes) * n
+        self.emitir(OP_FIM)
+
+    def codigo(self, paleta):
+        if self.lacos:
+            raise ErroMontagem("'repetir' sem 'fim' em %s" % self.nome)
+        codigo = bytearray()
+        for registrador, cor in enumerate(self.cores):
+            r, g, b = paleta[cor]
+            codigo += bytes([OP_PALETA, registrador]) + struct.pack(
+                "<HHH", intensidade(r), intensidade(g), intensidade(b))
+        for op, operandos in self.corpo:
+            codigo += bytes([op]) + operandos
+        return bytes(codigo)
+
+
+def numero(texto):
+    if texto == "pixels":
+        return NUM_PIXELS
+    if texto.endswith("rad"):
+        return fase_radianos(float(texto[:-3]))
+    return int(texto, 0)
+
+
+def onda(programa, argumentos):
+    opcoes = dict(a.split("=", 1) for a in argumentos)
+    canais = 0
+    for c in opcoes.pop("canais"):
+        canais |= CANAIS[c]
+    passo = opcoes.pop("passo")
+    periodo = numero(opcoes.pop("periodo", "0"))
+    divisor = numero(opcoes.pop("divisor", "1"))
+    if passo.endswith("rad"):
+        # Passo em radianos vai em fase32_t, para o erro não crescer com o LED
+        if divisor != 1:
+            raise ErroMontagem("passo em radianos não aceita divisor")
+        canais |= ONDA_FRACAO
+        passo = fase32_radianos(float(passo[:-3]))
+    else:
+        passo = numero(passo)
+    fases = [numero(f) for f in opcoes.pop("fases", "0,0,0").split(",")]
+    if opcoes:
+        raise ErroMontagem("opções desconhecidas em 'onda': %s" % ", ".join(opcoes))
+    programa.emitir(OP_ONDA, struct.pack("<BHIHHHH", canais, periodo, passo, divisor, *fases))
+
+
+def montar(caminho):
+    paleta = {}
+    blocos = {}
+    programas = []
+    with open(caminho, encoding="utf-8") as f:
+        linhas = [(n + 1, l.strip()) for n, l in enumerate(f)]
+
+    # As linhas de desenho de "mascara" são lidas inteiras; nas demais, '#'
+    # inicia um comentário
+    i = 0
+    while i < len(linhas):
+        num, texto = linhas[i]
+        texto = texto.split("#", 1)[0]
+        i += 1
+        if not texto.strip():
+            continue
+        partes = texto.split()
+        comando, argumentos = partes[0], partes[1:]
+        try:
+            if comando == "glifos":
+                cores, importados = gerar_glifos.ler(os.path.join(os.path.dirname(caminho), argumentos[0]))
+                for nome, (_, rgb) in cores.items():
+                    paleta[nome] = rgb
+                for tipo, nome, quadros in importados:
+                    blocos[nome] = (tipo, quadros)
+                continue
+            if comando == "cor":
+                paleta[argumentos[0]] = [float(v) for v in argumentos[1:4]]
+                continue
+            if comando == "animacao":
+                programas.append(Programa(argumentos[0]))
+                continue
+            if not programas:
+                raise ErroMontagem("instrução fora de 'animacao'")
+            programa = programas[-1]
+
+            for cor in argumentos[:1] if comando in ("preencher", "mascara", "acender") else []:
+                if cor not in paleta:
+                    raise ErroMontagem("cor desconhecida '%s'" % cor)
+
+            if comando == "preencher":
+                programa.emitir(OP_PREENCHER, bytes([programa.registrador(argumentos[0])]))
+            elif comando == "mascara":
+                if len(argumentos) > 1:
+                    valor = int(argumentos[1], 0)
+                else:
+                    desenho = [linhas[i + k][1] for k in range(gerar_glifos.ALTURA)]
+                    i += gerar_glifos.ALTURA
+                    valor = gerar_glifos.mascara(desenho)
+                programa.emitir(OP_MASCARA, struct.pack("<BI", programa.registrador(argumentos[0]), valor))
+            elif comando == "acender":
+                x, y = int(argumentos[1]), int(argumentos[2])
+                programa.emitir(OP_ACENDER, bytes([programa.registrador(argumentos[0]), gerar_glifos.posicao(x, y)]))
+            elif comando == "onda":
+                onda(programa, argumentos)
+            elif comando == "quadro":
+                programa.quadro(int(argumentos[0]) if argumentos else 1)
+            elif comando == "repetir":
+                programa.repetir(int(argumentos[0]))
+            elif comando == "fim":
+                programa.fim()
+            elif comando in ("sequencia", "revelacao") and blocos[argumentos[0]][0] != comando:
+                raise ErroMontagem("'%s' não é uma %s em glifos.txt" % (argumentos[0], comando))
+            elif comando == "sequencia":
+                tipo, quadros = blocos[argumentos[0]]
+                for cor, desenho in quadros:
+                    programa.emitir(OP_MASCARA, struct.pack("<BI", programa.registrador(cor),
+                                                            gerar_glifos.mascara(desenho)))
+                    programa.quadro(1)
+            elif comando == "revelacao":
+                tipo, quadros = blocos[argumentos[0]]
+                for cor, desenho in quadros:
+                    registrador = programa.registrador(cor)
+                    programa.emitir(OP_MASCARA, struct.pack("<BI", registrador, 0))
+                    for bit in gerar_glifos.ordem(desenho):
+                        programa.emitir(OP_ACENDER, bytes([registrador, bit]))
+                        programa.quadro(1)
+                    programa.quadro(1)  # Dígito completo
+            else:
+                raise ErroMontagem("instrução desconhecida '%s'" % comando)
+        except (ErroMontagem, gerar_glifos.ErroGlifo, KeyError, ValueError, IndexError, struct.error) as erro:
+            raise ErroMontagem("%s:%d: %s" % (caminho, num, erro))
+    return paleta, programas
+
+
+def main():
+    argumentos = [a for a in sys.argv[1:] if not a.startswith("--")]
+    entrada, saida_h, saida_c = argumentos[:3]
+    paleta, programas = montar(entrada)
+
+    origem = "// Arquivo gerado por ferramentas/montar_animacoes.py a partir de %s; não edite." % os.path.basename(entrada)
+    h = [origem, "", "#ifndef ANIMACOES_BYTECODE_H", "#define ANIMACOES_BYTECODE_H", "",
+         '#include "interpretador.h"', ""]
+    c = [origem, "", '#include "%s"' % os.path.basename(saida_h)]
+    total = 0
+    for programa in programas:
+        codigo = programa.codigo(paleta)
+        total += len(codigo)
+        nome = programa.nome
+        h.append("#define BYTECODE_%s_QUADROS %d" % (nome.upper(), programa.quadros))
+        h.append("extern const animacao_t bytecode_%s; // %d bytes" % (nome, len(codigo)))
+        c.append("")
+        c.append("static const uint8_t codigo_%s[%d] = {" % (nome, len(codigo)))
+        for k in range(0, len(codigo), 16):
+            c.append("    " + " ".join("0x%02x," % b for b in codigo[k:k + 16]))
+        c.append("};")
+        c.append("static estado_interpretador_t estados_%s[INTERPRETADOR_ESTADOS];" % nome)
+        c.append("static const programa_animacao_t programa_%s = {codigo_%s, sizeof(codigo_%s),"
+                 % (nome, nome, nome))
+        c.append("        estados_%s};" % nome)
+        c.append('const animacao_t bytecode_%s = {interpretador_desenhar, interpretador_desenhar16, &programa_%s,'
+                 % (nome, nome))
+        c.append('        BYTECODE_%s_QUADROS, "%s"};' % (nome.upper(), nome))
+    h.append("")
+    h.append("#define BYTECODE_TOTAL_BYTES %d // Soma do código de todos os programas" % total)
+    h.append("")
+    h.append("#endif")
+
+    with open(saida_h, "w", encoding="utf-8") as f:
+        f.write("\n".join(h) + "\n")
+    with open(saida_c, "w", encoding="utf-8") as f:
+        f.write("\n".join(c) + "\n")
+
+    if "--resumo" in sys.argv:
+        for programa in programas:
+            print("%-12s %4d quadros %5d bytes" % (programa.nome, programa.quadros, len(programa.codigo(paleta))))
+        print("total %d bytes" % total)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ErroMontagem as erro:
+        sys.exit(str(erro))
@@ -0,0 +1,26 @@
+#include "fim_envio.h"
+#include "saida_leds.h" // MATRIZ_LATCH_US
+
+void fim_envio_iniciar(fim_envio_t *fim) {
+    fim->paradas_limpas = false;
+    fim->vias_paradas = false;
+}
+
+fim_envio_acao_t fim_envio_passo(fim_envio_t *fim, bool dma_ocupado, bool vias_paradas, uint64_t agora_us) {
+    if (dma_ocupado) {
+        return FIM_ENVIO_OCUPADO;
+    }
+    // Marcas de antes deste ponto podem ser da espera pela primeira palavra
+    if (!fim->paradas_limpas) {
+        fim->paradas_limpas = true;
+        return FIM_ENVIO_LIMPAR_PARADAS;
+    }
+    if (!vias_paradas) {
+        return FIM_ENVIO_OCUPADO;
+    }
+    if (!fim->vias_paradas) {
+        fim->vias_paradas = true;
+        fim->paradas_us = agora_us;
+    }
+    return agora_us - fim->paradas_us < MATRIZ_LATCH_US ? FIM_ENVIO_OCUPADO : FIM_ENVIO_LIVRE;
+}
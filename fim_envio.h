@@ -0,0 +1,41 @@
+#ifndef FIM_ENVIO_H
+#define FIM_ENVIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// O que o transporte deve fazer depois de fim_envio_passo()
+typedef enum {
+    FIM_ENVIO_OCUPADO,        // Ainda transmitindo ou contando o latch
+    FIM_ENVIO_LIMPAR_PARADAS, // Limpar os TXSTALL das vias; continua ocupado
+    FIM_ENVIO_LIVRE,          // Quadro aplicado pela matriz, pode enviar outro
+} fim_envio_acao_t;
+
+// Decide quando um quadro enviado por DMA terminou de chegar à matriz. O
+// fim do DMA não basta: a FIFO e o OSR ainda guardam até 9 pixels. O
+// TXSTALL de cada máquina marca que ela parou sem dados, mas também fica
+// marcado enquanto ela espera a primeira palavra de um quadro, então só é
+// limpo depois do fim do DMA, quando a FIFO já tem o resto do quadro; a
+// próxima marcação é o fim do último bit e a partir dela conta o latch.
+// Só decide; quem lê e limpa os registradores é o transporte, e os
+// instantes vêm de fora, então a mesma lógica roda no emulador do host.
+typedef struct {
+    bool paradas_limpas;  // TXSTALL limpo depois do fim do DMA deste quadro
+    bool vias_paradas;    // Todas as vias já pararam depois da limpeza
+    uint64_t paradas_us;  // Instante em que pararam, início do latch
+} fim_envio_t;
+
+// Recomeça a espera para um quadro que acaba de ser disparado
+void fim_envio_iniciar(fim_envio_t *fim);
+
+// Função para acompanhar o envio em andamento
+// Parâmetros:
+// - fim: Estado do envio
+// - dma_ocupado: Algum canal de DMA das vias ainda transfere
+// - vias_paradas: Os TXSTALL de todas as vias estão marcados
+// - agora_us: Instante atual em microssegundos
+// Retorna:
+// - A ação do transporte (ver fim_envio_acao_t)
+fim_envio_acao_t fim_envio_passo(fim_envio_t *fim, bool dma_ocupado, bool vias_paradas, uint64_t agora_us);
+
+#endif
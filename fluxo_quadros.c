@@ -0,0 +1,136 @@
+#include "fluxo_quadros.h"
+
+#include <string.h>
+
+enum {
+    ESPERA_MAGICO_0,
+    ESPERA_MAGICO_1,
+    CABECALHO,
+    PIXELS,
+    CRC,
+};
+
+// CRC-16/CCITT processado meio byte por vez (tabela de 16 entradas)
+static uint16_t crc_byte(uint16_t crc, uint8_t byte) {
+    static const uint16_t tabela[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+        0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    };
+    crc = (crc << 4) ^ tabela[(crc >> 12) ^ (byte >> 4)];
+    crc = (crc << 4) ^ tabela[(crc >> 12) ^ (byte & 0x0F)];
+    return crc;
+}
+
+void fluxo_iniciar(fluxo_quadros_t *fluxo, saida_leds_t *saida) {
+    memset(fluxo, 0, sizeof(*fluxo));
+    fluxo->saida = saida;
+    fluxo->estado = ESPERA_MAGICO_0;
+}
+
+static uint16_t ler_16(const uint8_t *bytes) {
+    return bytes[0] | (bytes[1] << 8);
+}
+
+// Atualiza os contadores de perda e atraso com um quadro válido
+static void contabilizar(fluxo_quadros_t *fluxo, uint64_t agora_us) {
+    uint16_t sequencia = ler_16(&fluxo->cabecalho[2]);
+    uint8_t fps = fluxo->cabecalho[4];
+
+    if (!fluxo->sincronizado) {
+        fluxo->sincronizado = true;
+        fluxo->quadros_sequencia = 0;
+        fluxo->referencia_us = (int64_t)agora_us;
+    } else {
+        uint16_t pulados = sequencia - fluxo->proxima_sequencia;
+        fluxo->estatisticas.perdidos += pulados;
+        fluxo->quadros_sequencia += pulados + 1;
+    }
+    fluxo->proxima_sequencia = sequencia + 1;
+    fluxo->estatisticas.recebidos++;
+
+    if (fps == 0) {
+        return;
+    }
+
+    // A referência é a chegada mais adiantada já vista, projetada para o
+    // quadro 0; um quadro que chega mais de um período depois do seu lugar
+    // nessa linha está atrasado
+    int64_t periodo = 1000000 / fps;
+    int64_t esperado = (int64_t)fluxo->quadros_sequencia * periodo;
+    if ((int64_t)agora_us - esperado < fluxo->referencia_us) {
+        fluxo->referencia_us = (int64_t)agora_us - esperado;
+    }
+    if ((int64_t)agora_us > fluxo->referencia_us + esperado + periodo) {
+        fluxo->estatisticas.atrasados++;
+    }
+}
+
+void fluxo_receber(fluxo_quadros_t *fluxo, const uint8_t *dados, uint32_t quant, uint64_t agora_us) {
+    for (uint32_t i = 0; i < quant; i++) {
+        uint8_t byte = dados[i];
+
+        switch (fluxo->estado) {
+            case ESPERA_MAGICO_0:
+                if (byte == FLUXO_MAGICO_0) {
+                    fluxo->estado = ESPERA_MAGICO_1;
+                }
+                break;
+
+            case ESPERA_MAGICO_1:
+                if (byte == FLUXO_MAGICO_1) {
+                    fluxo->estado = CABECALHO;
+                    fluxo->posicao = 0;
+                    fluxo->crc = 0xFFFF;
+                } else if (byte != FLUXO_MAGICO_0) {
+                    fluxo->estado = ESPERA_MAGICO_0;
+                }
+                break;
+
+            case CABECALHO:
+                fluxo->cabecalho[fluxo->posicao++] = byte;
+                fluxo->crc = crc_byte(fluxo->crc, byte);
+                if (fluxo->posicao == FLUXO_TAMANHO_CABECALHO) {
+                    if (ler_16(fluxo->cabecalho) != NUM_PIXELS) {
+                        fluxo->estatisticas.corrompidos++;
+                        fluxo->estado = ESPERA_MAGICO_0;
+                        break;
+                    }
+                    fluxo->estado = PIXELS;
+                    fluxo->posicao = 0;
+                    fluxo->destino = saida_leds_quadro(fluxo->saida);
+                }
+                break;
+
+            case PIXELS:
+                // G, R, B chegam nessa ordem e vão para o formato da fita
+                fluxo->crc = crc_byte(fluxo->crc, byte);
+                fluxo->pixel = (fluxo->pixel << 8) | byte;
+                fluxo->posicao++;
+                if (fluxo->posicao % 3 == 0) {
+                    uint32_t g = fluxo->pixel >> 16, r = (fluxo->pixel >> 8) & 0xFF, b = fluxo->pixel & 0xFF;
+                    fluxo->destino[fluxo->posicao / 3 - 1] = empacotar_pixel(r, g, b);
+                    fluxo->pixel = 0;
+                    if (fluxo->posicao == NUM_PIXELS * 3) {
+                        fluxo->estado = CRC;
+                        fluxo->posicao = 0;
+                    }
+                }
+                break;
+
+            case CRC:
+                if (fluxo->posicao++ == 0) {
+                    fluxo->crc_recebido = byte;
+                    break;
+                }
+                fluxo->crc_recebido |= byte << 8;
+                fluxo->estado = ESPERA_MAGICO_0;
+                if (fluxo->crc_recebido != fluxo->crc) {
+                    fluxo->estatisticas.corrompidos++;
+                    break; // O quadro de desenho será sobrescrito pelo próximo
+                }
+                contabilizar(fluxo, agora_us);
+                saida_leds_apresentar(fluxo->saida);
+                break;
+        }
+    }
+}
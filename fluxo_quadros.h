@@ -0,0 +1,63 @@
+#ifndef FLUXO_QUADROS_H
+#define FLUXO_QUADROS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "saida_leds.h"
+
+// Protocolo de quadros enviados pelo computador (ferramentas/enviar_quadros.py):
+//
+//   'Q' 'D'                  início do quadro
+//   uint16 pixels            deve ser igual a NUM_PIXELS
+//   uint16 sequencia         incrementada a cada quadro, para detectar perdas
+//   uint8  fps               ritmo pretendido pelo emissor (0 = sem ritmo)
+//   uint8  reservado         0
+//   pixels x (G, R, B)       na ordem do framebuffer; convertidos ao receber
+//                            para o formato da fita (formato_pixel.h)
+//   uint16 crc               CRC-16/CCITT (0x1021, início 0xFFFF) de pixels até o último byte de cor
+//
+// Inteiros em little-endian.
+#define FLUXO_MAGICO_0 'Q'
+#define FLUXO_MAGICO_1 'D'
+#define FLUXO_TAMANHO_CABECALHO 6 // Depois dos dois bytes mágicos
+
+// Contadores do modo de recepção
+typedef struct {
+    uint32_t recebidos;    // Quadros válidos apresentados
+    uint32_t perdidos;     // Quadros que faltaram na sequência (inclui os corrompidos)
+    uint32_t corrompidos;  // CRC errado ou tamanho diferente de NUM_PIXELS
+    uint32_t atrasados;    // Chegaram mais de um período depois do esperado pelo fps
+} fluxo_estatisticas_t;
+
+// Receptor do protocolo. Os pixels são montados direto no quadro de desenho
+// da saída, sem buffer intermediário do quadro; quando o quadro termina com o
+// CRC certo ele é apresentado e o próximo passa a ser montado no outro buffer.
+typedef struct {
+    saida_leds_t *saida;
+    uint8_t estado;
+    uint8_t cabecalho[FLUXO_TAMANHO_CABECALHO];
+    uint32_t posicao;         // Bytes já recebidos na etapa atual
+    uint32_t *destino;        // Quadro de desenho em montagem
+    uint32_t pixel;           // Pixel em montagem
+    uint16_t crc;             // CRC calculado até aqui
+    uint16_t crc_recebido;
+
+    bool sincronizado;        // Já houve um quadro válido (sequência conhecida)
+    uint16_t proxima_sequencia;
+    uint32_t quadros_sequencia; // Quadros (inclusive perdidos) desde o primeiro válido
+    int64_t referencia_us;    // Chegada mais adiantada projetada para o quadro 0
+
+    fluxo_estatisticas_t estatisticas;
+} fluxo_quadros_t;
+
+// Inicializa o receptor, zerando os contadores
+void fluxo_iniciar(fluxo_quadros_t *fluxo, saida_leds_t *saida);
+
+// Processa bytes recebidos
+// Parâmetros:
+// - dados: Bytes na ordem em que chegaram
+// - quant: Quantidade de bytes
+// - agora_us: Instante da chegada, usado para detectar atrasos
+void fluxo_receber(fluxo_quadros_t *fluxo, const uint8_t *dados, uint32_t quant, uint64_t agora_us);
+
+#endif
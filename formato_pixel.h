@@ -0,0 +1,112 @@
+#ifndef FORMATO_PIXEL_H
+#define FORMATO_PIXEL_H
+
+#include <stdint.h>
+
+// Formato dos pixels enviados à fita, escolhido em compilação pelo CMake
+// (MATRIZ_ORDEM_CORES e MATRIZ_TEMPO_BITS). A palavra de 32 bits do
+// framebuffer já está na ordem em que os bits saem, do bit 31 para baixo,
+// então nem o DMA nem o PIO convertem nada; só as funções de empacotamento
+// abaixo, resolvidas pelo compilador, dependem da ordem.
+
+// Ordem dos canais na fita. Com branco (W) o pixel tem 32 bits; sem ele, 24
+// bits nos bits 31..8 e o byte baixo fica zero.
+#define ORDEM_GRB 0 // WS2812, WS2812B, SK6812
+#define ORDEM_RGB 1 // WS2811 e parte das fitas de 12 V
+#define ORDEM_BGR 2 // Alguns painéis APA106 e clones
+#define ORDEM_GRBW 3 // SK6812 RGBW
+#define ORDEM_RGBW 4
+
+#ifndef MATRIZ_ORDEM_CORES
+#define MATRIZ_ORDEM_CORES ORDEM_GRB
+#endif
+
+// Deslocamento de cada canal na palavra do pixel
+#if MATRIZ_ORDEM_CORES == ORDEM_GRB
+#define PIXEL_DESLOCAMENTO_G 24
+#define PIXEL_DESLOCAMENTO_R 16
+#define PIXEL_DESLOCAMENTO_B 8
+#define PIXEL_ORDEM_NOME "GRB"
+#elif MATRIZ_ORDEM_CORES == ORDEM_RGB
+#define PIXEL_DESLOCAMENTO_R 24
+#define PIXEL_DESLOCAMENTO_G 16
+#define PIXEL_DESLOCAMENTO_B 8
+#define PIXEL_ORDEM_NOME "RGB"
+#elif MATRIZ_ORDEM_CORES == ORDEM_BGR
+#define PIXEL_DESLOCAMENTO_B 24
+#define PIXEL_DESLOCAMENTO_G 16
+#define PIXEL_DESLOCAMENTO_R 8
+#define PIXEL_ORDEM_NOME "BGR"
+#elif MATRIZ_ORDEM_CORES == ORDEM_GRBW
+#define PIXEL_DESLOCAMENTO_G 24
+#define PIXEL_DESLOCAMENTO_R 16
+#define PIXEL_DESLOCAMENTO_B 8
+#define PIXEL_DESLOCAMENTO_W 0
+#define PIXEL_ORDEM_NOME "GRBW"
+#elif MATRIZ_ORDEM_CORES == ORDEM_RGBW
+#define PIXEL_DESLOCAMENTO_R 24
+#define PIXEL_DESLOCAMENTO_G 16
+#define PIXEL_DESLOCAMENTO_B 8
+#define PIXEL_DESLOCAMENTO_W 0
+#define PIXEL_ORDEM_NOME "RGBW"
+#else
+#error "MATRIZ_ORDEM_CORES deve ser ORDEM_GRB, ORDEM_RGB, ORDEM_BGR, ORDEM_GRBW ou ORDEM_RGBW"
+#endif
+
+#ifdef PIXEL_DESLOCAMENTO_W
+#define PIXEL_CANAIS 4
+#else
+#define PIXEL_CANAIS 3
+#endif
+#define PIXEL_BITS (PIXEL_CANAIS * 8)       // Bits enviados por pixel (limiar do autopull)
+#define PIXEL_BYTES PIXEL_CANAIS
+#define PIXEL_DESLOCAMENTO_MINIMO (32 - PIXEL_BITS) // Deslocamento do último canal enviado
+
+// Lê o canal de 8 bits no deslocamento "d" de um pixel
+#define PIXEL_CANAL(pixel, d) (((pixel) >> (d)) & 0xFFu)
+
+// Tempo dos bits. Os dois usam a máquina de estado a 8 MHz; o programa de
+// cada um (animacao_MatrizLED.pio) só muda os atrasos.
+#define TEMPO_800KHZ 0 // WS2812 e SK6812: 1,25 us por bit
+#define TEMPO_400KHZ 1 // WS2811 no modo lento: 2,5 us por bit
+
+#ifndef MATRIZ_TEMPO_BITS
+#define MATRIZ_TEMPO_BITS TEMPO_800KHZ
+#endif
+
+// Nome de um símbolo gerado pelo pioasm para o programa do tempo escolhido,
+// como PROGRAMA_LEDS(_program) ou PROGRAMA_LEDS(_T1)
+#if MATRIZ_TEMPO_BITS == TEMPO_800KHZ
+#define PROGRAMA_LEDS(simbolo) animacao_MatrizLED##simbolo
+#define PIXEL_TEMPO_NOME "800 kHz"
+#elif MATRIZ_TEMPO_BITS == TEMPO_400KHZ
+#define PROGRAMA_LEDS(simbolo) animacao_MatrizLED_400khz##simbolo
+#define PIXEL_TEMPO_NOME "400 kHz"
+#else
+#error "MATRIZ_TEMPO_BITS deve ser TEMPO_800KHZ ou TEMPO_400KHZ"
+#endif
+
+// Frequência da máquina de estado dos dois programas
+#define PIXEL_PIO_HZ 8000000
+
+// Função para empacotar uma cor de 8 bits por canal na palavra do pixel.
+// Com o canal branco, a parte comum aos três canais vai para o LED branco,
+// que dá o mesmo tom com menos consumo.
+// Parâmetros:
+// - r: Vermelho, de 0 a 255
+// - g: Verde, de 0 a 255
+// - b: Azul, de 0 a 255
+// Retorna:
+// - Palavra no formato do framebuffer
+static inline uint32_t empacotar_pixel(uint32_t r, uint32_t g, uint32_t b) {
+#if PIXEL_CANAIS == 4
+    uint32_t w = r < g ? r : g;
+    w = w < b ? w : b;
+    return (r - w) << PIXEL_DESLOCAMENTO_R | (g - w) << PIXEL_DESLOCAMENTO_G | (b - w) << PIXEL_DESLOCAMENTO_B |
+           w << PIXEL_DESLOCAMENTO_W;
+#else
+    return r << PIXEL_DESLOCAMENTO_R | g << PIXEL_DESLOCAMENTO_G | b << PIXEL_DESLOCAMENTO_B;
+#endif
+}
+
+#endif
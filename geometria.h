@@ -0,0 +1,35 @@
+#ifndef GEOMETRIA_H
+#define GEOMETRIA_H
+
+#include <stdint.h>
+
+// Dimensões da matriz lógica, vista de frente, e quantidade de vias (fitas
+// ligadas a saídas independentes, de 1 a 4). Os valores vêm do CMake, que
+// também gera mapa_leds.c para a mesma geometria.
+#ifndef MATRIZ_LARGURA
+#define MATRIZ_LARGURA 5
+#endif
+#ifndef MATRIZ_ALTURA
+#define MATRIZ_ALTURA 5
+#endif
+#ifndef MATRIZ_VIAS
+#define MATRIZ_VIAS 1
+#endif
+
+#define NUM_PIXELS (MATRIZ_LARGURA * MATRIZ_ALTURA) // Número total de LEDs na matriz
+#define PIXELS_POR_VIA (NUM_PIXELS / MATRIZ_VIAS)   // Trecho do framebuffer de cada via
+
+// Índice físico (posição no framebuffer) de cada pixel lógico y * MATRIZ_LARGURA + x.
+// O framebuffer fica na ordem das fitas: a via 0 ocupa os primeiros
+// PIXELS_POR_VIA pixels, a via 1 os seguintes, e assim por diante.
+extern const uint16_t mapa_leds[NUM_PIXELS];
+
+// Converte uma posição lógica no índice do LED no framebuffer
+// Parâmetros:
+// - x: Coluna, da esquerda para a direita
+// - y: Linha, de cima para baixo
+static inline uint16_t geometria_led(int x, int y) {
+    return mapa_leds[y * MATRIZ_LARGURA + x];
+}
+
+#endif
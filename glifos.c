@@ -0,0 +1,56 @@
+#include "glifos.h"
+
+#include "geometria.h"
+#include "saida_leds.h"
+
+#if MATRIZ_LARGURA < GLIFO_LARGURA || MATRIZ_ALTURA < GLIFO_ALTURA
+#error "a matriz precisa ter pelo menos o tamanho de um glifo"
+#endif
+
+uint32_t glifo_cor(uint8_t paleta) {
+    const cor_paleta_t *cor = &paleta_glifos[paleta];
+    return calcular_cor_rgb(cor->b, cor->r, cor->g);
+}
+
+void glifo_expandir(uint32_t *quadro, uint32_t mascara, uint32_t cor) {
+#if NUM_PIXELS > GLIFO_LARGURA * GLIFO_ALTURA
+    // Fora da área do glifo a matriz fica apagada
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = 0;
+    }
+#endif
+    for (int y = 0; y < GLIFO_ALTURA; y++) {
+        for (int x = 0; x < GLIFO_LARGURA; x++) {
+            quadro[geometria_led(x, y)] = (mascara & 1) ? cor : 0;
+            mascara >>= 1;
+        }
+    }
+}
+
+void glifo_desenhar(uint32_t *quadro, quadro_glifo_t glifo) {
+    glifo_expandir(quadro, GLIFO_MASCARA(glifo), glifo_cor(GLIFO_PALETA(glifo)));
+}
+
+cor16_t glifo_cor16(uint8_t paleta) {
+    const cor_paleta_t *cor = &paleta_glifos[paleta];
+    return calcular_cor16(cor->b, cor->r, cor->g);
+}
+
+void glifo_expandir16(cor16_t *quadro, uint32_t mascara, cor16_t cor) {
+    const cor16_t apagado = {0, 0};
+#if NUM_PIXELS > GLIFO_LARGURA * GLIFO_ALTURA
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = apagado;
+    }
+#endif
+    for (int y = 0; y < GLIFO_ALTURA; y++) {
+        for (int x = 0; x < GLIFO_LARGURA; x++) {
+            quadro[geometria_led(x, y)] = (mascara & 1) ? cor : apagado;
+            mascara >>= 1;
+        }
+    }
+}
+
+void glifo_desenhar16(cor16_t *quadro, quadro_glifo_t glifo) {
+    glifo_expandir16(quadro, GLIFO_MASCARA(glifo), glifo_cor16(GLIFO_PALETA(glifo)));
+}
@@ -0,0 +1,56 @@
+#ifndef GLIFOS_H
+#define GLIFOS_H
+
+#include <stdint.h>
+#include "cor.h"
+
+// Glifos têm 5x5 pixels e são desenhados no canto superior esquerdo da matriz
+#define GLIFO_LARGURA 5
+#define GLIFO_ALTURA 5
+
+// Quadro de glifo compacto: os bits 0..24 são a máscara de ocupação (bit
+// y * GLIFO_LARGURA + x aceso = pixel (x, y) aceso) e os bits 25..31 o índice
+// da cor na paleta.
+typedef uint32_t quadro_glifo_t;
+
+#define GLIFO_BITS_MASCARA 25
+#define GLIFO_MASCARA(q) ((q) & ((1u << GLIFO_BITS_MASCARA) - 1))
+#define GLIFO_PALETA(q) ((q) >> GLIFO_BITS_MASCARA)
+
+// Cor da paleta de glifos, nas mesmas intensidades de calcular_cor_rgb
+typedef struct {
+    intensidade_t r;
+    intensidade_t g;
+    intensidade_t b;
+} cor_paleta_t;
+
+// Revelação progressiva: os pixels de ordem[] (bits do glifo) acendem um a um, nessa ordem
+typedef struct {
+    const uint8_t *ordem;
+    uint8_t tamanho;
+    uint8_t paleta;
+} revelacao_glifo_t;
+
+// Paleta comum a todos os glifos (gerada a partir de glifos.txt)
+extern const cor_paleta_t paleta_glifos[];
+
+// Converte uma entrada da paleta no formato de calcular_cor_rgb
+uint32_t glifo_cor(uint8_t paleta);
+
+// Expande uma máscara de ocupação em pixels, passando pelo mapa da geometria
+// Parâmetros:
+// - quadro: Framebuffer de NUM_PIXELS posições
+// - mascara: Bit y * GLIFO_LARGURA + x aceso acende o pixel (x, y)
+// - cor: Cor dos pixels acesos; os demais LEDs da matriz ficam apagados
+void glifo_expandir(uint32_t *quadro, uint32_t mascara, uint32_t cor);
+
+// Desenha um quadro de glifo (máscara + cor da paleta) no framebuffer
+void glifo_desenhar(uint32_t *quadro, quadro_glifo_t glifo);
+
+// Versões de glifo_cor, glifo_expandir e glifo_desenhar para o quadro de
+// 8.8 bits por canal do pontilhamento temporal
+cor16_t glifo_cor16(uint8_t paleta);
+void glifo_expandir16(cor16_t *quadro, uint32_t mascara, cor16_t cor);
+void glifo_desenhar16(cor16_t *quadro, quadro_glifo_t glifo);
+
+#endif
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "animacoes.h"
+#include "escalonador.h"
+#include "pico/stdlib.h"
+#include "transporte_memoria.h"
+
+// Mede no computador o tempo por quadro e a taxa de pixels de
+// calcular_cor_rgb, configurar_alguns_leds (um LED a cada três da fita) e de
+// cada animação das teclas 1 a 7, na matriz desta compilação
+// (MATRIZ_LARGURA x MATRIZ_ALTURA). Cada animação é medida só desenhando ("desenhar") e pelo passo completo do
+// escalonador até a saída ("passo"). O envio vai para um quadro em memória
+// no lugar do PIO. Imprime CSV (caso, pixels, ns por quadro, pixels por
+// segundo); ferramentas/bancada_desempenho.py junta as medições de vários
+// tamanhos de matriz e compara com bancada/referencia.csv.
+//
+// Uso: bancada_desempenho [ms por lote]   (padrão: 10; vale o menor de 10 lotes)
+
+#define LOTES 10
+
+static const animacao_t *const animacoes[] = {
+    &animacao_1, &animacao_2, &animacao_3, &animacao_4, &animacao_5, &animacao_6, &animacao_7,
+};
+
+#define NUM_ANIMACOES (int)(sizeof(animacoes) / sizeof(animacoes[0]))
+
+// Sorvedouro em memória: guarda o quadro como o DMA o leria
+static transporte_memoria_t transporte;
+static saida_leds_t saida;
+static escalonador_t escalonador;
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+// Executa um quadro do caso; "n" conta os quadros já executados
+typedef void (*executar_t)(const animacao_t *animacao, uint32_t n);
+
+static void executar_cor(const animacao_t *animacao, uint32_t n) {
+    (void)animacao;
+    uint32_t *quadro = saida_leds_quadro(&saida);
+    for (uint32_t i = 0; i < NUM_PIXELS; i++) {
+        uint32_t v = (i + n) * 2654435761u; // Intensidades diferentes a cada pixel
+        quadro[i] = calcular_cor_rgb((intensidade_t)v, (intensidade_t)(v >> 8), (intensidade_t)(v >> 16));
+    }
+    transporte.base.enviar(&transporte.base, quadro, NUM_PIXELS);
+}
+
+// Um LED a cada PASSO_ALGUNS_LEDS na fita, para que o número de LEDs acesos
+// cresça com a matriz
+#define PASSO_ALGUNS_LEDS 3
+#define QUANT_ALGUNS_LEDS ((NUM_PIXELS + PASSO_ALGUNS_LEDS - 1) / PASSO_ALGUNS_LEDS)
+
+static int alguns_leds[QUANT_ALGUNS_LEDS]; // Preenchido em main()
+
+static void executar_alguns_leds(const animacao_t *animacao, uint32_t n) {
+    (void)animacao;
+    // Alterna a cor para a saída não suprimir o envio
+    intensidade_t nivel = (n & 1) ? INTENSIDADE(0.5) : INTENSIDADE(0.25);
+    configurar_alguns_leds(alguns_leds, QUANT_ALGUNS_LEDS, &saida, nivel, 0, nivel);
+}
+
+static void executar_desenhar(const animacao_t *animacao, uint32_t n) {
+    animacao->desenhar(animacao, saida_leds_quadro(&saida), (uint16_t)(n % animacao->quant_quadros));
+}
+
+// Um quadro pelo escalonador: o relógio virtual pula direto para o prazo, e
+// a animação recomeça quando termina
+static void executar_passo(const animacao_t *animacao, uint32_t n) {
+    (void)n;
+    do {
+        if (escalonador_concluido(&escalonador)) {
+            escalonador_tocar(&escalonador, animacao, FPS(10), time_us_64());
+        }
+        sleep_until(escalonador_prazo(&escalonador));
+    } while (!escalonador_passo(&escalonador, time_us_64()));
+}
+
+// Menor tempo por quadro entre LOTES lotes de pelo menos "ms_lote" cada
+static double medir(executar_t executar, const animacao_t *animacao, uint32_t ms_lote) {
+    uint32_t quadros = 1, n = 0;
+    double melhor = 0;
+
+    // Dobra os quadros por lote até o lote durar o pedido
+    while (true) {
+        uint64_t inicio = agora_ns();
+        for (uint32_t q = 0; q < quadros; q++) {
+            executar(animacao, n++);
+        }
+        if (agora_ns() - inicio >= (uint64_t)ms_lote * 1000000u) {
+            break;
+        }
+        quadros *= 2;
+    }
+
+    for (int lote = 0; lote < LOTES; lote++) {
+        uint64_t inicio = agora_ns();
+        for (uint32_t q = 0; q < quadros; q++) {
+            executar(animacao, n++);
+        }
+        double ns = (double)(agora_ns() - inicio) / quadros;
+        melhor = (lote == 0 || ns < melhor) ? ns : melhor;
+    }
+    return melhor;
+}
+
+static void imprimir(const char *caso, double ns) {
+    printf("%s,%d,%.1f,%.0f\n", caso, NUM_PIXELS, ns, NUM_PIXELS * 1e9 / ns);
+}
+
+int main(int argc, char **argv) {
+    uint32_t ms_lote = argc > 1 ? (uint32_t)atoi(argv[1]) : 10;
+    char caso[64];
+
+    ms_lote = ms_lote > 0 ? ms_lote : 1;
+    for (int j = 0; j < QUANT_ALGUNS_LEDS; j++) {
+        alguns_leds[j] = j * PASSO_ALGUNS_LEDS;
+    }
+    transporte_memoria_iniciar(&transporte, true);
+    saida_leds_iniciar(&saida, &transporte.base);
+    escalonador_iniciar(&escalonador, &saida);
+
+    printf("caso,pixels,ns_por_quadro,pixels_por_s\n");
+    imprimir("calcular_cor_rgb", medir(executar_cor, NULL, ms_lote));
+    imprimir("configurar_alguns_leds", medir(executar_alguns_leds, NULL, ms_lote));
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        snprintf(caso, sizeof(caso), "%s/desenhar", animacoes[a]->nome);
+        imprimir(caso, medir(executar_desenhar, animacoes[a], ms_lote));
+    }
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        escalonador_parar(&escalonador);
+        snprintf(caso, sizeof(caso), "%s/passo", animacoes[a]->nome);
+        imprimir(caso, medir(executar_passo, animacoes[a], ms_lote));
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "animacoes.h"
+#include "animacoes_bytecode.h"
+#include "geometria.h"
+#include "interpretador.h"
+
+// Confere no computador que os programas de animacoes.anim desenham os
+// mesmos quadros que as funções de animacoes.c, em 8 bits e em 8.8 bits,
+// pedindo os quadros em ordem, de trás para frente (o que obriga o
+// interpretador a reiniciar o programa) e alternando entre duas camadas em
+// pontos diferentes do mesmo programa, que não podem se reiniciar uma à
+// outra. Em seguida mede o tempo médio por quadro das duas versões. Termina
+// com erro se algum quadro diferir ou se as camadas se reiniciarem.
+//
+// Uso: comparar_bytecode [repeticoes]   (padrão: 200 passadas por animação)
+
+typedef struct {
+    const animacao_t *nativa;
+    const animacao_t *bytecode;
+} par_animacoes_t;
+
+static const par_animacoes_t pares[] = {
+    {&animacao_1, &bytecode_animacao_1},
+    {&animacao_2, &bytecode_animacao_2},
+    {&animacao_3, &bytecode_animacao_3},
+    {&animacao_4, &bytecode_animacao_4},
+    {&animacao_5, &bytecode_animacao_5},
+    {&animacao_6, &bytecode_animacao_6},
+    {&animacao_7, &bytecode_animacao_7},
+};
+
+#define NUM_PARES (int)(sizeof(pares) / sizeof(pares[0]))
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+// Compara o quadro "indice" das duas versões; retorna o número de pixels diferentes
+static int comparar_quadro(const par_animacoes_t *par, uint16_t indice) {
+    uint32_t nativo[NUM_PIXELS], interpretado[NUM_PIXELS];
+    cor16_t nativo16[NUM_PIXELS], interpretado16[NUM_PIXELS];
+    int diferentes = 0;
+
+    par->nativa->desenhar(par->nativa, nativo, indice);
+    par->bytecode->desenhar(par->bytecode, interpretado, indice);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (nativo[i] != interpretado[i]) {
+            if (diferentes++ == 0) {
+                printf("  %s quadro %u pixel %d: %08x (nativo) x %08x (bytecode)\n", par->nativa->nome,
+                       indice, i, (unsigned)nativo[i], (unsigned)interpretado[i]);
+            }
+        }
+    }
+
+    if (par->nativa->desenhar16) {
+        par->nativa->desenhar16(par->nativa, nativo16, indice);
+        par->bytecode->desenhar16(par->bytecode, interpretado16, indice);
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            if (nativo16[i].canais_1_3 != interpretado16[i].canais_1_3 ||
+                nativo16[i].canais_2_4 != interpretado16[i].canais_2_4) {
+                if (diferentes++ == 0) {
+                    printf("  %s quadro %u pixel %d em 8.8 bits difere\n", par->nativa->nome, indice, i);
+                }
+            }
+        }
+    }
+    return diferentes;
+}
+
+// Toca o programa em duas camadas ao mesmo tempo, a segunda começando no
+// meio da primeira, como num crossfade de uma tecla para ela mesma. Depois
+// do primeiro quadro de cada camada nenhum estado do programa pode voltar
+// atrás (um reinício). Retorna o número de pixels diferentes e de reinícios.
+static int conferir_camadas(const par_animacoes_t *par) {
+    const programa_animacao_t *programa = par->bytecode->dados;
+    uint16_t meio = par->nativa->quant_quadros / 2;
+    int diferentes = 0, reinicios = 0;
+
+    for (uint16_t k = 0; meio + k < par->nativa->quant_quadros; k++) {
+        for (int camada = 0; camada < 2; camada++) {
+            uint16_t emitidos[INTERPRETADOR_ESTADOS];
+            for (int e = 0; e < INTERPRETADOR_ESTADOS; e++) {
+                emitidos[e] = programa->estados[e].emitidos;
+            }
+            diferentes += comparar_quadro(par, (uint16_t)(camada ? k : meio + k));
+            for (int e = 0; k > 0 && e < INTERPRETADOR_ESTADOS; e++) {
+                reinicios += programa->estados[e].emitidos < emitidos[e];
+            }
+        }
+    }
+    if (reinicios) {
+        printf("  %s: %d reinicios com duas camadas\n", par->bytecode->nome, reinicios);
+    }
+    return diferentes + reinicios;
+}
+
+// Tempo médio por quadro, desenhando a animação inteira em ordem várias vezes
+static double medir_ns_por_quadro(const animacao_t *animacao, int repeticoes) {
+    static volatile uint32_t sorvedouro;
+    uint32_t quadro[NUM_PIXELS];
+    uint64_t inicio = agora_ns();
+    for (int r = 0; r < repeticoes; r++) {
+        for (uint16_t indice = 0; indice < animacao->quant_quadros; indice++) {
+            animacao->desenhar(animacao, quadro, indice);
+            sorvedouro += quadro[indice % NUM_PIXELS];
+        }
+    }
+    return (double)(agora_ns() - inicio) / ((double)repeticoes * animacao->quant_quadros);
+}
+
+int main(int argc, char **argv) {
+    int repeticoes = argc > 1 ? atoi(argv[1]) : 200;
+    int falhas = 0;
+
+    if (repeticoes < 1) {
+        repeticoes = 1;
+    }
+
+    printf("matriz %dx%d, bytecode %d bytes\n", MATRIZ_LARGURA, MATRIZ_ALTURA, BYTECODE_TOTAL_BYTES);
+    printf("%-12s %7s %12s %12s\n", "animacao", "quadros", "nativa ns", "bytecode ns");
+    for (int p = 0; p < NUM_PARES; p++) {
+        const par_animacoes_t *par = &pares[p];
+        int diferentes = 0;
+
+        if (par->nativa->quant_quadros != par->bytecode->quant_quadros) {
+            printf("  %s: %u quadros (nativa) x %u (bytecode)\n", par->nativa->nome,
+                   par->nativa->quant_quadros, par->bytecode->quant_quadros);
+            falhas++;
+            continue;
+        }
+        for (uint16_t indice = 0; indice < par->nativa->quant_quadros; indice++) {
+            diferentes += comparar_quadro(par, indice);
+        }
+        for (uint16_t indice = par->nativa->quant_quadros; indice-- > 0;) {
+            diferentes += comparar_quadro(par, indice);
+        }
+        diferentes += conferir_camadas(par);
+        falhas += diferentes != 0;
+
+        printf("%-12s %7u %12.1f %12.1f%s\n", par->nativa->nome, par->nativa->quant_quadros,
+               medir_ns_por_quadro(par->nativa, repeticoes), medir_ns_por_quadro(par->bytecode, repeticoes),
+               diferentes ? "  DIFERENTE" : "");
+    }
+
+    if (falhas) {
+        printf("%d animações com quadros diferentes ou reinícios\n", falhas);
+        return 1;
+    }
+    printf("todos os quadros iguais\n");
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "animacoes.h"
+#include "cor.h"
+#include "cor_referencia.h"
+
+// Confere no computador as animações 2 e 5 em ponto fixo (tabela de seno e
+// calcular_cor_rgb de cor.h) contra o cálculo original em double de
+// cor_referencia.c: em todos os quadros de cada uma, nenhum canal pode
+// diferir mais que 1 LSB. O branco das fitas RGBW é somado de volta aos
+// canais antes da comparação. Termina com erro se algum canal passar disso.
+//
+// Sem argumentos. A correção gama (MATRIZ_CORRECAO_GAMA) muda o caminho em
+// ponto fixo de propósito, então a conferência não vale com ela ligada.
+
+#if MATRIZ_CORRECAO_GAMA
+#error "a referencia em double de cor_referencia.c nao tem correcao gama"
+#endif
+
+// Canal "deslocamento" do pixel com o branco somado de volta
+static int canal(uint32_t pixel, int deslocamento) {
+#if PIXEL_CANAIS == 4
+    return (int)(PIXEL_CANAL(pixel, deslocamento) + PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_W));
+#else
+    return (int)PIXEL_CANAL(pixel, deslocamento);
+#endif
+}
+
+// Função para comparar uma animação com a sua referência em double
+// Parâmetros:
+// - animacao: Animação em ponto fixo
+// - referencia: Mesmo desenho em double (cor_referencia.h)
+// Retorna:
+// - Número de canais que diferem mais de 1 LSB
+static int conferir(const animacao_t *animacao, void (*referencia)(uint32_t *, int, int)) {
+    static const int deslocamentos[3] = {PIXEL_DESLOCAMENTO_R, PIXEL_DESLOCAMENTO_G, PIXEL_DESLOCAMENTO_B};
+    uint32_t obtido[NUM_PIXELS], esperado[NUM_PIXELS];
+    int maior = 0, iguais = 0, um_lsb = 0, fora = 0;
+
+    for (uint16_t frame = 0; frame < animacao->quant_quadros; frame++) {
+        animacao->desenhar(animacao, obtido, frame);
+        referencia(esperado, NUM_PIXELS, frame);
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            for (int c = 0; c < 3; c++) {
+                int diferenca = abs(canal(obtido[i], deslocamentos[c]) - canal(esperado[i], deslocamentos[c]));
+                maior = diferenca > maior ? diferenca : maior;
+                if (diferenca == 0) {
+                    iguais++;
+                } else if (diferenca == 1) {
+                    um_lsb++;
+                } else if (fora++ < 5) {
+                    printf("  %s quadro %u led %d: %06lx em ponto fixo, %06lx em double\n", animacao->nome, frame,
+                           i, (unsigned long)obtido[i], (unsigned long)esperado[i]);
+                }
+            }
+        }
+    }
+    printf("%s: %u quadros, %d canais iguais, %d a 1 LSB, %d acima (maior diferenca %d)\n", animacao->nome,
+           animacao->quant_quadros, iguais, um_lsb, fora, maior);
+    return fora;
+}
+
+int main(void) {
+    printf("matriz %dx%d, cores %s\n", MATRIZ_LARGURA, MATRIZ_ALTURA, PIXEL_ORDEM_NOME);
+    int fora = conferir(&animacao_2, referencia_animacao_2);
+    fora += conferir(&animacao_5, referencia_animacao_5);
+    if (fora) {
+        printf("%d canais diferem mais de 1 LSB\n", fora);
+        return 1;
+    }
+    printf("tudo confere\n");
+    return 0;
+}
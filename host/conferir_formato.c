@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include "animacao_MatrizLED.pio.h"
+#include "formato_pixel.h"
+#include "pio_emulador.h"
+
+// Passa pixels empacotados por empacotar_pixel() pelos dois programas de
+// animacao_MatrizLED.pio no emulador do PIO e mede a forma de onda do pino:
+// largura dos pulsos de 0 e de 1 e período de cada bit, contra as janelas
+// das folhas de dados. Decodifica os bits de volta e confere os bytes na
+// ordem das letras de PIXEL_ORDEM_NOME (com o branco extraído quando há W)
+// e que o pino fica baixo com a FIFO vazia. É compilado uma vez por ordem
+// das cores (conferir_formato_grb, _rgbw...). Termina com erro se algo
+// sair da janela ou diferir.
+//
+// Uso: conferir_formato_<ordem>
+
+// Nanossegundos por ciclo da máquina a PIXEL_PIO_HZ
+#define NS_POR_CICLO (1000000000 / PIXEL_PIO_HZ)
+
+// Ciclos em nível baixo conferidos depois do último bit
+#define CICLOS_OCIOSO 400
+
+typedef struct {
+    const char *nome;
+    const pio_program_t *programa;
+    uint8_t inicio_wrap, fim_wrap;
+    uint32_t t1, t2;                       // Atrasos públicos do programa
+    uint32_t alto_zero_min, alto_zero_max; // T0H em ns
+    uint32_t alto_um_min, alto_um_max;     // T1H em ns
+    uint32_t periodo;                      // Período de cada bit em ns
+} tempo_t;
+
+// WS2812 (±150 ns) e WS2811 no modo lento (±150 ns)
+static const tempo_t tempos[] = {
+    {"800 kHz", &animacao_MatrizLED_program, animacao_MatrizLED_wrap_target, animacao_MatrizLED_wrap,
+     animacao_MatrizLED_T1, animacao_MatrizLED_T2, 200, 500, 550, 850, 1250},
+    {"400 kHz", &animacao_MatrizLED_400khz_program, animacao_MatrizLED_400khz_wrap_target,
+     animacao_MatrizLED_400khz_wrap, animacao_MatrizLED_400khz_T1, animacao_MatrizLED_400khz_T2, 350, 650, 1050,
+     1350, 2500},
+};
+
+// Cores de teste: canais puros, mistos e com parte comum para o branco
+static const uint8_t cores[][3] = {
+    {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {0x12, 0x34, 0x56}, {200, 100, 50},
+    {255, 255, 255}, {0, 0, 0}, {0x80, 0x01, 0xFE}, {0x40, 0x40, 0xC0},
+};
+#define NUM_CORES (int)(sizeof(cores) / sizeof(cores[0]))
+
+// Bytes que a fita deve receber para a cor, montados só das letras do nome
+// da ordem, sem as macros de deslocamento
+static void bytes_esperados(const uint8_t *cor, uint8_t *bytes) {
+    uint8_t r = cor[0], g = cor[1], b = cor[2], w = 0;
+    if (PIXEL_CANAIS == 4) {
+        w = r < g ? r : g;
+        w = w < b ? w : b;
+    }
+    for (int i = 0; i < PIXEL_BYTES; i++) {
+        switch (PIXEL_ORDEM_NOME[i]) {
+            case 'R': bytes[i] = r - w; break;
+            case 'G': bytes[i] = g - w; break;
+            case 'B': bytes[i] = b - w; break;
+            default: bytes[i] = w; break;
+        }
+    }
+}
+
+typedef struct {
+    uint32_t alto_zero_min, alto_zero_max;
+    uint32_t alto_um_min, alto_um_max;
+    uint32_t periodo_min, periodo_max;
+    uint32_t bits;
+    uint8_t bytes[NUM_CORES * PIXEL_BYTES];
+} medida_t;
+
+static void acumular(uint32_t *minimo, uint32_t *maximo, uint32_t valor) {
+    *minimo = valor < *minimo ? valor : *minimo;
+    *maximo = valor > *maximo ? valor : *maximo;
+}
+
+// Executa o programa com todas as cores e mede cada pulso em ciclos
+// Retorna:
+// - false se a máquina encontrou instrução não suportada ou o pino subiu
+//   depois do último bit
+static bool medir(const tempo_t *tempo, medida_t *medida) {
+    static pio_emulador_t pio;
+    pio_emulador_iniciar(&pio, tempo->programa, tempo->inicio_wrap, tempo->fim_wrap, PIXEL_BITS);
+    pio_emulador_configurar_pinos(&pio, 0, 1, 0, 0, 1, false, false);
+
+    *medida = (medida_t){.alto_zero_min = UINT32_MAX, .alto_um_min = UINT32_MAX, .periodo_min = UINT32_MAX};
+    uint32_t limiar = tempo->t1 + tempo->t2 / 2; // Ciclos altos que separam 0 (T1) de 1 (T1 + T2)
+    uint32_t alto = 0, ciclos_bit = 0, ultima_descida = 0;
+    bool anterior = false;
+    int colocados = 0;
+    uint32_t desde_ultimo_bit = 0;
+
+    while (desde_ultimo_bit < CICLOS_OCIOSO && !pio.erro) {
+        if (colocados < NUM_CORES &&
+            pio_emulador_colocar(&pio, empacotar_pixel(cores[colocados][0], cores[colocados][1], cores[colocados][2]))) {
+            colocados++;
+        }
+        pio_emulador_ciclo(&pio);
+        bool pino = pio.pinos & 1;
+
+        if (pino && !anterior) {
+            if (medida->bits) {
+                acumular(&medida->periodo_min, &medida->periodo_max, ciclos_bit);
+            }
+            ciclos_bit = 0;
+            alto = 0;
+        }
+        if (!pino && anterior) {
+            // A largura do pulso define o bit
+            bool um = alto > limiar;
+            if (um) {
+                acumular(&medida->alto_um_min, &medida->alto_um_max, alto);
+            } else {
+                acumular(&medida->alto_zero_min, &medida->alto_zero_max, alto);
+            }
+            uint32_t byte = medida->bits / 8;
+            if (byte < sizeof(medida->bytes)) {
+                medida->bytes[byte] = (uint8_t)(medida->bytes[byte] << 1 | um);
+            }
+            medida->bits++;
+            ultima_descida = (uint32_t)pio.ciclo;
+        }
+        alto += pino;
+        ciclos_bit++;
+        anterior = pino;
+        if (colocados == NUM_CORES && medida->bits == NUM_CORES * PIXEL_BITS) {
+            desde_ultimo_bit = (uint32_t)pio.ciclo - ultima_descida;
+            if (pino) {
+                return false; // Subida com a FIFO vazia
+            }
+        }
+    }
+    return !pio.erro && pio_emulador_ocioso(&pio);
+}
+
+static bool dentro(uint32_t minimo, uint32_t maximo, uint32_t janela_min, uint32_t janela_max) {
+    return minimo * NS_POR_CICLO >= janela_min && maximo * NS_POR_CICLO <= janela_max;
+}
+
+int main(void) {
+    int falhas = 0;
+
+    printf("ordem %s: %d canais, %d bits por pixel, empacotar_pixel(0x12, 0x34, 0x56) = %08lx\n", PIXEL_ORDEM_NOME,
+           PIXEL_CANAIS, PIXEL_BITS, (unsigned long)empacotar_pixel(0x12, 0x34, 0x56));
+
+    for (size_t t = 0; t < sizeof(tempos) / sizeof(tempos[0]); t++) {
+        const tempo_t *tempo = &tempos[t];
+        medida_t medida;
+        bool ocioso = medir(tempo, &medida);
+
+        uint8_t esperados[NUM_CORES * PIXEL_BYTES];
+        for (int c = 0; c < NUM_CORES; c++) {
+            bytes_esperados(cores[c], &esperados[c * PIXEL_BYTES]);
+        }
+        int bytes_errados = 0;
+        for (int i = 0; i < NUM_CORES * PIXEL_BYTES; i++) {
+            bytes_errados += medida.bytes[i] != esperados[i];
+        }
+
+        bool zero_ok = dentro(medida.alto_zero_min, medida.alto_zero_max, tempo->alto_zero_min, tempo->alto_zero_max);
+        bool um_ok = dentro(medida.alto_um_min, medida.alto_um_max, tempo->alto_um_min, tempo->alto_um_max);
+        bool periodo_ok = dentro(medida.periodo_min, medida.periodo_max, tempo->periodo, tempo->periodo);
+        bool ok = zero_ok && um_ok && periodo_ok && ocioso && !bytes_errados &&
+                  medida.bits == NUM_CORES * PIXEL_BITS;
+
+        printf("%s%s: T0H %lu ns [%lu, %lu]%s, T1H %lu ns [%lu, %lu]%s, período %lu a %lu ns%s\n", tempo->nome,
+               tempo->programa == &PROGRAMA_LEDS(_program) ? " (compilado)" : "",
+               (unsigned long)(medida.alto_zero_max * NS_POR_CICLO), (unsigned long)tempo->alto_zero_min,
+               (unsigned long)tempo->alto_zero_max, zero_ok ? "" : " FORA",
+               (unsigned long)(medida.alto_um_max * NS_POR_CICLO), (unsigned long)tempo->alto_um_min,
+               (unsigned long)tempo->alto_um_max, um_ok ? "" : " FORA",
+               (unsigned long)(medida.periodo_min * NS_POR_CICLO), (unsigned long)(medida.periodo_max * NS_POR_CICLO),
+               periodo_ok ? "" : " FORA");
+        printf("  %d pixels, %lu bits decodificados, %d byte(s) fora da ordem %s, pino %s com a FIFO vazia%s\n",
+               NUM_CORES, (unsigned long)medida.bits, bytes_errados, PIXEL_ORDEM_NOME, ocioso ? "baixo" : "ALTO",
+               ok ? "" : "  FALHOU");
+        falhas += !ok;
+    }
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "formato_pixel.h"
+#include "pico/stdlib.h"
+#include "saida_leds.h"
+#include "transporte_emulado.h"
+
+// Confere o fim de quadro do transporte por DMA (fim_envio.h) no emulador:
+// apresenta quadros diferentes um atrás do outro, sem intervalo, como as
+// renovações do pontilhamento, com o DMA emulado entregando as palavras às
+// FIFOs e o TXSTALL das máquinas emulado. Cada quadro deve chegar inteiro e
+// separado do seguinte por pelo menos MATRIZ_LATCH_US em nível baixo; um
+// quadro que emenda no anterior aparece como pixels excedentes. Termina com
+// erro se algo diferir.
+//
+// Uso: conferir_latch [quadros]   (padrão: 200)
+
+static void desenhar(uint32_t *quadro, int n) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        quadro[i] = empacotar_pixel((uint32_t)(n * 7 + i) & 0xFF, (uint32_t)i & 0xFF, (uint32_t)(255 - n) & 0xFF);
+    }
+}
+
+int main(int argc, char **argv) {
+    int quadros = argc > 1 ? atoi(argv[1]) : 200;
+    static transporte_emulado_t transporte;
+    static saida_leds_t saida;
+    uint32_t esperado[NUM_PIXELS];
+    int diferentes = 0;
+
+    transporte_emulado_iniciar_dma(&transporte);
+    saida_leds_iniciar(&saida, &transporte.base);
+
+    for (int n = 0; n < quadros; n++) {
+        desenhar(saida_leds_quadro(&saida), n);
+        saida_leds_apresentar(&saida); // Espera o quadro anterior e o latch
+        if (n > 0) {
+            // O anterior já terminou: a matriz tem o quadro n - 1 inteiro
+            desenhar(esperado, n - 1);
+            diferentes += memcmp(esperado, transporte.quadro, sizeof(esperado)) != 0;
+        }
+    }
+    while (transporte.base.ocupado(&transporte.base)) {
+    }
+    desenhar(esperado, quadros - 1);
+    diferentes += memcmp(esperado, transporte.quadro, sizeof(esperado)) != 0;
+
+    uint32_t menor_latch_us = transporte.menor_latch_ciclos / EMULADOR_CICLOS_POR_US;
+    printf("%d quadros apresentados, %lu decodificados, %d diferentes, pixels excedentes %lu, "
+           "pulsos inválidos %lu, bits fora do período %lu\n",
+           quadros, (unsigned long)transporte.quadros, diferentes, (unsigned long)transporte.pixels_excedentes,
+           (unsigned long)transporte.pulsos_invalidos, (unsigned long)transporte.bits_fora_periodo);
+    printf("menor intervalo entre quadros: %lu us (latch pedido %d us)\n", (unsigned long)menor_latch_us,
+           MATRIZ_LATCH_US);
+
+    bool ok = transporte.quadros == (uint32_t)quadros && !diferentes && !transporte.pixels_excedentes &&
+              !transporte.pulsos_invalidos && !transporte.bits_fora_periodo && !transporte.erro &&
+              transporte.menor_latch_ciclos >= MATRIZ_LATCH_US * EMULADOR_CICLOS_POR_US;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "acoes.h"
+#include "geometria.h"
+#include "sprite.h"
+#include "texto.h"
+
+// Confere no computador o motor de sprites e o texto rolante da tecla 9:
+// sprite_desenhar() contra uma cópia pixel a pixel em posições, janelas e
+// recortes sorteados (inclusive fora da tela), a tabela da fonte, o
+// deslocamento de uma coluna entre quadros seguidos do texto rolante e os
+// comandos t, v e k do console. Em seguida mede o tempo por quadro do texto
+// rolante. Termina com erro se alguma conferência falhar.
+//
+// Uso: conferir_texto [casos]   (padrão: 20000 cópias sorteadas)
+
+// Bitmap de teste largo o bastante para várias palavras por linha
+#define SPRITE_LARGURA 100
+#define SPRITE_ALTURA 7
+#define SPRITE_PALAVRAS ((SPRITE_LARGURA + 31) / 32)
+
+static int falhas;
+
+static void falhar(const char *mensagem) {
+    if (falhas < 10) {
+        printf("  falha: %s\n", mensagem);
+    }
+    falhas++;
+}
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static int sortear(int minimo, int maximo) {
+    return minimo + rand() % (maximo - minimo + 1);
+}
+
+static bool ler_bit(const uint32_t *linha, int x) {
+    return (linha[x >> 5] >> (31 - (x & 31))) & 1;
+}
+
+// Cópia de referência: um pixel por vez, com todos os recortes testados
+static void desenhar_referencia(tela_t *tela, const janela_t *janela, const bitmap_t *sprite, int origem_x,
+                                int largura, int x, int y) {
+    for (int sy = 0; sy < sprite->altura; sy++) {
+        for (int coluna = 0; coluna < largura; coluna++) {
+            int sx = origem_x + coluna;
+            int jx = x + coluna, jy = y + sy;
+            int tx = janela->x + jx, ty = janela->y + jy;
+            if (sx < 0 || sx >= sprite->largura || jx < 0 || jx >= janela->largura || jy < 0 ||
+                jy >= janela->altura || tx < 0 || tx >= MATRIZ_LARGURA || ty < 0 || ty >= MATRIZ_ALTURA) {
+                continue;
+            }
+            if (ler_bit(sprite->bits + sy * sprite->palavras, sx)) {
+                tela->linhas[ty][tx >> 5] |= 0x80000000u >> (tx & 31);
+            }
+        }
+    }
+}
+
+static void conferir_sprites(int casos) {
+    static uint32_t bits[SPRITE_ALTURA * SPRITE_PALAVRAS];
+    for (int i = 0; i < SPRITE_ALTURA * SPRITE_PALAVRAS; i++) {
+        bits[i] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+    }
+    // Os bits sorteados depois da última coluna não podem aparecer
+    const bitmap_t sprite = {bits, SPRITE_LARGURA, SPRITE_ALTURA, SPRITE_PALAVRAS};
+
+    int diferentes = 0;
+    for (int caso = 0; caso < casos; caso++) {
+        janela_t janela = {(int16_t)sortear(-8, MATRIZ_LARGURA), (int16_t)sortear(-4, MATRIZ_ALTURA),
+                           (int16_t)sortear(0, MATRIZ_LARGURA + 8), (int16_t)sortear(0, MATRIZ_ALTURA + 4)};
+        int origem_x = sortear(-8, SPRITE_LARGURA + 8);
+        int largura = sortear(0, 70);
+        int x = sortear(-40, MATRIZ_LARGURA + 8);
+        int y = sortear(-SPRITE_ALTURA, MATRIZ_ALTURA + 2);
+
+        // Metade dos casos parte de uma tela com pixels acesos, já que a cópia só acende
+        tela_t obtida, esperada;
+        tela_limpar(&obtida);
+        if (caso & 1) {
+            for (int ty = 0; ty < MATRIZ_ALTURA; ty++) {
+                for (int tx = 0; tx < MATRIZ_LARGURA; tx++) {
+                    if (rand() % 5 == 0) {
+                        obtida.linhas[ty][tx >> 5] |= 0x80000000u >> (tx & 31);
+                    }
+                }
+            }
+        }
+        esperada = obtida;
+        sprite_desenhar(&obtida, &janela, &sprite, origem_x, largura, x, y);
+        desenhar_referencia(&esperada, &janela, &sprite, origem_x, largura, x, y);
+        if (memcmp(&obtida, &esperada, sizeof(obtida)) != 0) {
+            if (diferentes++ < 5) {
+                printf("  janela (%d, %d, %d, %d), origem %d, largura %d, posicao (%d, %d)\n", janela.x, janela.y,
+                       janela.largura, janela.altura, origem_x, largura, x, y);
+            }
+        }
+    }
+    printf("sprites: %d copias sorteadas, %d diferentes\n", casos, diferentes);
+    if (diferentes) {
+        falhar("sprite_desenhar difere da copia pixel a pixel");
+    }
+}
+
+static bool mesmo_glifo(char a, char b) {
+    return fonte_glifo(a)->x == fonte_glifo(b)->x && fonte_glifo(a)->largura == fonte_glifo(b)->largura;
+}
+
+static void conferir_fonte(void) {
+    for (int c = FONTE_PRIMEIRO; c < FONTE_PRIMEIRO + FONTE_CARACTERES; c++) {
+        const glifo_fonte_t *glifo = fonte_glifo((char)c);
+        if (glifo->largura < 1 || glifo->largura > 8 || glifo->x + glifo->largura > fonte_bitmap.largura) {
+            falhar("caractere fora do atlas");
+        }
+    }
+    if (!mesmo_glifo('a', 'A') || !mesmo_glifo('\n', '?') || !mesmo_glifo((char)0xC3, '?')) {
+        falhar("minusculas ou caracteres sem desenho");
+    }
+    const glifo_fonte_t *a = fonte_glifo('A'), *i = fonte_glifo('I');
+    if (texto_largura("") != 0 || texto_largura("AI") != (uint32_t)(a->largura + FONTE_ESPACAMENTO + i->largura)) {
+        falhar("texto_largura");
+    }
+    printf("fonte: %u colunas no atlas, %d caracteres\n", (unsigned)fonte_bitmap.largura, FONTE_CARACTERES);
+}
+
+static bool pixel_aceso(const uint32_t *quadro, int x, int y) {
+    return quadro[geometria_led(x, y)] != 0;
+}
+
+// Cada quadro é o anterior deslocado uma coluna para a esquerda, com a
+// primeira coluna do texto entrando pela borda direita no quadro 0
+static void conferir_rolagem(texto_rolante_t *texto) {
+    const animacao_t *animacao = &texto->animacao;
+    uint32_t anterior[NUM_PIXELS], atual[NUM_PIXELS];
+    int errados = 0;
+
+    if (animacao->quant_quadros != texto_largura(texto->texto) + MATRIZ_LARGURA) {
+        falhar("numero de quadros do texto rolante");
+    }
+    for (uint16_t indice = 0; indice < animacao->quant_quadros; indice++) {
+        animacao->desenhar(animacao, atual, indice);
+        for (int y = 0; y < MATRIZ_ALTURA; y++) {
+            // A última coluna é a que entra, vinda do atlas (conferido pelos sprites)
+            for (int x = 0; x + 1 < MATRIZ_LARGURA; x++) {
+                bool esperado = indice && pixel_aceso(anterior, x + 1, y);
+                errados += pixel_aceso(atual, x, y) != esperado;
+            }
+        }
+        memcpy(anterior, atual, sizeof(atual));
+    }
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        errados += anterior[i] != 0; // O último quadro fica vazio
+    }
+    printf("rolagem: %u quadros, %d pixels fora do lugar\n", animacao->quant_quadros, errados);
+    if (errados) {
+        falhar("quadros do texto rolante");
+    }
+}
+
+static void conferir_comandos(texto_rolante_t *texto) {
+    static const struct {
+        char comando;
+        const char *argumento;
+        bool aceito;
+    } casos[] = {
+        {'v', "12.5", true}, {'v', "0", false},   {'v', "1001", false},    {'v', "", false},
+        {'v', ".", false},   {'v', "3x", false},  {'k', "FF8000", true},   {'k', "ff80", false},
+        {'k', "GG0000", false}, {'k', "FF80001", false}, {'x', "1", false}, {'t', "OLA 123", true},
+    };
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); c++) {
+        if (texto_rolante_comando(texto, casos[c].comando, casos[c].argumento) != casos[c].aceito) {
+            printf("  %c \"%s\"\n", casos[c].comando, casos[c].argumento);
+            falhar("resultado de um comando de texto");
+        }
+    }
+    if (texto->mili_fps != 12500 || texto->r != 65535 || texto->g != 0x80 * 257 || texto->b != 0 ||
+        strcmp(texto->texto, "OLA 123") != 0) {
+        falhar("valores aplicados pelos comandos de texto");
+    }
+
+    // Texto maior que o limite é cortado
+    char longo[MATRIZ_TEXTO_MAX + 20];
+    memset(longo, 'A', sizeof(longo) - 1);
+    longo[sizeof(longo) - 1] = '\0';
+    texto_rolante_definir(texto, longo);
+    if (strlen(texto->texto) != MATRIZ_TEXTO_MAX) {
+        falhar("texto longo nao foi cortado");
+    }
+    printf("comandos: %d casos\n", (int)(sizeof(casos) / sizeof(casos[0])));
+}
+
+int main(int argc, char **argv) {
+    int casos = argc > 1 ? atoi(argv[1]) : 20000;
+    srand(1);
+
+    printf("matriz %dx%d, %d palavras por linha\n", MATRIZ_LARGURA, MATRIZ_ALTURA, TELA_PALAVRAS);
+    conferir_sprites(casos);
+    conferir_fonte();
+
+    // O mesmo texto da tecla 9 (acoes_texto() traria o escalonador junto)
+    texto_rolante_t padrao;
+    texto_rolante_t *texto = &padrao;
+    texto_rolante_iniciar(texto, MATRIZ_TEXTO, 0, INTENSIDADE(0.5), INTENSIDADE(0.5), FPS_TEXTO);
+    conferir_rolagem(texto);
+
+    // Tempo por quadro do texto padrão da tecla 9
+    uint32_t quadro[NUM_PIXELS];
+    int passadas = 200;
+    uint64_t inicio = agora_ns();
+    for (int p = 0; p < passadas; p++) {
+        for (uint16_t indice = 0; indice < texto->animacao.quant_quadros; indice++) {
+            texto->animacao.desenhar(&texto->animacao, quadro, indice);
+        }
+    }
+    double ns = (double)(agora_ns() - inicio) / ((double)passadas * texto->animacao.quant_quadros);
+    printf("texto rolante: \"%s\", %.1f ns/quadro\n", texto->texto, ns);
+
+    texto_rolante_t outro;
+    texto_rolante_iniciar(&outro, "", 0, 0, 0, FPS(1));
+    conferir_comandos(&outro);
+    conferir_rolagem(&outro);
+
+    if (falhas) {
+        printf("%d conferencias falharam\n", falhas);
+        return 1;
+    }
+    printf("tudo confere\n");
+    return 0;
+}
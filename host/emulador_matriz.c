@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "acoes.h"
+#include "escalonador.h"
+#include "geometria.h"
+#include "instrumentacao.h"
+#include "pico/stdlib.h"
+#include "pontilhamento.h"
+#include "saida_leds.h"
+#include "transporte_emulado.h"
+
+// Executa no computador as animações de cada tecla, passando cada quadro pelo
+// emulador do programa animacao_MatrizLED, e imprime os quadros decodificados
+// da forma de onda. Termina com erro se algum quadro decodificado diferir do
+// framebuffer enviado ou se a temporização dos bits fugir do protocolo.
+//
+// Com MATRIZ_PONTILHAMENTO os quadros de conteúdo não são impressos: cada
+// renovação é conferida contra o quadro enviado, e a média das renovações
+// de cada quadro de conteúdo é comparada com o valor em 8.8 bits.
+//
+// Com -g cada tecla começa com a matriz apagada e os quadros decodificados
+// são comparados com os de referência em <diretorio>/tecla_<nome>.txt (um
+// arquivo por tecla, como em host/quadros_referencia/); -G grava esses
+// arquivos. Os quadros de referência são em RGB, com o canal branco somado
+// de volta, então servem para qualquer ordem de cores e tempo dos bits, mas
+// só na geometria em que foram gravados (as animações 2 e 5 andam pela
+// ordem da fita) e sem o pontilhamento.
+//
+// Uso: emulador_matriz [-g diretorio | -G diretorio] [teclas]
+//      (padrão: todas as teclas do teclado)
+
+#define TECLAS_PADRAO "0123456789ABCD#*"
+
+// Texto de um quadro: uma linha da matriz por linha, RRGGBB por pixel
+#define TAMANHO_TEXTO_QUADRO (MATRIZ_ALTURA * MATRIZ_LARGURA * 7 + 1)
+
+// Quadros decodificados de uma tecla, no formato dos arquivos de referência
+typedef struct {
+    char *texto;
+    size_t tamanho;
+    size_t capacidade;
+} texto_quadros_t;
+
+static void acrescentar(texto_quadros_t *quadros, const char *trecho) {
+    size_t tamanho = strlen(trecho);
+    if (quadros->tamanho + tamanho + 1 > quadros->capacidade) {
+        quadros->capacidade = (quadros->tamanho + tamanho + 1) * 2;
+        quadros->texto = realloc(quadros->texto, quadros->capacidade);
+    }
+    memcpy(quadros->texto + quadros->tamanho, trecho, tamanho + 1);
+    quadros->tamanho += tamanho;
+}
+
+#if !MATRIZ_PONTILHAMENTO
+// Escreve o quadro em RGB; com o canal branco, a parte comum que
+// empacotar_pixel() tirou dos três canais volta para eles
+static void formatar_quadro(char *destino, const uint32_t *pixels) {
+    for (int y = 0; y < MATRIZ_ALTURA; y++) {
+        for (int x = 0; x < MATRIZ_LARGURA; x++) {
+            uint32_t pixel = pixels[geometria_led(x, y)];
+#if PIXEL_CANAIS == 4
+            uint32_t w = PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_W);
+#else
+            uint32_t w = 0;
+#endif
+            destino += sprintf(destino, "%02x%02x%02x%c", (unsigned)(PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_R) + w),
+                               (unsigned)(PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_G) + w),
+                               (unsigned)(PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_B) + w),
+                               x + 1 < MATRIZ_LARGURA ? ' ' : '\n');
+        }
+    }
+}
+#endif
+
+// Caminho do arquivo de referência de uma tecla
+static void caminho_referencia(char *caminho, size_t tamanho, const char *diretorio, char tecla) {
+    const char *nome = tecla == '#' ? "cerquilha" : tecla == '*' ? "asterisco" : NULL;
+    if (nome) {
+        snprintf(caminho, tamanho, "%s/tecla_%s.txt", diretorio, nome);
+    } else {
+        snprintf(caminho, tamanho, "%s/tecla_%c.txt", diretorio, tecla);
+    }
+}
+
+// Imprime o quadro que começa na posição inicio do texto
+static void imprimir_trecho(const texto_quadros_t *quadros, size_t inicio) {
+    if (inicio >= quadros->tamanho) {
+        printf("(fim dos quadros)\n");
+        return;
+    }
+    const char *proximo = strstr(quadros->texto + inicio + 1, "\nquadro ");
+    size_t fim = proximo ? (size_t)(proximo - quadros->texto) + 1 : quadros->tamanho;
+    printf("%.*s", (int)(fim - inicio), quadros->texto + inicio);
+}
+
+// Grava (gravar) ou compara com o arquivo de referência os quadros de uma tecla
+// Retorna:
+// - false se o arquivo não abrir ou os quadros diferirem
+static bool referencia_tecla(const char *diretorio, bool gravar, char tecla, const texto_quadros_t *obtidos) {
+    char caminho[512];
+    caminho_referencia(caminho, sizeof(caminho), diretorio, tecla);
+    FILE *arquivo = fopen(caminho, gravar ? "w" : "r");
+    if (!arquivo) {
+        perror(caminho);
+        return false;
+    }
+    if (gravar) {
+        fwrite(obtidos->texto, 1, obtidos->tamanho, arquivo);
+        fclose(arquivo);
+        return true;
+    }
+
+    texto_quadros_t esperados = {0};
+    char bloco[4096];
+    size_t lidos;
+    acrescentar(&esperados, "");
+    while ((lidos = fread(bloco, 1, sizeof(bloco) - 1, arquivo)) > 0) {
+        bloco[lidos] = '\0';
+        acrescentar(&esperados, bloco);
+    }
+    fclose(arquivo);
+
+    // Mostra o primeiro quadro diferente
+    size_t i = 0;
+    while (i < esperados.tamanho && i < obtidos->tamanho && esperados.texto[i] == obtidos->texto[i]) {
+        i++;
+    }
+    bool igual = i == esperados.tamanho && i == obtidos->tamanho;
+    if (!igual) {
+        size_t inicio = i;
+        while (inicio > 0 && strncmp(obtidos->texto + inicio, "quadro ", 7) != 0) {
+            inicio--;
+        }
+        printf("  DIFERENTE de %s\n  esperado:\n", caminho);
+        imprimir_trecho(&esperados, inicio);
+        printf("  obtido:\n");
+        imprimir_trecho(obtidos, inicio);
+    }
+    free(esperados.texto);
+    return igual;
+}
+
+#if !MATRIZ_PONTILHAMENTO
+static void imprimir_quadro(const uint32_t *pixels) {
+    for (int y = 0; y < MATRIZ_ALTURA; y++) {
+        for (int x = 0; x < MATRIZ_LARGURA; x++) {
+            uint32_t pixel = pixels[geometria_led(x, y)];
+            printf("%s%02x%02x%02x", x ? " " : "  ", (unsigned)PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_R),
+                   (unsigned)PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_G),
+                   (unsigned)PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_B));
+#if PIXEL_CANAIS == 4
+            printf("%02x", (unsigned)PIXEL_CANAL(pixel, PIXEL_DESLOCAMENTO_W));
+#endif
+        }
+        printf("\n");
+    }
+}
+#endif
+
+#if MATRIZ_PONTILHAMENTO
+// Média das renovações decodificadas de um quadro de conteúdo
+typedef struct {
+    cor16_t conteudo[NUM_PIXELS];
+    uint32_t soma[NUM_PIXELS][PIXEL_CANAIS]; // Na ordem da fita
+    uint32_t renovacoes;
+    uint32_t maior_desvio;     // Maior |média - conteúdo|, em 1/256 do passo de 8 bits
+    uint32_t maior_truncamento; // Maior fração descartada sem pontilhamento, na mesma unidade
+} media_renovacoes_t;
+
+static void acumular_renovacao(media_renovacoes_t *media, const uint32_t *decodificado) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        for (int c = 0; c < PIXEL_CANAIS; c++) {
+            media->soma[i][c] += PIXEL_CANAL(decodificado[i], 24 - 8 * c);
+        }
+    }
+    media->renovacoes++;
+}
+
+// Compara a média acumulada com o conteúdo e recomeça com um novo conteúdo
+static void fechar_media(media_renovacoes_t *media, const cor16_t *novo) {
+    if (media->renovacoes) {
+        for (int i = 0; i < NUM_PIXELS; i++) {
+            uint32_t valores[4] = {media->conteudo[i].canais_1_3 >> 16, media->conteudo[i].canais_2_4 >> 16,
+                                   media->conteudo[i].canais_1_3 & 0xFFFF, media->conteudo[i].canais_2_4 & 0xFFFF};
+            for (int c = 0; c < PIXEL_CANAIS; c++) {
+                uint32_t media_8_8 = media->soma[i][c] * 256 / media->renovacoes;
+                uint32_t desvio = media_8_8 > valores[c] ? media_8_8 - valores[c] : valores[c] - media_8_8;
+                media->maior_desvio = desvio > media->maior_desvio ? desvio : media->maior_desvio;
+                uint32_t truncamento = valores[c] & 0xFF;
+                media->maior_truncamento = truncamento > media->maior_truncamento ? truncamento
+                                                                                    : media->maior_truncamento;
+            }
+        }
+    }
+    memcpy(media->conteudo, novo, sizeof(media->conteudo));
+    memset(media->soma, 0, sizeof(media->soma));
+    media->renovacoes = 0;
+}
+#endif
+
+int main(int argc, char **argv) {
+    const char *teclas = TECLAS_PADRAO;
+    const char *referencias = NULL; // Diretório dos quadros de referência
+    bool gravar = false;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "-G") == 0) && i + 1 < argc) {
+            gravar = argv[i][1] == 'G';
+            referencias = argv[++i];
+        } else {
+            teclas = argv[i];
+        }
+    }
+#if MATRIZ_PONTILHAMENTO
+    if (referencias) {
+        printf("os quadros de referência não valem com o pontilhamento\n");
+        return 2;
+    }
+#endif
+    static transporte_emulado_t transporte;
+    static saida_leds_t saida;
+    static escalonador_t escalonador;
+    int falhas = 0;
+
+    transporte_emulado_iniciar(&transporte);
+    saida_leds_iniciar(&saida, &transporte.base);
+    escalonador_iniciar(&escalonador, &saida);
+#if MATRIZ_PONTILHAMENTO
+    static pontilhamento_t pontilhamento;
+    static media_renovacoes_t media;
+    pontilhamento_iniciar(&pontilhamento, &saida, FPS(MATRIZ_PONTILHAMENTO_HZ));
+    escalonador.pontilhamento = &pontilhamento;
+#endif
+
+    for (const char *tecla = teclas; *tecla; tecla++) {
+        texto_quadros_t obtidos = {0};
+        acrescentar(&obtidos, "");
+        if (referencias) {
+            // Como numa placa recém-ligada: a tecla 0 soma sobre o que está na matriz
+            saida_leds_iniciar(&saida, &transporte.base);
+            escalonador_iniciar(&escalonador, &saida);
+        }
+
+        printf("tecla %c\n", *tecla);
+        executar_acao_tecla(*tecla, &escalonador, time_us_64());
+        if (escalonador_concluido(&escalonador)) {
+            printf("  sem animação\n");
+            if (referencias && !referencia_tecla(referencias, gravar, *tecla, &obtidos)) {
+                falhas++;
+            }
+            free(obtidos.texto);
+            continue;
+        }
+
+        // Camada da animação da tecla (a tecla 0 toca numa sobreposição)
+        const faixa_t *faixa = &escalonador.faixas[CAMADA_FUNDO];
+        for (int c = COMPOSITOR_CAMADAS - 1; c > CAMADA_FUNDO; c--) {
+            faixa = escalonador.faixas[c].animacao ? &escalonador.faixas[c] : faixa;
+        }
+        int quadro = 0;
+        uint64_t primeiro = 0, ultimo = 0;
+        uint32_t perdidos = escalonador.prazos_perdidos;
+#if MATRIZ_PONTILHAMENTO
+        media.maior_desvio = 0;
+        media.maior_truncamento = 0;
+#endif
+        while (!escalonador_concluido(&escalonador)) {
+            uint64_t instante = time_us_64();
+            uint32_t suprimidos = saida.estatisticas.suprimidos;
+            if (escalonador_passo(&escalonador, instante)) {
+#if MATRIZ_PONTILHAMENTO
+                // O conteúdo só troca de buffer; quem chega à matriz são as renovações
+                (void)suprimidos;
+                fechar_media(&media, pontilhamento.buffers[pontilhamento.desenho ^ 1].pixels);
+                quadro++;
+#else
+                // O buffer da frente é sempre o último quadro na matriz
+                const uint32_t *enviado = saida.buffers[saida.desenho ^ 1].pixels;
+                bool igual = memcmp(enviado, transporte.quadro, sizeof(transporte.quadro)) == 0;
+                printf("quadro %d (t = %llu us)%s%s\n", quadro++, (unsigned long long)instante,
+                       saida.estatisticas.suprimidos != suprimidos ? " repetido, não enviado" : "",
+                       igual ? "" : " DIVERGENTE");
+                imprimir_quadro(transporte.quadro);
+                falhas += !igual;
+                char texto[TAMANHO_TEXTO_QUADRO + 16];
+                int cabecalho = sprintf(texto, "quadro %d\n", quadro - 1);
+                formatar_quadro(texto + cabecalho, transporte.quadro);
+                acrescentar(&obtidos, texto);
+#endif
+                primeiro = quadro == 1 ? instante : primeiro;
+                ultimo = instante;
+            }
+            uint64_t prazo = escalonador_prazo(&escalonador);
+#if MATRIZ_PONTILHAMENTO
+            if (pontilhamento_passo(&pontilhamento, time_us_64())) {
+                const uint32_t *enviado = saida.buffers[saida.desenho ^ 1].pixels;
+                falhas += memcmp(enviado, transporte.quadro, sizeof(transporte.quadro)) != 0;
+                acumular_renovacao(&media, transporte.quadro);
+            }
+            uint64_t renovar = pontilhamento_prazo(&pontilhamento);
+            prazo = renovar < prazo ? renovar : prazo;
+#endif
+            if (prazo != UINT64_MAX) {
+                sleep_until(prazo);
+            }
+        }
+
+        // Taxa medida entre o primeiro e o último quadro, contra a pedida
+        if (quadro > 1) {
+            uint32_t pedida = faixa->relogio.mili_fps;
+            uint32_t medida = (uint32_t)((uint64_t)(quadro - 1) * 1000000000u / (ultimo - primeiro));
+            perdidos = escalonador.prazos_perdidos - perdidos;
+            printf("  fps pedido %lu.%03lu, medido %lu.%03lu, prazos perdidos %lu\n",
+                   (unsigned long)(pedida / 1000), (unsigned long)(pedida % 1000),
+                   (unsigned long)(medida / 1000), (unsigned long)(medida % 1000), (unsigned long)perdidos);
+            falhas += medida + 1 < pedida || medida > pedida + 1 || perdidos; // Tolera o arredondamento em us
+        }
+#if MATRIZ_PONTILHAMENTO
+        fechar_media(&media, media.conteudo);
+        printf("  média das renovações: desvio máximo %lu/256, sem pontilhamento %lu/256\n",
+               (unsigned long)media.maior_desvio, (unsigned long)media.maior_truncamento);
+#endif
+        if (referencias && !referencia_tecla(referencias, gravar, *tecla, &obtidos)) {
+            falhas++;
+        }
+        free(obtidos.texto);
+    }
+
+    printf("quadros decodificados: %lu, pulsos inválidos: %lu, bits fora do período: %lu, "
+           "pixels excedentes: %lu, ciclos parados: %llu%s\n",
+           (unsigned long)transporte.quadros, (unsigned long)transporte.pulsos_invalidos,
+           (unsigned long)transporte.bits_fora_periodo, (unsigned long)transporte.pixels_excedentes,
+           (unsigned long long)transporte.ciclos_parados, transporte.erro ? ", instrução não suportada" : "");
+    printf("quadros apresentados: %lu, enviados: %lu, suprimidos: %lu\n",
+           (unsigned long)saida.estatisticas.apresentados, (unsigned long)saida.estatisticas.enviados,
+           (unsigned long)saida.estatisticas.suprimidos);
+    printf("%dx%d em %d via(s): %lu us por quadro\n", MATRIZ_LARGURA, MATRIZ_ALTURA, MATRIZ_VIAS,
+           (unsigned long)transporte.ultimo_envio_us);
+
+#if MATRIZ_PONTILHAMENTO
+    uint32_t taxa = pontilhamento_taxa_medida(&pontilhamento);
+    printf("pontilhamento: %lu renovações, %lu.%03lu Hz obtidos (pedido %d Hz), prazos perdidos %lu\n",
+           (unsigned long)pontilhamento.estatisticas.renovacoes, (unsigned long)(taxa / 1000),
+           (unsigned long)(taxa % 1000), MATRIZ_PONTILHAMENTO_HZ, (unsigned long)pontilhamento.relogio.perdidos);
+#endif
+
+#if MATRIZ_INSTRUMENTACAO
+    instrumentacao_imprimir_resumo();
+#endif
+
+    bool ok = !falhas && !transporte.pulsos_invalidos && !transporte.bits_fora_periodo &&
+              !transporte.pixels_excedentes && !transporte.erro;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include "animacoes.h"
+#include "cache_quadros.h"
+#include "geometria.h"
+
+#if MATRIZ_BYTECODE
+#include "animacoes_bytecode.h"
+#endif
+
+// Desenha no computador todos os quadros das animações das teclas 1 a 7 e
+// grava um .c com as sequências empacotadas (const, ficam em flash na
+// placa) para o cache_quadros_t. O arquivo só compila para a mesma matriz,
+// correção gama e ordem das cores, e o cache ignora as sequências se o mapa
+// de LEDs mudar.
+//
+// Uso: gerar_quadros_flash <saida.c>
+
+#if MATRIZ_BYTECODE
+#define ANIMACAO(n) (&bytecode_animacao_##n)
+#else
+#define ANIMACAO(n) (&animacao_##n)
+#endif
+
+static const animacao_t *const animacoes[] = {
+    ANIMACAO(1), ANIMACAO(2), ANIMACAO(3), ANIMACAO(4), ANIMACAO(5), ANIMACAO(6), ANIMACAO(7),
+};
+
+#define NUM_ANIMACOES (int)(sizeof(animacoes) / sizeof(animacoes[0]))
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <saida.c>\n", argv[0]);
+        return 2;
+    }
+    FILE *saida = fopen(argv[1], "w");
+    if (saida == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(saida, "// Arquivo gerado por host/gerar_quadros_flash; não edite.\n\n");
+    fprintf(saida, "#include \"cache_quadros.h\"\n#include \"cor.h\"\n\n");
+    fprintf(saida,
+            "#if MATRIZ_LARGURA != %d || MATRIZ_ALTURA != %d || MATRIZ_CORRECAO_GAMA != %d || "
+            "MATRIZ_ORDEM_CORES != %d\n",
+            MATRIZ_LARGURA, MATRIZ_ALTURA, MATRIZ_CORRECAO_GAMA, MATRIZ_ORDEM_CORES);
+    fprintf(saida, "#error \"Quadros gerados para outra matriz; rode gerar_quadros_flash de novo\"\n#endif\n\n");
+    fprintf(saida, "#if MATRIZ_BYTECODE\n#include \"animacoes_bytecode.h\"\n"
+                   "#define ANIMACAO(n) (&bytecode_animacao_##n)\n#else\n"
+                   "#define ANIMACAO(n) (&animacao_##n)\n#endif\n\n");
+
+    fprintf(saida, "const uint16_t quadros_flash_mapa[NUM_PIXELS] = {");
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        fprintf(saida, "%s%u,", i % 16 ? " " : "\n    ", mapa_leds[i]);
+    }
+    fprintf(saida, "\n};\n");
+
+    uint32_t total = 0;
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        const animacao_t *animacao = animacoes[a];
+        uint32_t quadro[NUM_PIXELS];
+        uint8_t empacotado[CACHE_BYTES_QUADRO];
+
+        fprintf(saida, "\n// %s: %u quadros\n", animacao->nome, animacao->quant_quadros);
+        fprintf(saida, "static const uint8_t quadros_%d[%u] = {", a + 1,
+                (unsigned)(animacao->quant_quadros * CACHE_BYTES_QUADRO));
+        for (uint16_t indice = 0; indice < animacao->quant_quadros; indice++) {
+            animacao->desenhar(animacao, quadro, indice);
+            cache_quadros_empacotar(empacotado, quadro);
+            for (int b = 0; b < CACHE_BYTES_QUADRO; b++) {
+                fprintf(saida, "%s0x%02x,", b % 16 ? " " : "\n    ", empacotado[b]);
+            }
+        }
+        fprintf(saida, "\n};\n");
+        total += animacao->quant_quadros * CACHE_BYTES_QUADRO;
+    }
+
+    fprintf(saida, "\nconst sequencia_flash_t quadros_flash[] = {\n");
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        fprintf(saida, "    {ANIMACAO(%d), quadros_%d},\n", a + 1, a + 1);
+    }
+    fprintf(saida, "};\nconst int quant_quadros_flash = %d;\n", NUM_ANIMACOES);
+    fclose(saida);
+
+    printf("%d animações, %lu bytes de quadros em %s\n", NUM_ANIMACOES, (unsigned long)total, argv[1]);
+    return 0;
+}
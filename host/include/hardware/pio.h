@@ -0,0 +1,17 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+// Substituto de hardware/pio.h para a compilação no computador (MATRIZ_HOST).
+// Traz só a descrição do programa, que é o que o emulador (pio_emulador.h)
+// precisa; a configuração das máquinas de estado existe apenas na placa.
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin; // -1 para qualquer posição
+} pio_program_t;
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto de pico/stdlib.h para a compilação no computador (MATRIZ_HOST).
+// O tempo é virtual: só anda com sleep_*() e relogio_host_avancar(), então
+// as execuções são determinísticas e não esperam o tempo real.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void sleep_until(absolute_time_t instante);
+void busy_wait_us(uint64_t us);
+
+static inline uint64_t to_us_since_boot(absolute_time_t instante) {
+    return instante;
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us) {
+    return time_us_64() + us;
+}
+
+static inline void tight_loop_contents(void) {
+}
+
+// Avança o relógio virtual, por exemplo pelo tempo gasto numa transmissão
+void relogio_host_avancar(uint64_t us);
+
+#endif
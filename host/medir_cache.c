@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "animacoes.h"
+#include "cache_quadros.h"
+#include "escalonador.h"
+#include "pico/stdlib.h"
+#include "transporte_memoria.h"
+
+// Confere que os quadros do cache_quadros_t (em RAM e das sequências em
+// flash geradas por gerar_quadros_flash) são iguais aos desenhados pelas
+// animações, mostra os contadores do LRU tocando as teclas 1 a 7 e mede o
+// tempo de processador por quadro tocado pelo escalonador sem cache, com o
+// cache em RAM já preenchido e com as sequências em flash. Termina com erro
+// se algum quadro diferir.
+//
+// Uso: medir_cache [repeticoes]   (padrão: 20 passadas por animação na medição)
+
+static const animacao_t *const animacoes[] = {
+    &animacao_1, &animacao_2, &animacao_3, &animacao_4, &animacao_5, &animacao_6, &animacao_7,
+};
+
+#define NUM_ANIMACOES (int)(sizeof(animacoes) / sizeof(animacoes[0]))
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+// Pede cada quadro duas vezes (a primeira desenha e guarda, a segunda copia)
+// e compara com o desenho direto
+static int conferir(cache_quadros_t *cache) {
+    int diferentes = 0;
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        const animacao_t *animacao = animacoes[a];
+        for (int vez = 0; vez < 2; vez++) {
+            for (uint16_t indice = 0; indice < animacao->quant_quadros; indice++) {
+                uint32_t esperado[NUM_PIXELS], obtido[NUM_PIXELS];
+                animacao->desenhar(animacao, esperado, indice);
+                cache_quadros_desenhar(cache, animacao, obtido, indice);
+                diferentes += memcmp(esperado, obtido, sizeof(esperado)) != 0;
+            }
+        }
+    }
+    return diferentes;
+}
+
+static void imprimir_contadores(const char *titulo, const cache_quadros_t *cache) {
+    const cache_quadros_estatisticas_t *e = &cache->estatisticas;
+    printf("%-24s acertos %5lu, acertos flash %5lu, falhas %5lu, despejos %3lu, sem espaço %5lu, %5lu bytes em uso\n",
+           titulo, (unsigned long)e->acertos, (unsigned long)e->acertos_flash, (unsigned long)e->falhas,
+           (unsigned long)e->despejos, (unsigned long)e->sem_espaco, (unsigned long)cache_quadros_bytes_em_uso(cache));
+}
+
+// Toca todos os quadros da animação pelo escalonador e retorna o tempo de
+// processador gasto em escalonador_passo() (o relógio virtual não espera)
+static uint64_t tocar(escalonador_t *escalonador, const animacao_t *animacao, uint32_t *quadros) {
+    uint64_t gasto = 0;
+    escalonador_tocar(escalonador, animacao, FPS(10), time_us_64());
+    while (!escalonador_concluido(escalonador)) {
+        uint64_t inicio = agora_ns();
+        bool apresentou = escalonador_passo(escalonador, time_us_64());
+        gasto += agora_ns() - inicio;
+        *quadros += apresentou;
+        uint64_t prazo = escalonador_prazo(escalonador);
+        if (prazo != UINT64_MAX) {
+            sleep_until(prazo);
+        }
+    }
+    return gasto;
+}
+
+int main(int argc, char **argv) {
+    int repeticoes = argc > 1 ? atoi(argv[1]) : 20;
+    static cache_quadros_t cache;
+    static uint8_t memoria[MATRIZ_CACHE_BYTES];
+    static saida_leds_t saida;
+    static escalonador_t escalonador;
+    static transporte_memoria_t transporte; // Só descarta, para medir só o lado do processador
+    int falhas = 0;
+
+    repeticoes = repeticoes > 0 ? repeticoes : 1;
+    printf("matriz %dx%d, cache de %d bytes, %d bytes por quadro\n", MATRIZ_LARGURA, MATRIZ_ALTURA,
+           MATRIZ_CACHE_BYTES, CACHE_BYTES_QUADRO);
+
+    cache_quadros_iniciar(&cache, memoria, sizeof(memoria), NULL, 0, NULL);
+    falhas += conferir(&cache);
+    imprimir_contadores("RAM, cada quadro 2x:", &cache);
+
+    if (!cache_quadros_iniciar(&cache, memoria, sizeof(memoria), quadros_flash, quant_quadros_flash, quadros_flash_mapa)) {
+        printf("sequências em flash geradas para outro mapa de LEDs\n");
+        falhas++;
+    }
+    falhas += conferir(&cache);
+    imprimir_contadores("flash, cada quadro 2x:", &cache);
+
+    // Teclas 1 a 7 duas vezes, na ordem, com a memória inteira e com metade
+    // dela: na metade o LRU retira as animações mais antigas
+    transporte_memoria_iniciar(&transporte, false);
+    saida_leds_iniciar(&saida, &transporte.base);
+    escalonador_iniciar(&escalonador, &saida);
+    escalonador.cache = &cache;
+    for (uint32_t tamanho = sizeof(memoria); tamanho >= sizeof(memoria) / 2; tamanho /= 2) {
+        char titulo[32];
+        cache_quadros_iniciar(&cache, memoria, tamanho, NULL, 0, NULL);
+        for (int vez = 0; vez < 2; vez++) {
+            for (int a = 0; a < NUM_ANIMACOES; a++) {
+                tocar(&escalonador, animacoes[a], &(uint32_t){0});
+            }
+        }
+        snprintf(titulo, sizeof(titulo), "%lu bytes, 1 a 7 2x:", (unsigned long)tamanho);
+        imprimir_contadores(titulo, &cache);
+    }
+
+    // Tecla repetida entre outras: 5, 4, 5, 2, 5 com metade da memória
+    cache_quadros_iniciar(&cache, memoria, sizeof(memoria) / 2, NULL, 0, NULL);
+    const animacao_t *sequencia[] = {&animacao_5, &animacao_4, &animacao_5, &animacao_2, &animacao_5};
+    for (size_t s = 0; s < sizeof(sequencia) / sizeof(sequencia[0]); s++) {
+        tocar(&escalonador, sequencia[s], &(uint32_t){0});
+    }
+    imprimir_contadores("metade, 5 4 5 2 5:", &cache);
+
+    // Tempo por quadro tocado: sem cache, com o cache em RAM já preenchido
+    // (cada animação sozinha no cache) e com as sequências em flash
+    printf("%-12s %7s %10s %10s %10s  (ns por quadro tocado)\n", "animacao", "quadros", "sem cache", "RAM",
+           "flash");
+    for (int a = 0; a < NUM_ANIMACOES; a++) {
+        const animacao_t *animacao = animacoes[a];
+        uint64_t gasto[3] = {0, 0, 0};
+        uint32_t tocados[3] = {0, 0, 0};
+        for (int modo = 0; modo < 3; modo++) {
+            escalonador.cache = modo ? &cache : NULL;
+            if (modo == 1) {
+                cache_quadros_iniciar(&cache, memoria, sizeof(memoria), NULL, 0, NULL);
+                tocar(&escalonador, animacao, &(uint32_t){0}); // Preenche
+            } else if (modo == 2) {
+                cache_quadros_iniciar(&cache, memoria, sizeof(memoria), quadros_flash, quant_quadros_flash, quadros_flash_mapa);
+            }
+            for (int r = 0; r < repeticoes; r++) {
+                gasto[modo] += tocar(&escalonador, animacao, &tocados[modo]);
+            }
+        }
+        printf("%-12s %7u %10.1f %10.1f %10.1f\n", animacao->nome, animacao->quant_quadros,
+               (double)gasto[0] / tocados[0], (double)gasto[1] / tocados[1], (double)gasto[2] / tocados[2]);
+    }
+
+    if (falhas) {
+        printf("%d quadros diferentes do desenho direto\n", falhas);
+        return 1;
+    }
+    printf("todos os quadros do cache iguais ao desenho direto\n");
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "animacoes.h"
+#include "compositor.h"
+#include "cor_referencia.h"
+#include "escalonador.h"
+#include "pico/stdlib.h"
+#include "transporte_emulado.h"
+
+// Confere as misturas SWAR de compositor.h contra a referência em double de
+// cor_referencia.c, mede o custo de compor COMPOSITOR_CAMADAS camadas
+// contra o período dos quadros e passa uma transição e uma sobreposição
+// pelo escalonador e pelo emulador do PIO. Termina com erro se uma mistura
+// passar do erro tolerado ou se os quadros decodificados não forem os esperados.
+//
+// Uso: orcamento_compositor [repeticoes]   (padrão: 20000 composições medidas)
+
+// Erro máximo tolerado por canal contra a referência arredondada: o peso
+// alfa em 1/256 e o truncamento das multiplicações somam até 2 passos
+#define ERRO_TOLERADO 2
+
+static const char *nomes_modos[] = {"sobrepor", "somar", "multiplicar"};
+
+static uint64_t agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static uint32_t misturar(uint32_t fundo, uint32_t frente, uint32_t alfa, modo_mistura_t modo) {
+    switch (modo) {
+        case MISTURA_SOMAR:
+            return misturar_somar(fundo, frente, alfa);
+        case MISTURA_MULTIPLICAR:
+            return misturar_multiplicar(fundo, frente, alfa);
+        default:
+            return misturar_sobrepor(fundo, frente, alfa);
+    }
+}
+
+// Todos os pares de valores de canal, com cada canal da palavra recebendo
+// uma combinação diferente para pegar vazamentos entre faixas
+static int conferir_misturas(void) {
+    static const uint8_t opacidades[] = {0, 1, 64, 127, 128, 200, 254, 255};
+    int falhas = 0;
+
+    for (int modo = MISTURA_SOBREPOR; modo <= MISTURA_MULTIPLICAR; modo++) {
+        uint32_t maior_erro = 0;
+        for (size_t o = 0; o < sizeof(opacidades); o++) {
+            uint32_t alfa = mistura_alfa(opacidades[o]);
+            for (uint32_t d = 0; d < 256; d++) {
+                for (uint32_t f = 0; f < 256; f++) {
+                    uint32_t fundo = d << 24 | (255 - d) << 16 | (f ^ 0xA5) << 8;
+                    uint32_t frente = f << 24 | (255 - f) << 16 | (d ^ 0x5A) << 8;
+#if PIXEL_CANAIS == 4
+                    fundo |= (d * 7 + f) & 0xFF;
+                    frente |= (f * 3 + d) & 0xFF;
+#endif
+                    uint32_t obtido = misturar(fundo, frente, alfa, (modo_mistura_t)modo);
+                    uint32_t esperado = misturar_ref(fundo, frente, opacidades[o], (modo_mistura_t)modo);
+#if PIXEL_CANAIS == 3
+                    if (obtido & 0xFF) {
+                        maior_erro = 255; // Byte baixo deve continuar zero
+                    }
+#endif
+                    for (int deslocamento = PIXEL_DESLOCAMENTO_MINIMO; deslocamento < 32; deslocamento += 8) {
+                        int a = (obtido >> deslocamento) & 0xFF;
+                        int b = (esperado >> deslocamento) & 0xFF;
+                        uint32_t erro = (uint32_t)abs(a - b);
+                        maior_erro = erro > maior_erro ? erro : maior_erro;
+                    }
+                }
+            }
+        }
+        printf("mistura %-11s erro máximo %lu passo(s)%s\n", nomes_modos[modo], (unsigned long)maior_erro,
+               maior_erro > ERRO_TOLERADO ? "  ACIMA DO TOLERADO" : "");
+        falhas += maior_erro > ERRO_TOLERADO;
+    }
+    return falhas;
+}
+
+// Pior caso: todas as camadas visíveis e nenhuma opaca, então cada uma
+// mistura todos os pixels
+static void medir_composicao(int repeticoes) {
+    static volatile uint32_t sorvedouro;
+    static camada_t camadas[COMPOSITOR_CAMADAS];
+    static uint32_t destino[NUM_PIXELS];
+    for (int c = 0; c < COMPOSITOR_CAMADAS; c++) {
+        animacao_5.desenhar(&animacao_5, camadas[c].quadro.pixels, (uint16_t)(7 + c));
+        camadas[c].opacidade = 200;
+        camadas[c].modo = (modo_mistura_t)(c % 3);
+        camadas[c].visivel = true;
+    }
+
+    uint64_t inicio = agora_ns();
+    for (int r = 0; r < repeticoes; r++) {
+        compositor_compor(camadas, COMPOSITOR_CAMADAS, destino);
+    }
+    double ns = (double)(agora_ns() - inicio) / repeticoes;
+
+    double periodo_transicao_ns = 1e12 / FPS_TRANSICAO;
+    double periodo_10fps_ns = 1e12 / FPS(10);
+    printf("composição de %d camadas, %d pixels: %.1f ns (%.2f ns por pixel e camada)\n", COMPOSITOR_CAMADAS,
+           NUM_PIXELS, ns, ns / NUM_PIXELS / COMPOSITOR_CAMADAS);
+    printf("  %.3f%% do período da transição (%.0f us), %.3f%% do período a 10 fps (%.0f us)\n",
+           100.0 * ns / periodo_transicao_ns, periodo_transicao_ns / 1000, 100.0 * ns / periodo_10fps_ns,
+           periodo_10fps_ns / 1000);
+    sorvedouro += destino[0];
+}
+
+static bool canal_monotono(const uint32_t *anterior, const uint32_t *atual, int deslocamento, bool subindo) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        uint32_t a = (anterior[i] >> deslocamento) & 0xFF;
+        uint32_t b = (atual[i] >> deslocamento) & 0xFF;
+        if (subindo ? b < a : b > a) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Toca uma animação até o escalonador concluir ou até "limite_us"
+// passar; "conferir" é chamada depois de cada quadro apresentado
+typedef int (*conferir_t)(const escalonador_t *escalonador, const transporte_emulado_t *transporte, int quadro);
+
+static int tocar_ate(escalonador_t *escalonador, transporte_emulado_t *transporte, uint64_t limite_us,
+                     conferir_t conferir) {
+    int falhas = 0, quadro = 0;
+    uint64_t fim = time_us_64() + limite_us;
+    while (!escalonador_concluido(escalonador) && time_us_64() < fim) {
+        if (escalonador_passo(escalonador, time_us_64()) && conferir) {
+            falhas += conferir(escalonador, transporte, quadro++);
+        }
+        uint64_t prazo = escalonador_prazo(escalonador);
+        sleep_until(prazo < fim ? prazo : fim);
+    }
+    return falhas;
+}
+
+// Na transição de azul para vermelho o azul só desce e o vermelho só sobe
+static uint32_t anterior[NUM_PIXELS];
+
+static int conferir_transicao(const escalonador_t *escalonador, const transporte_emulado_t *transporte, int quadro) {
+    (void)escalonador;
+    int falha = quadro > 0 && (!canal_monotono(anterior, transporte->quadro, PIXEL_DESLOCAMENTO_B, false) ||
+                               !canal_monotono(anterior, transporte->quadro, PIXEL_DESLOCAMENTO_R, true));
+    memcpy(anterior, transporte->quadro, sizeof(anterior));
+    return falha;
+}
+
+// A contagem regressiva somada à onda: cada quadro decodificado deve ser a
+// soma dos quadros que as duas animações desenham sozinhas
+static int conferir_sobreposicao(const escalonador_t *escalonador, const transporte_emulado_t *transporte,
+                                 int quadro) {
+    (void)quadro;
+    const faixa_t *fundo = &escalonador->faixas[CAMADA_FUNDO];
+    const faixa_t *frente = &escalonador->faixas[CAMADA_SOBREPOSICAO];
+    uint32_t onda[NUM_PIXELS], contagem[NUM_PIXELS];
+    if (fundo->animacao == NULL || frente->animacao == NULL || frente->quadro == 0) {
+        return 0;
+    }
+    fundo->animacao->desenhar(fundo->animacao, onda, (uint16_t)(fundo->quadro - 1));
+    frente->animacao->desenhar(frente->animacao, contagem, (uint16_t)(frente->quadro - 1));
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (transporte->quadro[i] != misturar_somar(onda[i], contagem[i], 256)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int repeticoes = argc > 1 ? atoi(argv[1]) : 20000;
+    static transporte_emulado_t transporte;
+    static saida_leds_t saida;
+    static escalonador_t escalonador;
+    int falhas = conferir_misturas();
+
+    medir_composicao(repeticoes > 0 ? repeticoes : 1);
+
+    transporte_emulado_iniciar(&transporte);
+    saida_leds_iniciar(&saida, &transporte.base);
+    escalonador_iniciar(&escalonador, &saida);
+
+    // Transição de 300 ms entre duas cores sólidas
+    escalonador_tocar(&escalonador, &animacao_azul_100, FPS(1), time_us_64());
+    tocar_ate(&escalonador, &transporte, 2000000, NULL);
+    escalonador.transicao_us = 300000;
+    uint32_t enviados = saida.estatisticas.enviados;
+    escalonador_tocar(&escalonador, &animacao_vermelho_80, FPS(1), time_us_64());
+    int falhas_transicao = tocar_ate(&escalonador, &transporte, 2000000, conferir_transicao);
+    uint32_t vermelho[NUM_PIXELS];
+    animacao_vermelho_80.desenhar(&animacao_vermelho_80, vermelho, 0);
+    falhas_transicao += memcmp(vermelho, transporte.quadro, sizeof(vermelho)) != 0 || escalonador.compondo;
+    printf("transição azul -> vermelho: %lu quadros enviados%s\n",
+           (unsigned long)(saida.estatisticas.enviados - enviados), falhas_transicao ? "  FALHOU" : "");
+    falhas += falhas_transicao;
+
+    // Contagem regressiva somada à onda por 5 s, depois retirada
+    escalonador.transicao_us = 0;
+    escalonador_tocar(&escalonador, &animacao_5, FPS(10), time_us_64());
+    escalonador_sobrepor(&escalonador, CAMADA_SOBREPOSICAO, &animacao_4, FPS(10), MISTURA_SOMAR, 255, time_us_64());
+    enviados = saida.estatisticas.enviados;
+    int falhas_sobreposicao = tocar_ate(&escalonador, &transporte, 5000000, conferir_sobreposicao);
+    escalonador_remover(&escalonador, CAMADA_SOBREPOSICAO);
+    escalonador_passo(&escalonador, time_us_64());
+    falhas_sobreposicao += escalonador.compondo;
+    printf("sobreposição animacao_4 + animacao_5: %lu quadros enviados%s\n",
+           (unsigned long)(saida.estatisticas.enviados - enviados), falhas_sobreposicao ? "  FALHOU" : "");
+    falhas += falhas_sobreposicao;
+
+    bool ok = !falhas && !transporte.pulsos_invalidos && !transporte.bits_fora_periodo && !transporte.erro;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+#include "pio_emulador.h"
+
+#include <string.h>
+
+// Campos de uma instrução do PIO (atraso e side-set dividem os bits 12 a 8)
+#define OPCODE(i) ((i) >> 13)
+#define ATRASO_SIDESET(i) (((i) >> 8) & 0x1F)
+#define DESTINO(i) (((i) >> 5) & 0x7)
+#define OPERACAO(i) (((i) >> 3) & 0x3)
+#define ORIGEM(i) ((i) & 0x7)
+#define DADO(i) ((i) & 0x1F)
+
+enum {
+    OP_JMP = 0,
+    OP_IN = 2,
+    OP_OUT = 3,
+    OP_PUSH_PULL = 4,
+    OP_MOV = 5,
+    OP_SET = 7,
+};
+
+// Origens de IN e MOV e destinos de MOV e SET que os programas usam
+enum {
+    REG_PINS = 0,
+    REG_X = 1,
+    REG_Y = 2,
+    REG_NULL = 3,
+    REG_PINDIRS = 4, // Só no SET
+    REG_PC = 5,      // Só como destino do MOV
+    REG_ISR = 6,
+    REG_OSR = 7,
+};
+
+void pio_emulador_iniciar(pio_emulador_t *pio, const pio_program_t *programa,
+                          uint8_t inicio_wrap, uint8_t fim_wrap, uint8_t limiar_pull) {
+    memset(pio, 0, sizeof(*pio));
+    pio->instrucoes = programa->instructions;
+    pio->tamanho = programa->length;
+    pio->inicio_wrap = inicio_wrap;
+    pio->fim_wrap = fim_wrap;
+    pio->limiar_pull = limiar_pull;
+    pio->osr_deslocados = 32;
+    pio->quant_set = 1;
+}
+
+void pio_emulador_configurar_pinos(pio_emulador_t *pio, uint8_t base_set, uint8_t quant_set, uint8_t base_in,
+                                   uint8_t base_sideset, uint8_t bits_sideset, bool opcional, bool direcoes) {
+    pio->base_set = base_set;
+    pio->quant_set = quant_set;
+    pio->base_in = base_in;
+    pio->base_sideset = base_sideset;
+    pio->bits_sideset = bits_sideset;
+    pio->sideset_opcional = opcional;
+    pio->sideset_direcoes = direcoes;
+}
+
+bool pio_emulador_colocar(pio_emulador_t *pio, uint32_t palavra) {
+    if (pio->fifo_quant == PIO_EMULADOR_FIFO) {
+        return false;
+    }
+    pio->fifo[(pio->fifo_inicio + pio->fifo_quant) % PIO_EMULADOR_FIFO] = palavra;
+    pio->fifo_quant++;
+    return true;
+}
+
+bool pio_emulador_obter(pio_emulador_t *pio, uint32_t *palavra) {
+    if (pio->rx_quant == 0) {
+        return false;
+    }
+    *palavra = pio->rx[pio->rx_inicio];
+    pio->rx_inicio = (pio->rx_inicio + 1) % PIO_EMULADOR_FIFO;
+    pio->rx_quant--;
+    return true;
+}
+
+// Move a próxima palavra da FIFO para a OSR
+// Retorna:
+// - false se a FIFO estiver vazia
+static bool puxar(pio_emulador_t *pio) {
+    if (pio->fifo_quant == 0) {
+        return false;
+    }
+    pio->osr = pio->fifo[pio->fifo_inicio];
+    pio->fifo_inicio = (pio->fifo_inicio + 1) % PIO_EMULADOR_FIFO;
+    pio->fifo_quant--;
+    pio->osr_deslocados = 0;
+    return true;
+}
+
+// Escreve "quant" bits de "valor" a partir do GPIO "base" (com a volta do
+// GPIO 31 para o 0, como no PIO)
+static uint32_t escrever_bits(uint32_t destino, uint8_t base, uint8_t quant, uint32_t valor) {
+    for (uint8_t i = 0; i < quant; i++) {
+        uint32_t bit = 1u << ((base + i) & 31);
+        destino = (valor >> i) & 1 ? destino | bit : destino & ~bit;
+    }
+    return destino;
+}
+
+// Pinos a partir de base_in, girados como o PIO faz
+static uint32_t ler_entradas(const pio_emulador_t *pio) {
+    uint32_t niveis = pio->ler_pinos ? pio->ler_pinos(pio, pio->contexto_pinos) : 0;
+    return pio->base_in ? niveis >> pio->base_in | niveis << (32 - pio->base_in) : niveis;
+}
+
+// Valor de uma origem de IN ou MOV
+static uint32_t ler_origem(pio_emulador_t *pio, uint8_t origem) {
+    switch (origem) {
+        case REG_PINS: return ler_entradas(pio);
+        case REG_X: return pio->x;
+        case REG_Y: return pio->y;
+        case REG_NULL: return 0;
+        case REG_ISR: return pio->isr;
+        case REG_OSR: return pio->osr;
+        default: // STATUS não é usado pelos programas
+            pio->erro = true;
+            return 0;
+    }
+}
+
+static uint32_t inverter_bits(uint32_t valor) {
+    uint32_t invertido = 0;
+    for (int i = 0; i < 32; i++) {
+        invertido = invertido << 1 | ((valor >> i) & 1);
+    }
+    return invertido;
+}
+
+// Aplica o side-set da instrução, que vale já no primeiro ciclo dela
+// Retorna:
+// - Ciclos de atraso da instrução
+static uint8_t aplicar_sideset(pio_emulador_t *pio, uint16_t instrucao) {
+    uint8_t campo = ATRASO_SIDESET(instrucao);
+    uint8_t bits_atraso = 5 - pio->bits_sideset;
+    uint8_t atraso = campo & ((1u << bits_atraso) - 1);
+    if (!pio->bits_sideset) {
+        return atraso;
+    }
+
+    uint8_t bits_valor = pio->bits_sideset;
+    uint32_t valor = campo >> bits_atraso;
+    if (pio->sideset_opcional) {
+        bits_valor--;
+        if (!(valor >> bits_valor)) {
+            return atraso; // Instrução sem side-set
+        }
+        valor &= (1u << bits_valor) - 1;
+    }
+    if (pio->sideset_direcoes) {
+        pio->direcoes = escrever_bits(pio->direcoes, pio->base_sideset, bits_valor, valor);
+    } else {
+        pio->pinos = escrever_bits(pio->pinos, pio->base_sideset, bits_valor, valor);
+    }
+    return atraso;
+}
+
+static bool condicao_jmp(pio_emulador_t *pio, uint8_t condicao) {
+    switch (condicao) {
+        case 0: return true;
+        case 1: return pio->x == 0;
+        case 2: return pio->x-- != 0;
+        case 3: return pio->y == 0;
+        case 4: return pio->y-- != 0;
+        case 5: return pio->x != pio->y;
+        case 7: return pio->osr_deslocados < pio->limiar_pull;
+        default: // jmp pin não é usado pelos programas
+            pio->erro = true;
+            return false;
+    }
+}
+
+void pio_emulador_ciclo(pio_emulador_t *pio) {
+    pio->ciclo++;
+    if (pio->erro) {
+        return;
+    }
+    if (pio->atraso) {
+        pio->atraso--;
+        return;
+    }
+
+    uint16_t instrucao = pio->instrucoes[pio->pc];
+    uint8_t proximo = pio->pc == pio->fim_wrap ? pio->inicio_wrap : pio->pc + 1;
+    uint8_t atraso = aplicar_sideset(pio, instrucao);
+
+    switch (OPCODE(instrucao)) {
+        case OP_JMP:
+            if (condicao_jmp(pio, DESTINO(instrucao))) {
+                proximo = DADO(instrucao);
+            }
+            break;
+
+        case OP_IN: {
+            uint8_t bits = DADO(instrucao) ? DADO(instrucao) : 32;
+            uint32_t valor = ler_origem(pio, DESTINO(instrucao));
+            if (bits == 32) {
+                pio->isr = valor;
+            } else {
+                pio->isr = pio->isr << bits | (valor & ((1u << bits) - 1));
+            }
+            pio->isr_deslocados = pio->isr_deslocados + bits > 32 ? 32 : pio->isr_deslocados + bits;
+            break;
+        }
+
+        case OP_OUT: {
+            // Autopull: com a OSR no limiar o OUT para até chegar um dado,
+            // sem contar o atraso
+            if (pio->osr_deslocados >= pio->limiar_pull && !puxar(pio)) {
+                pio->ciclos_parados++;
+                pio->tx_parada = true;
+                return;
+            }
+            uint8_t bits = DADO(instrucao) ? DADO(instrucao) : 32;
+            uint32_t valor = bits == 32 ? pio->osr : pio->osr >> (32 - bits);
+            pio->osr = bits == 32 ? 0 : pio->osr << bits;
+            pio->osr_deslocados = pio->osr_deslocados + bits > 32 ? 32 : pio->osr_deslocados + bits;
+
+            switch (DESTINO(instrucao)) {
+                case 1: pio->x = valor; break;
+                case 2: pio->y = valor; break;
+                case 3: break; // null
+                case 5: proximo = valor & 0x1F; break;
+                default: pio->erro = true; break;
+            }
+            break;
+        }
+
+        case OP_PUSH_PULL:
+            if (!(instrucao & 0x80)) { // PUSH (sem iffull, que só faz sentido com autopush)
+                if (instrucao & 0x40) {
+                    pio->erro = true;
+                    break;
+                }
+                if (pio->rx_quant == PIO_EMULADOR_FIFO) {
+                    if (instrucao & 0x20) { // block
+                        pio->ciclos_parados++;
+                        return;
+                    }
+                    pio->rx_perdidos++; // noblock com a FIFO cheia descarta o ISR
+                } else {
+                    pio->rx[(pio->rx_inicio + pio->rx_quant) % PIO_EMULADOR_FIFO] = pio->isr;
+                    pio->rx_quant++;
+                }
+                pio->isr = 0;
+                pio->isr_deslocados = 0;
+                break;
+            }
+            if (!puxar(pio)) {
+                if (instrucao & 0x20) { // block
+                    pio->ciclos_parados++;
+                    pio->tx_parada = true;
+                    return;
+                }
+                pio->osr = pio->x; // noblock com FIFO vazia copia X
+                pio->osr_deslocados = 0;
+            }
+            break;
+
+        case OP_MOV: {
+            uint32_t valor = ler_origem(pio, ORIGEM(instrucao));
+            switch (OPERACAO(instrucao)) {
+                case 0: break;
+                case 1: valor = ~valor; break;
+                case 2: valor = inverter_bits(valor); break;
+                default: pio->erro = true; break;
+            }
+            switch (DESTINO(instrucao)) {
+                case REG_X: pio->x = valor; break;
+                case REG_Y: pio->y = valor; break;
+                case REG_PC: proximo = valor & 0x1F; break;
+                case REG_ISR:
+                    pio->isr = valor;
+                    pio->isr_deslocados = 0;
+                    break;
+                case REG_OSR:
+                    pio->osr = valor;
+                    pio->osr_deslocados = 0;
+                    break;
+                default: // pins exige o grupo OUT; exec não é usado
+                    pio->erro = true;
+                    break;
+            }
+            break;
+        }
+
+        case OP_SET:
+            switch (DESTINO(instrucao)) {
+                case REG_PINS:
+                    pio->pinos = escrever_bits(pio->pinos, pio->base_set, pio->quant_set, DADO(instrucao));
+                    break;
+                case REG_X: pio->x = DADO(instrucao); break;
+                case REG_Y: pio->y = DADO(instrucao); break;
+                case REG_PINDIRS:
+                    pio->direcoes = escrever_bits(pio->direcoes, pio->base_set, pio->quant_set, DADO(instrucao));
+                    break;
+                default: pio->erro = true; break;
+            }
+            break;
+
+        default:
+            pio->erro = true;
+            break;
+    }
+
+    if (proximo >= pio->tamanho) {
+        pio->erro = true;
+    }
+    pio->pc = proximo;
+    pio->atraso = atraso;
+}
+
+bool pio_emulador_ocioso(const pio_emulador_t *pio) {
+    return pio->fifo_quant == 0 && pio->osr_deslocados >= pio->limiar_pull && pio->atraso == 0 &&
+           OPCODE(pio->instrucoes[pio->pc]) == OP_OUT;
+}
@@ -0,0 +1,107 @@
+#ifndef PIO_EMULADOR_H
+#define PIO_EMULADOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/pio.h"
+
+// Profundidade de cada FIFO com a outra unida a ela (PIO_FIFO_JOIN_TX ou
+// PIO_FIFO_JOIN_RX; cada programa deste projeto usa só um sentido)
+#define PIO_EMULADOR_FIFO 8
+
+struct pio_emulador;
+
+// Lê os níveis dos 32 GPIO vistos pela máquina de estado (IN pins, MOV de pins)
+typedef uint32_t (*pio_emulador_ler_pinos_t)(const struct pio_emulador *pio, void *contexto);
+
+// Emulador ciclo a ciclo de uma máquina de estado do PIO. Cobre o que os
+// programas deste projeto usam: JMP, OUT (x, y, null, pc), IN (pins, x, y,
+// null, isr, osr), MOV (x, y, isr, osr, pc; com inversão e bits invertidos),
+// SET (pins, x, y, pindirs), PUSH, PULL e autopull, com atrasos e side-set
+// (opcional, em pinos ou direções). Os deslocamentos da OSR e do ISR são
+// sempre para a esquerda, sem autopush, como em animacao_MatrizLED e teclado.
+typedef struct pio_emulador {
+    const uint16_t *instrucoes; // Programa carregado no endereço 0
+    uint8_t tamanho;
+    uint8_t inicio_wrap;
+    uint8_t fim_wrap;
+    uint8_t limiar_pull;        // Bits consumidos da OSR antes do autopull
+
+    uint8_t pc;
+    uint8_t atraso;             // Ciclos de atraso restantes da instrução atual
+    uint32_t x;
+    uint32_t y;
+    uint32_t osr;
+    uint8_t osr_deslocados;     // Bits já retirados da OSR (32 = vazia)
+
+    uint32_t isr;
+    uint8_t isr_deslocados;     // Bits já colocados no ISR
+
+    uint32_t fifo[PIO_EMULADOR_FIFO]; // FIFO TX
+    uint8_t fifo_inicio;
+    uint8_t fifo_quant;
+    uint32_t rx[PIO_EMULADOR_FIFO];   // FIFO RX
+    uint8_t rx_inicio;
+    uint8_t rx_quant;
+    uint32_t rx_perdidos;       // PUSH noblock com a FIFO RX cheia
+
+    // Mapeamento de pinos (sm_config_set_set_pins, _in_pins, _sideset_pins)
+    uint8_t base_set;
+    uint8_t quant_set;
+    uint8_t base_in;
+    uint8_t base_sideset;
+    uint8_t bits_sideset;       // Bits do side-set, incluindo o de opcional
+    bool sideset_opcional;
+    bool sideset_direcoes;      // Side-set escreve direções em vez de níveis
+    pio_emulador_ler_pinos_t ler_pinos; // NULL lê todos em nível baixo
+    void *contexto_pinos;
+
+    uint32_t pinos;             // Níveis escritos pela máquina (GPIO 0 a 31)
+    uint32_t direcoes;          // Direções escritas pela máquina (1 = saída)
+    bool erro;                  // Instrução não suportada encontrada
+    uint64_t ciclo;             // Ciclos executados desde o início
+    uint64_t ciclos_parados;    // Ciclos parados esperando dados na FIFO
+    bool tx_parada;             // TXSTALL de FDEBUG: parou num PULL ou autopull com a FIFO TX
+                                // vazia; fica marcado até ser limpo (escrita de 1 na placa)
+} pio_emulador_t;
+
+// Carrega o programa e reinicia a máquina de estado como pio_sm_init()
+// Parâmetros:
+// - programa: Programa gerado pelo pioasm
+// - inicio_wrap: Endereço de .wrap_target
+// - fim_wrap: Endereço de .wrap
+// - limiar_pull: Limiar do autopull (o mesmo de sm_config_set_out_shift)
+void pio_emulador_iniciar(pio_emulador_t *pio, const pio_program_t *programa,
+                          uint8_t inicio_wrap, uint8_t fim_wrap, uint8_t limiar_pull);
+
+// Mapeia os pinos como sm_config_set_set_pins(), sm_config_set_in_pins(),
+// sm_config_set_sideset_pins() e sm_config_set_sideset(). Sem esta chamada
+// há um único pino SET, sem side-set.
+// Parâmetros:
+// - base_set, quant_set: Primeiro GPIO e quantidade do grupo SET
+// - base_in: GPIO lido no bit 0 por IN pins
+// - base_sideset: Primeiro GPIO do side-set
+// - bits_sideset: Bits do side-set, incluindo o de opcional (0 sem side-set)
+// - opcional: Side-set opcional (.side_set n opt)
+// - direcoes: Side-set escreve direções (.side_set n pindirs)
+void pio_emulador_configurar_pinos(pio_emulador_t *pio, uint8_t base_set, uint8_t quant_set, uint8_t base_in,
+                                   uint8_t base_sideset, uint8_t bits_sideset, bool opcional, bool direcoes);
+
+// Coloca uma palavra na FIFO TX
+// Retorna:
+// - false se a FIFO estiver cheia
+bool pio_emulador_colocar(pio_emulador_t *pio, uint32_t palavra);
+
+// Retira a palavra mais antiga da FIFO RX
+// Retorna:
+// - false se a FIFO estiver vazia
+bool pio_emulador_obter(pio_emulador_t *pio, uint32_t *palavra);
+
+// Executa um ciclo de relógio da máquina de estado
+void pio_emulador_ciclo(pio_emulador_t *pio);
+
+// Retorna true quando a FIFO e a OSR estão vazias e a máquina está parada
+// no OUT esperando o próximo dado
+bool pio_emulador_ocioso(const pio_emulador_t *pio);
+
+#endif
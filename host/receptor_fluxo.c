@@ -0,0 +1,80 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "fluxo_quadros.h"
+#include "saida_leds.h"
+#include "transporte_emulado.h"
+#include "transporte_memoria.h"
+
+// Recebe no computador o protocolo de fluxo_quadros.h, do mesmo jeito que a
+// placa no modo da tecla 8, e mede a taxa de quadros sustentada. Os bytes
+// vêm da entrada padrão ou de um arquivo/dispositivo (por exemplo o lado
+// escravo de um pty), com o tempo real de chegada de cada bloco. Termina
+// com erro se nenhum quadro chegar ou se algum se perder ou chegar corrompido.
+//
+// Uso: receptor_fluxo [-e] [arquivo]
+//   -e  passa cada quadro pelo emulador do PIO (mais lento, confere a forma de onda)
+
+static uint64_t agora_real_us(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+int main(int argc, char **argv) {
+    static transporte_emulado_t emulado;
+    static transporte_memoria_t contador; // Só conta, para medir o receptor sem o emulador
+    static saida_leds_t saida;
+    static fluxo_quadros_t fluxo;
+    bool emular = false;
+    int entrada = STDIN_FILENO;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0) {
+            emular = true;
+        } else if ((entrada = open(argv[i], O_RDONLY)) < 0) {
+            perror(argv[i]);
+            return 2;
+        }
+    }
+
+    transporte_emulado_iniciar(&emulado);
+    transporte_memoria_iniciar(&contador, false);
+    saida_leds_iniciar(&saida, emular ? &emulado.base : &contador.base);
+    fluxo_iniciar(&fluxo, &saida);
+
+    uint8_t bloco[4096];
+    uint64_t primeiro = 0, ultimo = 0;
+    uint32_t recebidos = 0;
+    ssize_t lidos;
+    while ((lidos = read(entrada, bloco, sizeof(bloco))) > 0) {
+        uint64_t agora = agora_real_us();
+        fluxo_receber(&fluxo, bloco, (uint32_t)lidos, agora);
+        if (fluxo.estatisticas.recebidos != recebidos) {
+            if (recebidos == 0) {
+                primeiro = agora;
+            }
+            recebidos = fluxo.estatisticas.recebidos;
+            ultimo = agora;
+        }
+    }
+
+    const fluxo_estatisticas_t *estatisticas = &fluxo.estatisticas;
+    uint64_t duracao = ultimo - primeiro;
+    printf("%d pixels: recebidos %lu, perdidos %lu, corrompidos %lu, atrasados %lu, enviados à matriz %lu\n",
+           NUM_PIXELS, (unsigned long)estatisticas->recebidos, (unsigned long)estatisticas->perdidos,
+           (unsigned long)estatisticas->corrompidos, (unsigned long)estatisticas->atrasados,
+           (unsigned long)saida.estatisticas.enviados);
+    if (recebidos > 1 && duracao) {
+        uint64_t milli_fps = (uint64_t)(recebidos - 1) * 1000000000ull / duracao;
+        printf("taxa sustentada: %llu.%03llu fps em %llu ms\n", (unsigned long long)(milli_fps / 1000),
+               (unsigned long long)(milli_fps % 1000), (unsigned long long)(duracao / 1000));
+    }
+    if (emular && (emulado.pulsos_invalidos || emulado.bits_fora_periodo || emulado.erro)) {
+        printf("forma de onda inválida no emulador\n");
+        return 1;
+    }
+    return !recebidos || estatisticas->corrompidos || estatisticas->perdidos ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#include "pico/stdlib.h"
+
+static uint64_t agora_us; // Relógio virtual
+
+uint64_t time_us_64(void) {
+    return agora_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)agora_us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return agora_us;
+}
+
+void relogio_host_avancar(uint64_t us) {
+    agora_us += us;
+}
+
+void sleep_us(uint64_t us) {
+    agora_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+    agora_us += (uint64_t)ms * 1000;
+}
+
+void sleep_until(absolute_time_t instante) {
+    if (instante > agora_us) {
+        agora_us = instante;
+    }
+}
+
+void busy_wait_us(uint64_t us) {
+    agora_us += us;
+}
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <string.h>
+#include "acoes.h"
+#include "animacoes.h"
+#include "escalonador.h"
+#include "pico/stdlib.h"
+#include "repouso.h"
+#include "teclado.h"
+#include "transporte_emulado.h"
+
+// Passa a política de repouso pelo mesmo laço da placa, com o relógio
+// virtual, o escalonador e o emulador do PIO: teclas apertadas em instantes
+// fixos, a matriz apagando depois do tempo sem teclas, o sono até o próximo
+// aperto e um despertar sem tecla. O sono só pula o relógio até o aperto, e
+// a tecla é tratada TECLADO_DEBOUNCE_US depois, como na placa. Confere os
+// instantes de cada ação contra a inatividade contada aqui e que a matriz
+// fica apagada. Termina com erro se algo diferir.
+//
+// Uso: simular_repouso
+
+#define APAGAR_US 60000000ull
+#define DORMIR_US 240000000ull
+
+// Diferença tolerada entre a ação e o instante esperado: o envio emulado
+// avança o relógio virtual pelo tempo da transmissão
+#define TOLERANCIA_US 2000
+
+// Borda numa coluna; tecla 0 é um despertar sem tecla (aperto curto demais
+// para o debounce)
+typedef struct {
+    uint64_t instante_us;
+    char tecla;
+} aperto_t;
+
+static const aperto_t apertos[] = {
+    {1000000ull, 'A'},    // Azul parado: apaga 60 s depois e dorme mais 240 s depois
+    {1000000000ull, '5'}, // Acorda; a onda toca e só então conta a inatividade
+    {1100000000ull, 'B'}, // Com a matriz apagada, antes de dormir
+    {1600000000ull, 0},   // Acorda sem tecla e volta a dormir
+    {2000000000ull, 'C'}, // Acorda de novo
+};
+
+#define NUM_APERTOS (int)(sizeof(apertos) / sizeof(apertos[0]))
+
+static transporte_emulado_t transporte;
+static saida_leds_t saida;
+static escalonador_t escalonador;
+static repouso_t repouso;
+static int falhas;
+
+static void conferir_instante(const char *acao, uint64_t obtido, uint64_t esperado) {
+    bool ok = obtido >= esperado && obtido - esperado <= TOLERANCIA_US;
+    printf("%10.3f s  %-28s (esperado %.3f s)%s\n", obtido / 1e6, acao, esperado / 1e6, ok ? "" : "  FALHOU");
+    falhas += !ok;
+}
+
+static bool matriz_apagada(void) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        if (transporte.quadro[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint64_t menor(uint64_t a, uint64_t b) {
+    return a < b ? a : b;
+}
+
+int main(void) {
+    int proximo = 0;
+    uint64_t inicio_contagem = 0; // Início da inatividade que a política deve contar
+    bool tocando = false;
+
+    transporte_emulado_iniciar(&transporte);
+    saida_leds_iniciar(&saida, &transporte.base);
+    escalonador_iniciar(&escalonador, &saida);
+    repouso_iniciar(&repouso, APAGAR_US, DORMIR_US, time_us_64());
+
+    while (proximo < NUM_APERTOS || repouso.estado != REPOUSO_DORMINDO) {
+        // Tecla confirmada pelo debounce
+        if (proximo < NUM_APERTOS && apertos[proximo].tecla &&
+            apertos[proximo].instante_us + TECLADO_DEBOUNCE_US <= time_us_64()) {
+            bool acordou = repouso_atividade(&repouso, time_us_64());
+            printf("%10.3f s  tecla %c%s\n", time_us_64() / 1e6, apertos[proximo].tecla,
+                   acordou ? " (acordou a placa)" : "");
+            if (acordou && repouso.estatisticas.ultima_latencia_us != TECLADO_DEBOUNCE_US) {
+                printf("  latência do despertar %lu us, esperado %u us  FALHOU\n",
+                       (unsigned long)repouso.estatisticas.ultima_latencia_us, TECLADO_DEBOUNCE_US);
+                falhas++;
+            }
+            executar_acao_tecla(apertos[proximo].tecla, &escalonador, time_us_64());
+            inicio_contagem = time_us_64();
+            tocando = true;
+            proximo++;
+        }
+
+        escalonador_passo(&escalonador, time_us_64());
+        bool ocupado = !escalonador_concluido(&escalonador);
+        if (tocando && !ocupado) {
+            inicio_contagem = time_us_64(); // A inatividade conta do fim da animação
+            tocando = false;
+        }
+
+        switch (repouso_passo(&repouso, ocupado, time_us_64())) {
+            case REPOUSO_APAGAR:
+                conferir_instante("apaga a matriz", time_us_64(), inicio_contagem + APAGAR_US);
+                escalonador_tocar(&escalonador, &animacao_apagar, FPS(1), time_us_64());
+                inicio_contagem = time_us_64();
+                tocando = true;
+                break;
+            case REPOUSO_DORMIR:
+                conferir_instante("dorme", time_us_64(), inicio_contagem + DORMIR_US);
+                if (!matriz_apagada()) {
+                    printf("  matriz acesa ao dormir  FALHOU\n");
+                    falhas++;
+                }
+                if (proximo == NUM_APERTOS) {
+                    break; // Fim da simulação
+                }
+                // O sono dura até a borda do próximo aperto
+                sleep_until(apertos[proximo].instante_us);
+                repouso_despertou(&repouso, time_us_64(), time_us_64());
+                printf("%10.3f s  acorda%s\n", time_us_64() / 1e6, apertos[proximo].tecla ? "" : " sem tecla");
+                inicio_contagem = time_us_64();
+                if (!apertos[proximo].tecla) {
+                    proximo++;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // Mesmo cálculo do laço da placa, mais o próximo aperto
+        uint64_t prazo = menor(escalonador_prazo(&escalonador), repouso_prazo(&repouso));
+        if (proximo < NUM_APERTOS) {
+            prazo = menor(prazo, apertos[proximo].instante_us + TECLADO_DEBOUNCE_US);
+        }
+        if (prazo != UINT64_MAX && repouso.estado != REPOUSO_DORMINDO) {
+            sleep_until(prazo);
+        }
+    }
+
+    const repouso_estatisticas_t *e = &repouso.estatisticas;
+    printf("apagamentos %lu, sonos %lu, despertares %lu, sem tecla %lu, maior latência %lu us\n",
+           (unsigned long)e->apagamentos, (unsigned long)e->sonos, (unsigned long)e->despertares,
+           (unsigned long)e->despertares_sem_tecla, (unsigned long)e->maior_latencia_us);
+    if (e->apagamentos != 4 || e->sonos != 4 || e->despertares != 2 || e->despertares_sem_tecla != 1) {
+        printf("contadores diferentes de 4 apagamentos, 4 sonos, 2 despertares e 1 sem tecla  FALHOU\n");
+        falhas++;
+    }
+    falhas += transporte.pulsos_invalidos || transporte.bits_fora_periodo || transporte.erro;
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <string.h>
+#include "pio_emulador.h"
+#include "teclado.h"
+#include "teclado.pio.h"
+
+// Passa teclado.pio pelo emulador do PIO ligado a um modelo elétrico do
+// teclado 4x4: a coluna lê nível alto quando alguma tecla apertada a liga,
+// direto ou por outras teclas, a uma linha que está como saída. Confere,
+// com as teclas apertadas uma a uma, que o mapa enviado tem o bit
+// 16 + linha * 4 + coluna, que a máquina só envia quando o mapa muda, que
+// nunca há duas linhas como saída ao mesmo tempo e a latência até a FIFO
+// RX. Depois confere todos os acordes de 2 teclas e os de 3: sem diodos, as
+// que formam um "L" aparecem com a quarta tecla do retângulo (fantasma);
+// com diodos nas teclas, todas saem exatas. Termina com erro se algo diferir.
+//
+// Uso: simular_teclado
+
+// Relógio da máquina de estado configurado em teclado.c
+#define FREQUENCIA_HZ 400000
+
+// Ciclos de uma volta sem mudança: 4 linhas de 5 ciclos e 3 da comparação
+#define CICLOS_VOLTA 23
+
+static const uint8_t pinos_linhas[4] = {TECLADO_PIN_1, TECLADO_PIN_2, TECLADO_PIN_3, TECLADO_PIN_4};
+static const uint8_t pinos_colunas[4] = {COL1_PIN, COL2_PIN, COL3_PIN, COL4_PIN};
+
+#define MASCARA_LINHAS ((1u << TECLADO_PIN_1) | (1u << TECLADO_PIN_2) | (1u << TECLADO_PIN_3) | (1u << TECLADO_PIN_4))
+
+typedef struct {
+    uint16_t apertadas; // Bit linha * 4 + coluna
+    bool diodos;        // Cada tecla só conduz da linha para a coluna
+    bool curto;         // Duas linhas como saída ao mesmo tempo
+} teclado_modelo_t;
+
+static pio_emulador_t pio;
+static teclado_modelo_t modelo;
+static int falhas;
+
+static int contar_bits(uint32_t valor) {
+    int bits = 0;
+    for (; valor; valor &= valor - 1) {
+        bits++;
+    }
+    return bits;
+}
+
+// Linhas em nível alto que estão como saída (bit por linha)
+static uint8_t linhas_ativas(const pio_emulador_t *maquina) {
+    uint8_t ativas = 0;
+    for (int linha = 0; linha < 4; linha++) {
+        uint32_t bit = 1u << pinos_linhas[linha];
+        if ((maquina->direcoes & bit) && (maquina->pinos & bit)) {
+            ativas |= 1u << linha;
+        }
+    }
+    return ativas;
+}
+
+// Colunas em nível alto (bit por coluna). Sem diodos a corrente passa por
+// qualquer tecla nos dois sentidos, então uma coluna liga a outras linhas e
+// dali a outras colunas até nada mais mudar.
+static uint8_t colunas_altas(uint8_t linhas, uint16_t apertadas, bool diodos) {
+    uint8_t colunas = 0;
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int i = 0; i < 16; i++) {
+            if (!(apertadas & (1u << i))) {
+                continue;
+            }
+            uint8_t linha = 1u << (i / 4), coluna = 1u << (i % 4);
+            if ((linhas & linha) && !(colunas & coluna)) {
+                colunas |= coluna;
+                mudou = true;
+            }
+            if (!diodos && (colunas & coluna) && !(linhas & linha)) {
+                linhas |= linha;
+                mudou = true;
+            }
+        }
+    }
+    return colunas;
+}
+
+static uint32_t ler_pinos(const pio_emulador_t *maquina, void *contexto) {
+    teclado_modelo_t *teclado = contexto;
+    uint8_t linhas = linhas_ativas(maquina);
+    if (contar_bits(maquina->direcoes & MASCARA_LINHAS) > 1) {
+        teclado->curto = true;
+    }
+
+    uint8_t colunas = colunas_altas(linhas, teclado->apertadas, teclado->diodos);
+    uint32_t niveis = maquina->pinos & maquina->direcoes;
+    for (int coluna = 0; coluna < 4; coluna++) {
+        if (colunas & (1u << coluna)) {
+            niveis |= 1u << pinos_colunas[coluna];
+        }
+    }
+    return niveis;
+}
+
+// Mapa que a varredura deve encontrar: com diodos, as teclas apertadas;
+// sem eles, também as fantasmas
+static uint16_t mapa_esperado(uint16_t apertadas, bool diodos) {
+    uint16_t mapa = 0;
+    for (int linha = 0; linha < 4; linha++) {
+        uint8_t colunas = colunas_altas(1u << linha, apertadas, diodos);
+        mapa |= (uint16_t)colunas << (linha * 4);
+    }
+    return mapa;
+}
+
+static void iniciar(bool diodos) {
+    pio_emulador_iniciar(&pio, &teclado_program, teclado_wrap_target, teclado_wrap, 32);
+    pio_emulador_configurar_pinos(&pio, TECLADO_PIN_4, 5, COL4_PIN, TECLADO_PIN_2, 3, true, true);
+    pio.ler_pinos = ler_pinos;
+    pio.contexto_pinos = &modelo;
+    pio.pinos = MASCARA_LINHAS; // pio_sm_set_pins_with_mask da inicialização
+    pio.pc = teclado_offset_inicio;
+    memset(&modelo, 0, sizeof(modelo));
+    modelo.diodos = diodos;
+}
+
+// Executa a máquina por "ciclos" e retorna quantas palavras chegaram à FIFO
+// RX, com a última em "ultima"
+static int rodar(uint32_t ciclos, uint32_t *ultima, uint32_t *ciclos_ate_primeira) {
+    int recebidas = 0;
+    for (uint32_t c = 0; c < ciclos; c++) {
+        pio_emulador_ciclo(&pio);
+        uint32_t palavra;
+        while (pio_emulador_obter(&pio, &palavra)) {
+            if (!recebidas && ciclos_ate_primeira) {
+                *ciclos_ate_primeira = c + 1;
+            }
+            *ultima = palavra;
+            recebidas++;
+        }
+    }
+    return recebidas;
+}
+
+// Aperta as teclas de "apertadas" no meio de uma volta e confere o mapa
+// enviado depois de 3 voltas (mudanças no meio de uma volta podem chegar em
+// duas partes) e que nada mais é enviado com as teclas paradas
+static bool conferir_mapa(uint16_t apertadas, uint16_t esperado, int *enviadas) {
+    uint32_t ultima = 0;
+    rodar(7, &ultima, NULL); // Fora de fase com a volta
+    modelo.apertadas = apertadas;
+    *enviadas = rodar(3 * CICLOS_VOLTA, &ultima, NULL);
+    bool ok = *enviadas > 0 && ultima == (uint32_t)esperado << 16;
+    int depois = rodar(100 * CICLOS_VOLTA, &ultima, NULL);
+    return ok && depois == 0 && !pio.erro;
+}
+
+static void conferir_teclas_sozinhas(void) {
+    uint32_t maior_latencia = 0;
+    int enviadas_total = 0;
+
+    iniciar(false);
+    for (int i = 0; i < 16; i++) {
+        uint32_t ultima = 0, latencia = 0;
+
+        // Aperto: exatamente um envio, com o bit da tecla
+        modelo.apertadas = 1u << i;
+        int aperto = rodar(3 * CICLOS_VOLTA, &ultima, &latencia);
+        bool ok = aperto == 1 && ultima == 1u << (16 + i);
+        maior_latencia = latencia > maior_latencia ? latencia : maior_latencia;
+
+        // Tecla segurada: nada; soltura: um envio com o mapa vazio
+        ok = ok && rodar(100 * CICLOS_VOLTA, &ultima, NULL) == 0;
+        modelo.apertadas = 0;
+        int soltura = rodar(3 * CICLOS_VOLTA, &ultima, NULL);
+        ok = ok && soltura == 1 && ultima == 0;
+
+        enviadas_total += aperto + soltura;
+        if (!ok) {
+            printf("tecla linha %d coluna %d: %d envios no aperto, %d na soltura, ultimo %08lx  FALHOU\n", i / 4 + 1,
+                   i % 4 + 1, aperto, soltura, (unsigned long)ultima);
+            falhas++;
+        }
+    }
+
+    printf("teclas sozinhas: 16 apertos e solturas, %d envios para a FIFO RX, maior latência %lu ciclos (%lu us)\n",
+           enviadas_total, (unsigned long)maior_latencia,
+           (unsigned long)(maior_latencia * 1000000ull / FREQUENCIA_HZ));
+    printf("volta completa: %d ciclos (%lu us a %d kHz), %lu palavras perdidas\n", CICLOS_VOLTA,
+           (unsigned long)(CICLOS_VOLTA * 1000000ull / FREQUENCIA_HZ), FREQUENCIA_HZ / 1000,
+           (unsigned long)pio.rx_perdidos);
+    if (modelo.curto || pio.erro || pio.rx_perdidos) {
+        printf("duas linhas como saída, instrução não suportada ou FIFO cheia  FALHOU\n");
+        falhas++;
+    }
+}
+
+// Confere todos os acordes com "quant" teclas, com e sem diodos
+static void conferir_acordes(int quant, bool diodos) {
+    int acordes = 0, fantasmas = 0, errados = 0, max_envios = 0;
+
+    iniciar(diodos);
+    for (uint32_t apertadas = 1; apertadas < 0x10000; apertadas++) {
+        if (contar_bits(apertadas) != quant) {
+            continue;
+        }
+        int enviadas;
+        uint16_t esperado = mapa_esperado((uint16_t)apertadas, diodos);
+        if (!conferir_mapa((uint16_t)apertadas, esperado, &enviadas)) {
+            errados++;
+        }
+        modelo.apertadas = 0;
+        uint32_t ultima = 0;
+        rodar(3 * CICLOS_VOLTA, &ultima, NULL);
+
+        acordes++;
+        fantasmas += esperado != apertadas;
+        max_envios = enviadas > max_envios ? enviadas : max_envios;
+    }
+
+    printf("acordes de %d teclas %s diodos: %d conferidos, %d com tecla fantasma, até %d envios por mudança%s\n",
+           quant, diodos ? "com" : "sem", acordes, fantasmas, max_envios, errados ? "  FALHOU" : "");
+    falhas += errados != 0;
+    if (modelo.curto || (quant == 2 && fantasmas) || (diodos && fantasmas)) {
+        printf("  curto entre linhas ou fantasma onde não pode haver  FALHOU\n");
+        falhas++;
+    }
+}
+
+int main(void) {
+    conferir_teclas_sozinhas();
+
+    // '*' e '#' juntos: linha 4, colunas 1 e 3
+    int enviadas;
+    uint16_t acorde = (1u << 12) | (1u << 14);
+    iniciar(false);
+    bool ok = conferir_mapa(acorde, acorde, &enviadas);
+    printf("acorde * e #: mapa %04x em %d envio(s)%s\n", acorde, enviadas, ok ? "" : "  FALHOU");
+    falhas += !ok;
+
+    conferir_acordes(2, false);
+    conferir_acordes(3, false);
+    conferir_acordes(3, true);
+    conferir_acordes(16, false);
+
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+#include "transporte_emulado.h"
+
+#include <string.h>
+#include "animacao_MatrizLED.pio.h"
+#include "pico/stdlib.h"
+
+// Duração de cada bit em ciclos e largura dos pulsos altos de 1 e de 0,
+// dos atrasos do programa do tempo escolhido (formato_pixel.h)
+#define CICLOS_POR_BIT (PROGRAMA_LEDS(_T1) + PROGRAMA_LEDS(_T2) + PROGRAMA_LEDS(_T3))
+#define CICLOS_ALTO_UM (PROGRAMA_LEDS(_T1) + PROGRAMA_LEDS(_T2))
+#define CICLOS_ALTO_ZERO PROGRAMA_LEDS(_T1)
+
+// Acompanha o pino de uma via por um ciclo, montando bits e pixels
+static void decodificar(transporte_emulado_t *transporte, via_emulada_t *via) {
+    bool pino = via->pio.pinos & 1; // Side-set a partir do GPIO 0 do emulador
+
+    if (pino) {
+        if (!via->pino_anterior) {
+            // Subida: o período do bit anterior termina aqui
+            bool dentro_do_quadro = via->pixels_recebidos || via->bits;
+            if (dentro_do_quadro && via->ciclos_alto + via->ciclos_baixo != CICLOS_POR_BIT) {
+                transporte->bits_fora_periodo++;
+            }
+            if (!dentro_do_quadro && transporte->quadros && via == &transporte->vias[0] &&
+                via->ciclos_baixo < transporte->menor_latch_ciclos) {
+                transporte->menor_latch_ciclos = via->ciclos_baixo;
+            }
+            via->ciclos_alto = 0;
+        }
+        via->ciclos_alto++;
+    } else {
+        if (via->pino_anterior) {
+            // Descida: a largura do pulso define o bit
+            uint32_t alto = via->ciclos_alto;
+            if (alto != CICLOS_ALTO_UM && alto != CICLOS_ALTO_ZERO) {
+                transporte->pulsos_invalidos++;
+            }
+            via->palavra = (via->palavra << 1) | (alto > (CICLOS_ALTO_UM + CICLOS_ALTO_ZERO) / 2);
+            if (++via->bits == PIXEL_BITS) {
+                if (via->pixels_recebidos < PIXELS_POR_VIA) {
+                    via->destino[via->pixels_recebidos] = via->palavra << PIXEL_DESLOCAMENTO_MINIMO;
+                } else {
+                    transporte->pixels_excedentes++;
+                }
+                via->pixels_recebidos++;
+                via->bits = 0;
+            }
+            via->ciclos_baixo = 0;
+        }
+        via->ciclos_baixo++;
+        if (via->ciclos_baixo == EMULADOR_CICLOS_RESET && (via->pixels_recebidos || via->bits)) {
+            // Fim do quadro
+            if (via == &transporte->vias[0]) {
+                transporte->quadros++;
+            }
+            via->pixels_recebidos = 0;
+            via->bits = 0;
+        }
+    }
+    via->pino_anterior = pino;
+}
+
+// Avança todas as vias um ciclo
+static void passo(transporte_emulado_t *transporte) {
+    for (int i = 0; i < MATRIZ_VIAS; i++) {
+        via_emulada_t *via = &transporte->vias[i];
+        uint64_t parados = via->pio.ciclos_parados;
+        pio_emulador_ciclo(&via->pio);
+        transporte->ciclos_parados += via->pio.ciclos_parados - parados;
+        transporte->erro |= via->pio.erro;
+        decodificar(transporte, via);
+    }
+}
+
+static bool vias_ociosas(const transporte_emulado_t *transporte) {
+    for (int i = 0; i < MATRIZ_VIAS; i++) {
+        if (!pio_emulador_ocioso(&transporte->vias[i].pio)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void enviar(transporte_leds_t *base, const uint32_t *pixels, uint32_t num_pixels) {
+    transporte_emulado_t *transporte = (transporte_emulado_t *)base;
+    uint32_t por_via = num_pixels / MATRIZ_VIAS;
+    uint32_t enviados[MATRIZ_VIAS] = {0};
+    uint64_t inicio = transporte->vias[0].pio.ciclo;
+
+    // Mesmo papel dos canais de DMA: cada via recebe a próxima palavra do
+    // seu trecho assim que houver espaço na sua FIFO
+    bool pendente = true;
+    while (pendente) {
+        pendente = false;
+        for (int i = 0; i < MATRIZ_VIAS; i++) {
+            if (enviados[i] < por_via &&
+                pio_emulador_colocar(&transporte->vias[i].pio, pixels[i * por_via + enviados[i]])) {
+                enviados[i]++;
+            }
+            pendente |= enviados[i] < por_via;
+        }
+        if (pendente) {
+            passo(transporte);
+        }
+    }
+    while (!vias_ociosas(transporte) && !transporte->erro) {
+        passo(transporte);
+    }
+
+    // Nível baixo pelo tempo de latch, para a matriz aplicar o quadro
+    for (int i = 0; i < MATRIZ_LATCH_US * EMULADOR_CICLOS_POR_US; i++) {
+        passo(transporte);
+    }
+
+    transporte->ultimo_envio_us = (transporte->vias[0].pio.ciclo - inicio) / EMULADOR_CICLOS_POR_US;
+    relogio_host_avancar(transporte->ultimo_envio_us);
+}
+
+static bool ocupado(transporte_leds_t *base) {
+    (void)base;
+    return false; // enviar() só retorna com a transmissão concluída
+}
+
+// Modo DMA: só dispara o quadro; as palavras entram nas FIFOs em ocupado()
+static void enviar_dma(transporte_leds_t *base, const uint32_t *pixels, uint32_t num_pixels) {
+    transporte_emulado_t *transporte = (transporte_emulado_t *)base;
+    transporte->pixels_dma = pixels;
+    transporte->por_via_dma = num_pixels / MATRIZ_VIAS;
+    for (int i = 0; i < MATRIZ_VIAS; i++) {
+        transporte->vias[i].enviados = 0;
+    }
+    fim_envio_iniciar(&transporte->fim);
+}
+
+// Avança 1 us: a cada ciclo as máquinas executam e depois o DMA emulado
+// entrega uma palavra a cada FIFO com espaço, então as máquinas paradas
+// marcam TXSTALL antes de a primeira palavra do quadro chegar, como na placa
+static bool ocupado_dma(transporte_leds_t *base) {
+    transporte_emulado_t *transporte = (transporte_emulado_t *)base;
+    bool dma_ocupado = false, vias_paradas = true;
+
+    for (int c = 0; c < EMULADOR_CICLOS_POR_US; c++) {
+        passo(transporte);
+        for (int i = 0; i < MATRIZ_VIAS; i++) {
+            via_emulada_t *via = &transporte->vias[i];
+            if (transporte->pixels_dma && via->enviados < transporte->por_via_dma &&
+                pio_emulador_colocar(&via->pio, transporte->pixels_dma[i * transporte->por_via_dma + via->enviados])) {
+                via->enviados++;
+            }
+        }
+    }
+    relogio_host_avancar(1);
+
+    for (int i = 0; i < MATRIZ_VIAS; i++) {
+        dma_ocupado |= transporte->pixels_dma && transporte->vias[i].enviados < transporte->por_via_dma;
+        vias_paradas &= transporte->vias[i].pio.tx_parada;
+    }
+    switch (fim_envio_passo(&transporte->fim, dma_ocupado, vias_paradas, time_us_64())) {
+        case FIM_ENVIO_LIMPAR_PARADAS:
+            for (int i = 0; i < MATRIZ_VIAS; i++) {
+                transporte->vias[i].pio.tx_parada = false;
+            }
+            return true;
+        case FIM_ENVIO_LIVRE:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void transporte_emulado_iniciar_dma(transporte_emulado_t *transporte) {
+    transporte_emulado_iniciar(transporte);
+    transporte->base.enviar = enviar_dma;
+    transporte->base.ocupado = ocupado_dma;
+}
+
+void transporte_emulado_iniciar(transporte_emulado_t *transporte) {
+    memset(transporte, 0, sizeof(*transporte));
+    transporte->base.enviar = enviar;
+    transporte->base.ocupado = ocupado;
+    transporte->menor_latch_ciclos = UINT32_MAX;
+    for (int i = 0; i < MATRIZ_VIAS; i++) {
+        via_emulada_t *via = &transporte->vias[i];
+        pio_emulador_iniciar(&via->pio, &PROGRAMA_LEDS(_program), PROGRAMA_LEDS(_wrap_target),
+                             PROGRAMA_LEDS(_wrap), PIXEL_BITS);
+        pio_emulador_configurar_pinos(&via->pio, 0, 1, 0, 0, 1, false, false);
+        via->destino = &transporte->quadro[i * PIXELS_POR_VIA];
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TRANSPORTE_EMULADO_H
+#define TRANSPORTE_EMULADO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "fim_envio.h"
+#include "pio_emulador.h"
+#include "saida_leds.h"
+
+// Frequência da máquina de estado (animacao_MatrizLED_program_init)
+#define EMULADOR_CICLOS_POR_US 8
+
+// Tempo em nível baixo que a matriz entende como fim de quadro (reset)
+#define EMULADOR_CICLOS_RESET (50 * EMULADOR_CICLOS_POR_US)
+
+_Static_assert(MATRIZ_LATCH_US * EMULADOR_CICLOS_POR_US >= EMULADOR_CICLOS_RESET,
+               "MATRIZ_LATCH_US menor que o reset do WS2812");
+
+// Uma via: máquina de estado emulada e decodificação da forma de onda do seu pino
+typedef struct {
+    pio_emulador_t pio;
+    bool pino_anterior;
+    uint32_t ciclos_alto;     // Duração do pulso alto atual
+    uint32_t ciclos_baixo;    // Tempo em nível baixo desde a última descida
+    uint32_t palavra;         // Bits do pixel em montagem
+    uint32_t enviados;        // Palavras do quadro já entregues pelo DMA emulado
+    uint8_t bits;
+    uint32_t pixels_recebidos;
+    uint32_t *destino;        // Trecho do quadro decodificado desta via
+} via_emulada_t;
+
+// Transporte do host: executa o programa animacao_MatrizLED do tempo
+// escolhido no emulador, uma máquina por via, ciclo a ciclo e em paralelo,
+// e decodifica a forma de onda de cada pino de volta em pixels no formato
+// de formato_pixel.h. O envio é síncrono e avança o
+// relógio virtual pelo tempo da transmissão; no modo DMA
+// (transporte_emulado_iniciar_dma) enviar() só dispara o quadro e cada
+// chamada de ocupado() avança 1 us, com a mesma decisão de fim de quadro e
+// latch do transporte da placa (fim_envio.h).
+typedef struct {
+    transporte_leds_t base; // Deve ser o primeiro campo
+    via_emulada_t vias[MATRIZ_VIAS];
+
+    uint32_t quadro[NUM_PIXELS]; // Último quadro decodificado (todas as vias)
+    uint32_t quadros;            // Quadros decodificados (contados na via 0)
+    uint32_t pulsos_invalidos;   // Pulsos altos que não duram nem T1 nem T1 + T2 ciclos
+    uint32_t bits_fora_periodo;  // Bits com período diferente de T1 + T2 + T3 ciclos
+    uint32_t pixels_excedentes;  // Pixels além de PIXELS_POR_VIA no mesmo quadro
+    uint64_t ciclos_parados;     // Soma das vias
+    uint32_t ultimo_envio_us;    // Duração do último envio, com o latch
+    uint32_t menor_latch_ciclos; // Menor tempo em nível baixo entre dois quadros (via 0)
+    bool erro;                   // Alguma via encontrou instrução não suportada
+
+    // Modo DMA
+    const uint32_t *pixels_dma;  // Quadro sendo entregue às FIFOs
+    uint32_t por_via_dma;
+    fim_envio_t fim;
+} transporte_emulado_t;
+
+// Carrega o programa animacao_MatrizLED no emulador de cada via
+void transporte_emulado_iniciar(transporte_emulado_t *transporte);
+
+// Como transporte_emulado_iniciar(), no modo DMA
+void transporte_emulado_iniciar_dma(transporte_emulado_t *transporte);
+
+#endif
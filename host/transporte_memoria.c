@@ -0,0 +1,23 @@
+#include "transporte_memoria.h"
+
+#include <string.h>
+
+static void enviar(transporte_leds_t *base, const uint32_t *pixels, uint32_t num_pixels) {
+    transporte_memoria_t *transporte = (transporte_memoria_t *)base;
+    if (transporte->copiar) {
+        memcpy(transporte->quadro, pixels, num_pixels * sizeof(uint32_t));
+    }
+    transporte->quadros++;
+}
+
+static bool ocupado(transporte_leds_t *base) {
+    (void)base;
+    return false;
+}
+
+void transporte_memoria_iniciar(transporte_memoria_t *transporte, bool copiar) {
+    memset(transporte, 0, sizeof(*transporte));
+    transporte->base.enviar = enviar;
+    transporte->base.ocupado = ocupado;
+    transporte->copiar = copiar;
+}
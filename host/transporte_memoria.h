@@ -0,0 +1,24 @@
+#ifndef TRANSPORTE_MEMORIA_H
+#define TRANSPORTE_MEMORIA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "saida_leds.h"
+
+// Transporte do host sem forma de onda, para medir só o lado do processador:
+// cada envio é contado e, com "copiar", o quadro é copiado para "quadro"
+// como o DMA o leria. Nunca fica ocupado.
+typedef struct {
+    transporte_leds_t base; // Deve ser o primeiro campo
+    bool copiar;
+    uint32_t quadro[NUM_PIXELS]; // Último quadro enviado (só com copiar)
+    uint32_t quadros;            // Quadros enviados
+} transporte_memoria_t;
+
+// Função para preparar o transporte em memória
+// Parâmetros:
+// - transporte: Transporte a ser preparado
+// - copiar: true copia cada quadro, false só conta (descarta)
+void transporte_memoria_iniciar(transporte_memoria_t *transporte, bool copiar);
+
+#endif
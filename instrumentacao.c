@@ -0,0 +1,269 @@
+#include "instrumentacao.h"
+
+#if MATRIZ_INSTRUMENTACAO
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+
+// Histograma do tempo de quadro: 1 µs de resolução até 15 µs e, acima disso,
+// 4 baldes por potência de 2 (erro de até 25%) até ~1 s
+#define BALDES_EXATOS 16
+#define MAIOR_EXPOENTE 19
+#define BALDES (BALDES_EXATOS + (MAIOR_EXPOENTE - 3) * 4)
+
+// Resumo de uma animação, escrito só pelo núcleo que desenha. O console lê
+// sem trava, então um resumo impresso durante um quadro pode misturar
+// valores de antes e depois dele.
+typedef struct {
+    const animacao_t *animacao;
+    uint32_t quadros;
+    uint64_t soma_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t soma_atraso_us;
+    uint32_t max_atraso_us;
+    uint32_t max_espera_us;
+    uint32_t periodo_us;
+    uint64_t soma_intervalos_us; // Entre inícios de quadros consecutivos
+    uint32_t intervalos;
+    uint32_t ultimo_inicio_us;
+    uint16_t ultimo_quadro;
+    uint32_t histograma[BALDES];
+} resumo_t;
+
+static resumo_t resumos[INSTRUMENTACAO_ANIMACOES];
+static uint8_t quant_resumos;
+static volatile bool pedido_zerar;
+
+// Anel de registros com um produtor (quem desenha) e um consumidor (o
+// console). Os índices só crescem; cada lado escreve apenas o seu.
+static registro_quadro_t anel[INSTRUMENTACAO_REGISTROS];
+static uint32_t escrita;
+static uint32_t leitura;
+static volatile uint32_t registros_perdidos;
+
+static volatile uint32_t ultimo_fim_envio_us;
+
+uint32_t instrumentacao_agora(void) {
+    return time_us_32();
+}
+
+static uint32_t balde(uint32_t us) {
+    if (us < BALDES_EXATOS) {
+        return us;
+    }
+    uint32_t expoente = 31 - __builtin_clz(us);
+    if (expoente > MAIOR_EXPOENTE) {
+        return BALDES - 1;
+    }
+    return BALDES_EXATOS + (expoente - 4) * 4 + ((us >> (expoente - 2)) & 3);
+}
+
+// Maior tempo que cai no balde
+static uint32_t limite_balde(uint32_t indice) {
+    if (indice < BALDES_EXATOS) {
+        return indice;
+    }
+    uint32_t expoente = (indice - BALDES_EXATOS) / 4 + 4;
+    uint32_t mantissa = (indice - BALDES_EXATOS) % 4;
+    return ((4 + mantissa + 1) << (expoente - 2)) - 1;
+}
+
+static uint8_t indice_resumo(const animacao_t *animacao) {
+    for (uint8_t i = 0; i < quant_resumos; i++) {
+        if (resumos[i].animacao == animacao) {
+            return i;
+        }
+    }
+    if (quant_resumos == INSTRUMENTACAO_ANIMACOES) {
+        return UINT8_MAX;
+    }
+    resumos[quant_resumos].animacao = animacao;
+    resumos[quant_resumos].min_us = UINT32_MAX;
+    return quant_resumos++;
+}
+
+static uint16_t saturar_16(uint32_t valor) {
+    return valor > UINT16_MAX ? UINT16_MAX : (uint16_t)valor;
+}
+
+void instrumentacao_registrar_quadro(const animacao_t *animacao, uint16_t quadro, uint32_t periodo_us,
+                                     uint32_t prazo_us, uint32_t acordou_us, uint32_t inicio_desenho_us,
+                                     uint32_t fim_desenho_us, uint32_t fim_apresentacao_us,
+                                     uint16_t pixels_alterados, bool suprimido) {
+    if (pedido_zerar) {
+        memset(resumos, 0, sizeof(resumos));
+        quant_resumos = 0;
+        pedido_zerar = false;
+    }
+
+    uint8_t indice = indice_resumo(animacao);
+    uint32_t desenho = fim_desenho_us - inicio_desenho_us;
+    uint32_t espera = fim_apresentacao_us - fim_desenho_us;
+    uint32_t atraso = acordou_us - prazo_us;
+
+    if (indice != UINT8_MAX) {
+        resumo_t *resumo = &resumos[indice];
+        uint32_t tempo = desenho + espera;
+
+        if (resumo->quadros && quadro == resumo->ultimo_quadro + 1) {
+            resumo->soma_intervalos_us += inicio_desenho_us - resumo->ultimo_inicio_us;
+            resumo->intervalos++;
+        }
+        resumo->ultimo_inicio_us = inicio_desenho_us;
+        resumo->ultimo_quadro = quadro;
+        resumo->periodo_us = periodo_us;
+
+        resumo->quadros++;
+        resumo->soma_us += tempo;
+        if (tempo < resumo->min_us) resumo->min_us = tempo;
+        if (tempo > resumo->max_us) resumo->max_us = tempo;
+        resumo->soma_atraso_us += atraso;
+        if (atraso > resumo->max_atraso_us) resumo->max_atraso_us = atraso;
+        if (espera > resumo->max_espera_us) resumo->max_espera_us = espera;
+        resumo->histograma[balde(tempo)]++;
+    }
+
+    uint32_t posicao = escrita;
+    if (posicao - __atomic_load_n(&leitura, __ATOMIC_ACQUIRE) >= INSTRUMENTACAO_REGISTROS) {
+        registros_perdidos++; // Console não esvaziou o anel a tempo
+        return;
+    }
+    anel[posicao & (INSTRUMENTACAO_REGISTROS - 1)] = (registro_quadro_t){
+        .prazo_us = prazo_us,
+        .inicio_desenho_us = inicio_desenho_us,
+        .fim_envio_anterior_us = ultimo_fim_envio_us,
+        .atraso_us = saturar_16(atraso),
+        .desenho_us = saturar_16(desenho),
+        .espera_us = saturar_16(espera),
+        .quadro = quadro,
+        .periodo_ms = saturar_16(periodo_us / 1000),
+        .pixels_alterados = pixels_alterados,
+        .animacao = indice,
+        .suprimido = suprimido,
+    };
+    __atomic_store_n(&escrita, posicao + 1, __ATOMIC_RELEASE);
+}
+
+void instrumentacao_envio_concluido(uint32_t agora_us) {
+    ultimo_fim_envio_us = agora_us;
+}
+
+// Retira o registro mais antigo do anel
+// Retorna:
+// - false se o anel estiver vazio
+static bool retirar(registro_quadro_t *registro) {
+    uint32_t posicao = leitura;
+    if (posicao == __atomic_load_n(&escrita, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *registro = anel[posicao & (INSTRUMENTACAO_REGISTROS - 1)];
+    __atomic_store_n(&leitura, posicao + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static const char *nome_animacao(uint8_t indice) {
+    if (indice >= quant_resumos || resumos[indice].animacao->nome == NULL) {
+        return "?";
+    }
+    return resumos[indice].animacao->nome;
+}
+
+void instrumentacao_exportar_csv(void) {
+    registro_quadro_t atual, proximo;
+
+    printf("animacao,quadro,periodo_ms,prazo_us,atraso_us,inicio_desenho_us,desenho_us,espera_us,fim_envio_us,"
+           "suprimido,pixels_alterados\n");
+    if (!retirar(&atual)) {
+        printf("# perdidos=%lu\n", (unsigned long)registros_perdidos);
+        return;
+    }
+
+    // O fim do envio de um quadro só é conhecido no registro do quadro seguinte
+    bool tem_proximo;
+    do {
+        tem_proximo = retirar(&proximo);
+        uint32_t fim_envio = tem_proximo ? proximo.fim_envio_anterior_us : ultimo_fim_envio_us;
+        if (atual.suprimido || fim_envio == 0 || (int32_t)(fim_envio - atual.inicio_desenho_us) <= 0) {
+            fim_envio = 0; // Quadro não enviado ou envio ainda em andamento
+        }
+
+        printf("%s,%u,%u,%lu,%u,%lu,%u,%u,%lu,%u,", nome_animacao(atual.animacao),
+               atual.quadro, atual.periodo_ms, (unsigned long)atual.prazo_us, atual.atraso_us,
+               (unsigned long)atual.inicio_desenho_us, atual.desenho_us, atual.espera_us,
+               (unsigned long)fim_envio, atual.suprimido);
+        if (atual.pixels_alterados != UINT16_MAX) {
+            printf("%u", atual.pixels_alterados);
+        }
+        printf("\n");
+        atual = proximo;
+    } while (tem_proximo);
+
+    printf("# perdidos=%lu\n", (unsigned long)registros_perdidos);
+}
+
+void instrumentacao_exportar_binario(void) {
+    // Cabeçalho: "MQ", versão, tamanho do registro e quantidade de registros
+    // (32 bits, little-endian); em seguida os registros como estão na memória
+    uint32_t quantidade = __atomic_load_n(&escrita, __ATOMIC_ACQUIRE) - leitura;
+    uint8_t cabecalho[8] = {'M', 'Q', 2, sizeof(registro_quadro_t),
+                            quantidade & 0xFF, (quantidade >> 8) & 0xFF,
+                            (quantidade >> 16) & 0xFF, quantidade >> 24};
+    fwrite(cabecalho, 1, sizeof(cabecalho), stdout);
+
+    registro_quadro_t registro;
+    for (uint32_t i = 0; i < quantidade && retirar(&registro); i++) {
+        fwrite(&registro, sizeof(registro), 1, stdout);
+    }
+    fflush(stdout);
+}
+
+// Imprime um valor em milésimos como inteiro com três casas decimais
+static void imprimir_milesimos(uint32_t milesimos) {
+    printf("  %6lu.%03lu", (unsigned long)(milesimos / 1000), (unsigned long)(milesimos % 1000));
+}
+
+void instrumentacao_imprimir_resumo(void) {
+    printf("animacao              quadros  min_us  med_us  max_us  p99_us  fps_pedido  fps_obtido"
+           "  atraso_med  atraso_max  espera_max\n");
+
+    for (uint8_t i = 0; i < quant_resumos; i++) {
+        const resumo_t *resumo = &resumos[i];
+        if (resumo->quadros == 0) {
+            continue;
+        }
+
+        // p99: limite do balde em que o histograma acumulado passa de 99%
+        uint32_t alvo = resumo->quadros - resumo->quadros / 100;
+        uint32_t acumulado = 0;
+        uint32_t p99 = 0;
+        for (uint32_t b = 0; b < BALDES; b++) {
+            acumulado += resumo->histograma[b];
+            if (acumulado >= alvo) {
+                p99 = limite_balde(b);
+                break;
+            }
+        }
+        if (p99 > resumo->max_us) {
+            p99 = resumo->max_us;
+        }
+
+        printf("%-20s %8lu %7lu %7lu %7lu %7lu", nome_animacao(i), (unsigned long)resumo->quadros,
+               (unsigned long)resumo->min_us, (unsigned long)(resumo->soma_us / resumo->quadros),
+               (unsigned long)resumo->max_us, (unsigned long)p99);
+        imprimir_milesimos(resumo->periodo_us ? 1000000000u / resumo->periodo_us : 0);
+        imprimir_milesimos(resumo->soma_intervalos_us
+                               ? (uint32_t)(1000000000ull * resumo->intervalos / resumo->soma_intervalos_us)
+                               : 0);
+        printf("  %10lu  %10lu  %10lu\n", (unsigned long)(resumo->soma_atraso_us / resumo->quadros),
+               (unsigned long)resumo->max_atraso_us, (unsigned long)resumo->max_espera_us);
+    }
+    printf("registros perdidos: %lu\n", (unsigned long)registros_perdidos);
+}
+
+void instrumentacao_zerar(void) {
+    pedido_zerar = true;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef INSTRUMENTACAO_H
+#define INSTRUMENTACAO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "animacoes.h"
+
+// Liga a medição de tempo de cada quadro. Desligada (0), todas as funções
+// abaixo viram funções vazias e somem do código gerado.
+#ifndef MATRIZ_INSTRUMENTACAO
+#define MATRIZ_INSTRUMENTACAO 0
+#endif
+
+// Capacidade do anel de registros (potência de 2)
+#define INSTRUMENTACAO_REGISTROS 128
+
+// Quantidade máxima de animações com resumo próprio
+#define INSTRUMENTACAO_ANIMACOES 16
+
+// Registro de um quadro apresentado pelo escalonador. Todos os instantes vêm
+// do contador de microssegundos (time_us_32).
+typedef struct {
+    uint32_t prazo_us;              // Instante em que o quadro deveria começar
+    uint32_t inicio_desenho_us;     // Início de desenhar()
+    uint32_t fim_envio_anterior_us; // Fim do DMA do quadro anterior (0 se desconhecido)
+    uint16_t atraso_us;             // Quanto o laço acordou depois do prazo
+    uint16_t desenho_us;            // Duração de desenhar()
+    uint16_t espera_us;             // Tempo parado em saida_leds_apresentar() esperando o envio anterior
+    uint16_t quadro;                // Índice do quadro na animação
+    uint16_t periodo_ms;            // Período pedido (1000 / fps)
+    uint16_t pixels_alterados;      // Diferença para o quadro anterior (UINT16_MAX se não contada)
+    uint8_t animacao;               // Índice da animação no resumo
+    uint8_t suprimido;              // 1 se o quadro era igual ao anterior e não foi enviado
+    uint16_t reservado;
+} registro_quadro_t;
+
+#if MATRIZ_INSTRUMENTACAO
+
+// Instante atual para as medições
+uint32_t instrumentacao_agora(void);
+
+// Registra um quadro apresentado. Chamada só pelo núcleo que desenha.
+// Parâmetros:
+// - animacao: Animação ativa
+// - quadro: Índice do quadro apresentado
+// - periodo_us: Período pedido para a animação
+// - prazo_us: Prazo do quadro
+// - acordou_us: Instante em que o laço chamou escalonador_passo()
+// - inicio_desenho_us: Instante antes de desenhar()
+// - fim_desenho_us: Instante depois de desenhar()
+// - fim_apresentacao_us: Instante depois de saida_leds_apresentar()
+// - pixels_alterados: Pixels diferentes do quadro anterior (UINT16_MAX se não contados)
+// - suprimido: O quadro não foi enviado por ser igual ao anterior
+void instrumentacao_registrar_quadro(const animacao_t *animacao, uint16_t quadro, uint32_t periodo_us,
+                                     uint32_t prazo_us, uint32_t acordou_us, uint32_t inicio_desenho_us,
+                                     uint32_t fim_desenho_us, uint32_t fim_apresentacao_us,
+                                     uint16_t pixels_alterados, bool suprimido);
+
+// Marca o fim de um envio (chamada pela interrupção do DMA)
+void instrumentacao_envio_concluido(uint32_t agora_us);
+
+// Esvaziam o anel de registros no stdio. Chamadas só pelo núcleo do console.
+void instrumentacao_exportar_csv(void);
+void instrumentacao_exportar_binario(void);
+
+// Imprime, por animação, mín/média/máx/p99 do tempo de quadro (desenho +
+// espera), fps pedido e alcançado e o atraso ao acordar
+void instrumentacao_imprimir_resumo(void);
+
+// Pede ao núcleo que desenha para zerar os resumos no próximo quadro
+void instrumentacao_zerar(void);
+
+#else
+
+static inline uint32_t instrumentacao_agora(void) {
+    return 0;
+}
+
+static inline void instrumentacao_registrar_quadro(const animacao_t *animacao, uint16_t quadro, uint32_t periodo_us,
+                                                   uint32_t prazo_us, uint32_t acordou_us, uint32_t inicio_desenho_us,
+                                                   uint32_t fim_desenho_us, uint32_t fim_apresentacao_us,
+                                                   uint16_t pixels_alterados, bool suprimido) {
+    (void)animacao; (void)quadro; (void)periodo_us; (void)prazo_us; (void)acordou_us;
+    (void)inicio_desenho_us; (void)fim_desenho_us; (void)fim_apresentacao_us;
+    (void)pixels_alterados; (void)suprimido;
+}
+
+static inline void instrumentacao_envio_concluido(uint32_t agora_us) {
+    (void)agora_us;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+#include "interpretador.h"
+
+#include <string.h>
+#include "geometria.h"
+
+static inline uint16_t ler16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t ler32(const uint8_t *p) {
+    return (uint32_t)ler16(p) | (uint32_t)ler16(p + 2) << 16;
+}
+
+// Contador de pedidos para estado_interpretador_t.uso (nunca 0)
+static uint32_t pedidos;
+
+static void reiniciar(estado_interpretador_t *estado) {
+    memset(estado, 0, sizeof(*estado));
+    estado->desenho = SEM_DESENHO;
+}
+
+// Escolhe o estado que chega ao quadro "indice" com menos instruções: o de
+// maior início que não passou dele ou, sem nenhum, o usado há mais tempo
+// (reiniciado)
+static estado_interpretador_t *escolher_estado(const programa_animacao_t *programa, uint16_t indice) {
+    estado_interpretador_t *melhor = NULL, *antigo = &programa->estados[0];
+    for (int e = 0; e < INTERPRETADOR_ESTADOS; e++) {
+        estado_interpretador_t *estado = &programa->estados[e];
+        if (estado->uso && estado->inicio <= indice && (!melhor || estado->inicio > melhor->inicio)) {
+            melhor = estado;
+        }
+        if (estado->uso < antigo->uso) {
+            antigo = estado;
+        }
+    }
+    if (!melhor) {
+        melhor = antigo;
+        reiniciar(melhor);
+    }
+    if (++pedidos == 0) {
+        pedidos = 1;
+    }
+    melhor->uso = pedidos;
+    return melhor;
+}
+
+// Executores das instruções: recebem os operandos (logo após o byte de
+// operação) e a posição da instrução; estado->pc já aponta para a seguinte
+typedef void (*executar_t)(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao);
+
+static void executar_paleta(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    (void)posicao;
+    cor_paleta_t *cor = &estado->paleta[operandos[0] % INTERPRETADOR_REGISTRADORES];
+    cor->r = ler16(operandos + 1);
+    cor->g = ler16(operandos + 3);
+    cor->b = ler16(operandos + 5);
+}
+
+// Preenchimento e onda são desenhados a partir dos próprios operandos
+static void executar_desenho(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    (void)operandos;
+    estado->desenho = posicao;
+}
+
+static void executar_mascara(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    estado->cor = operandos[0] % INTERPRETADOR_REGISTRADORES;
+    estado->mascara = ler32(operandos + 1);
+    estado->desenho = posicao;
+}
+
+static void executar_acender(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    estado->cor = operandos[0] % INTERPRETADOR_REGISTRADORES;
+    estado->mascara |= 1u << (operandos[1] & 31);
+    estado->desenho = posicao;
+}
+
+static void executar_quadro(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    (void)posicao;
+    estado->inicio = estado->emitidos;
+    estado->emitidos += operandos[0];
+}
+
+static void executar_repetir(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    (void)posicao;
+    if (estado->profundidade < INTERPRETADOR_PROFUNDIDADE) {
+        estado->lacos[estado->profundidade].corpo = estado->pc;
+        estado->lacos[estado->profundidade].restantes = operandos[0];
+        estado->profundidade++;
+    }
+}
+
+static void executar_fim(estado_interpretador_t *estado, const uint8_t *operandos, uint16_t posicao) {
+    (void)operandos;
+    (void)posicao;
+    if (estado->profundidade == 0) {
+        return;
+    }
+    if (--estado->lacos[estado->profundidade - 1].restantes) {
+        estado->pc = estado->lacos[estado->profundidade - 1].corpo;
+    } else {
+        estado->profundidade--;
+    }
+}
+
+// Tamanho total e executor de cada instrução, indexados pelo byte de operação
+static const struct {
+    uint8_t tamanho;
+    executar_t executar;
+} instrucoes[OP_QUANTIDADE] = {
+    [OP_PALETA] = {8, executar_paleta},
+    [OP_PREENCHER] = {2, executar_desenho},
+    [OP_MASCARA] = {6, executar_mascara},
+    [OP_ACENDER] = {3, executar_acender},
+    [OP_ONDA] = {16, executar_desenho},
+    [OP_QUADRO] = {2, executar_quadro},
+    [OP_REPETIR] = {2, executar_repetir},
+    [OP_FIM] = {1, executar_fim},
+};
+
+// Executa o programa até o desenho que mostra o quadro "indice"
+// Retorna:
+// - Estado com esse desenho
+static const estado_interpretador_t *avancar(const programa_animacao_t *programa, uint16_t indice) {
+    estado_interpretador_t *estado = escolher_estado(programa, indice);
+
+    while (estado->emitidos <= indice && estado->pc < programa->tamanho) {
+        uint16_t posicao = estado->pc;
+        const uint8_t *instrucao = programa->codigo + posicao;
+        uint8_t op = instrucao[0];
+        if (op == 0 || op >= OP_QUANTIDADE || posicao + instrucoes[op].tamanho > programa->tamanho) {
+            break; // Bytecode inválido: mantém o último desenho
+        }
+        estado->pc = (uint16_t)(posicao + instrucoes[op].tamanho);
+        instrucoes[op].executar(estado, instrucao + 1, posicao);
+    }
+    return estado;
+}
+
+// Operandos de OP_ONDA decodificados uma vez por quadro
+typedef struct {
+    uint8_t canais;
+    uint32_t periodo;
+    uint32_t passo;
+    uint32_t divisor;
+    fase_t fases[3]; // R, G, B
+} onda_t;
+
+static void decodificar_onda(onda_t *onda, const uint8_t *operandos) {
+    onda->canais = operandos[0];
+    onda->periodo = ler16(operandos + 1);
+    onda->passo = ler32(operandos + 3);
+    onda->divisor = ler16(operandos + 7);
+    onda->periodo = onda->periodo == ONDA_NUM_PIXELS ? NUM_PIXELS : onda->periodo;
+    onda->divisor = onda->divisor == ONDA_NUM_PIXELS ? NUM_PIXELS : onda->divisor;
+    onda->divisor = onda->divisor ? onda->divisor : 1; // Bytecode inválido não divide por zero
+    for (int c = 0; c < 3; c++) {
+        onda->fases[c] = ler16(operandos + 9 + 2 * c);
+    }
+}
+
+// Cor do pixel i no quadro t; a fase é ((t + i) mod periodo) * passo / divisor,
+// ou com ONDA_FRACAO ((t + i) mod periodo) * passo em fase32_t
+static inline cor_paleta_t cor_onda(const onda_t *onda, uint16_t t, int i) {
+    uint32_t k = (uint32_t)t + (uint32_t)i;
+    if (onda->periodo) {
+        k %= onda->periodo;
+    }
+    fase_t fase = onda->canais & ONDA_FRACAO ? fase32_passos(k, onda->passo)
+                                              : (fase_t)(k * onda->passo / onda->divisor);
+    cor_paleta_t cor = {0, 0, 0};
+    if (onda->canais & ONDA_R) {
+        cor.r = onda_seno((fase_t)(fase + onda->fases[0]));
+    }
+    if (onda->canais & ONDA_G) {
+        cor.g = onda_seno((fase_t)(fase + onda->fases[1]));
+    }
+    if (onda->canais & ONDA_B) {
+        cor.b = onda_seno((fase_t)(fase + onda->fases[2]));
+    }
+    return cor;
+}
+
+void interpretador_desenhar(const animacao_t *animacao, uint32_t *quadro, uint16_t indice) {
+    const programa_animacao_t *programa = animacao->dados;
+    const estado_interpretador_t *estado = avancar(programa, indice);
+
+    const uint8_t *desenho = programa->codigo + estado->desenho;
+    const cor_paleta_t *cor = &estado->paleta[estado->cor];
+    switch (estado->desenho != SEM_DESENHO ? desenho[0] : 0) {
+        case OP_PREENCHER: {
+            cor = &estado->paleta[desenho[1] % INTERPRETADOR_REGISTRADORES];
+            uint32_t color = calcular_cor_rgb(cor->b, cor->r, cor->g);
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                quadro[i] = color;
+            }
+            break;
+        }
+        case OP_MASCARA:
+        case OP_ACENDER:
+            glifo_expandir(quadro, estado->mascara, calcular_cor_rgb(cor->b, cor->r, cor->g));
+            break;
+        case OP_ONDA: {
+            onda_t onda;
+            decodificar_onda(&onda, desenho + 1);
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                cor_paleta_t c = cor_onda(&onda, indice, i);
+                quadro[i] = calcular_cor_rgb(c.b, c.r, c.g);
+            }
+            break;
+        }
+        default: // Nenhum desenho ainda: matriz apagada
+            memset(quadro, 0, NUM_PIXELS * sizeof(quadro[0]));
+            break;
+    }
+}
+
+void interpretador_desenhar16(const animacao_t *animacao, cor16_t *quadro, uint16_t indice) {
+    const programa_animacao_t *programa = animacao->dados;
+    const estado_interpretador_t *estado = avancar(programa, indice);
+
+    const uint8_t *desenho = programa->codigo + estado->desenho;
+    const cor_paleta_t *cor = &estado->paleta[estado->cor];
+    switch (estado->desenho != SEM_DESENHO ? desenho[0] : 0) {
+        case OP_PREENCHER: {
+            cor = &estado->paleta[desenho[1] % INTERPRETADOR_REGISTRADORES];
+            cor16_t color = calcular_cor16(cor->b, cor->r, cor->g);
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                quadro[i] = color;
+            }
+            break;
+        }
+        case OP_MASCARA:
+        case OP_ACENDER:
+            glifo_expandir16(quadro, estado->mascara, calcular_cor16(cor->b, cor->r, cor->g));
+            break;
+        case OP_ONDA: {
+            onda_t onda;
+            decodificar_onda(&onda, desenho + 1);
+            for (int i = 0; i < NUM_PIXELS; i++) {
+                cor_paleta_t c = cor_onda(&onda, indice, i);
+                quadro[i] = calcular_cor16(c.b, c.r, c.g);
+            }
+            break;
+        }
+        default:
+            memset(quadro, 0, NUM_PIXELS * sizeof(quadro[0]));
+            break;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef INTERPRETADOR_H
+#define INTERPRETADOR_H
+
+#include <stdint.h>
+#include "animacoes.h"
+#include "compositor.h"
+#include "glifos.h"
+
+// Bytecode de animação, montado a partir de animacoes.anim por
+// ferramentas/montar_animacoes.py. Cada instrução é um byte de operação
+// seguido dos operandos em little endian. As instruções de desenho só
+// definem o que o próximo quadro mostra; "quadro" emite quadros com esse
+// desenho, e o interpretador só toca nos pixels do quadro pedido.
+enum {
+    OP_PALETA = 1,   // reg, r16, g16, b16: carrega um registrador de cor
+    OP_PREENCHER,    // reg: todos os LEDs na cor do registrador
+    OP_MASCARA,      // reg, m32: glifo 5x5 (bit y * 5 + x) na cor do registrador
+    OP_ACENDER,      // reg, bit: acende mais um bit da máscara atual
+    OP_ONDA,         // canais, periodo16, passo32, divisor16, fase16 x 3 (R, G, B); ver ONDA_FRACAO
+    OP_QUADRO,       // n8: emite n quadros com o desenho atual
+    OP_REPETIR,      // n8: repete n vezes as instruções até o OP_FIM correspondente
+    OP_FIM,
+    OP_QUANTIDADE
+};
+
+#define INTERPRETADOR_REGISTRADORES 8 // Registradores de cor
+#define INTERPRETADOR_PROFUNDIDADE 4  // Laços aninhados
+
+// Estados de execução de cada programa: um por camada do escalonador, para
+// que o mesmo programa tocando em duas camadas (um crossfade de uma tecla
+// para ela mesma, ou a tecla 0 sobre a animação 4) não reinicie a cada quadro
+#define INTERPRETADOR_ESTADOS COMPOSITOR_CAMADAS
+
+// Em OP_ONDA, periodo ou divisor igual a este valor vale NUM_PIXELS
+#define ONDA_NUM_PIXELS 0xFFFF
+
+// Bits de canais em OP_ONDA
+#define ONDA_R 1
+#define ONDA_G 2
+#define ONDA_B 4
+// Passo em fase32_t (2^32 por volta) em vez de fase_t: a fase é
+// ((t + i) mod periodo) * passo com 32 bits, deslocada 16 bits, sem divisor
+#define ONDA_FRACAO 8
+
+// Valor de estado_interpretador_t.desenho antes da primeira instrução de desenho
+#define SEM_DESENHO 0xFFFF
+
+// Estado da execução até o quadro mais recente pedido. Quadros pedidos em
+// ordem continuam de onde o anterior parou; voltar atrás reinicia o programa.
+typedef struct {
+    uint32_t uso; // Ordem do último pedido atendido (0 = estado ainda não usado)
+    uint16_t pc;
+    uint16_t inicio;   // Primeiro quadro mostrado pelo desenho atual
+    uint16_t emitidos; // Quadros emitidos até aqui (o desenho vale até emitidos - 1)
+    uint8_t profundidade;
+    struct {
+        uint16_t corpo;
+        uint16_t restantes;
+    } lacos[INTERPRETADOR_PROFUNDIDADE];
+    cor_paleta_t paleta[INTERPRETADOR_REGISTRADORES];
+    uint32_t mascara;
+    uint16_t desenho; // Posição da última instrução de desenho (SEM_DESENHO = nenhuma)
+    uint8_t cor;      // Registrador de cor da máscara
+} estado_interpretador_t;
+
+// Programa montado: código em flash e INTERPRETADOR_ESTADOS estados de
+// execução em RAM, zerados no início. Cada quadro pedido continua o estado
+// mais adiantado que ainda não passou dele; se todos passaram, o usado há
+// mais tempo reinicia o programa. Assim cada camada que toca o programa
+// acaba com um estado só seu, sem que o escalonador saiba do interpretador.
+typedef struct {
+    const uint8_t *codigo;
+    uint16_t tamanho;
+    estado_interpretador_t *estados;
+} programa_animacao_t;
+
+// Funções de desenho para animacao_t; animacao->dados aponta para um programa_animacao_t
+void interpretador_desenhar(const animacao_t *animacao, uint32_t *quadro, uint16_t indice);
+void interpretador_desenhar16(const animacao_t *animacao, cor16_t *quadro, uint16_t indice);
+
+#endif
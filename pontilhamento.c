@@ -0,0 +1,76 @@
+#include "pontilhamento.h"
+
+#include <string.h>
+
+void pontilhamento_iniciar(pontilhamento_t *pontilhamento, saida_leds_t *saida, uint32_t mili_fps) {
+    memset(pontilhamento, 0, sizeof(*pontilhamento));
+    pontilhamento->saida = saida;
+    pontilhamento->mili_fps = mili_fps;
+
+    // Erro inicial diferente em cada pixel e canal: sem isso, pixels da mesma
+    // cor trocariam de nível na mesma renovação e a cintilação ficaria sincronizada
+    for (uint32_t i = 0; i < NUM_PIXELS; i++) {
+        uint32_t espalhado = i * 0x9E3779B1u;
+        pontilhamento->erro[i].canais_1_3 = (espalhado >> 8) & 0x00FF00FF;
+        pontilhamento->erro[i].canais_2_4 = espalhado & 0x00FF00FF;
+    }
+}
+
+cor16_t *pontilhamento_quadro(pontilhamento_t *pontilhamento) {
+    return pontilhamento->buffers[pontilhamento->desenho].pixels;
+}
+
+void pontilhamento_apresentar(pontilhamento_t *pontilhamento, uint64_t agora_us) {
+    pontilhamento->desenho ^= 1;
+    pontilhamento->estatisticas.quadros++;
+    if (!pontilhamento->ativo) {
+        pontilhamento->ativo = true;
+        relogio_quadros_iniciar(&pontilhamento->relogio, pontilhamento->mili_fps, agora_us);
+        pontilhamento->estatisticas.renovacoes_execucao = 0;
+        pontilhamento->estatisticas.inicio_execucao_us = agora_us;
+    }
+}
+
+void pontilhamento_parar(pontilhamento_t *pontilhamento) {
+    pontilhamento->ativo = false;
+}
+
+void pontilhamento_quantizar(const cor16_t *quadro, cor16_t *erro, uint32_t *saida, uint32_t num_pixels) {
+    for (uint32_t i = 0; i < num_pixels; i++) {
+        uint32_t impares = quadro[i].canais_1_3 + erro[i].canais_1_3;
+        uint32_t pares = quadro[i].canais_2_4 + erro[i].canais_2_4;
+        erro[i].canais_1_3 = impares & 0x00FF00FF;
+        erro[i].canais_2_4 = pares & 0x00FF00FF;
+        saida[i] = (impares & 0xFF00FF00) | ((pares >> 8) & 0x00FF00FF);
+    }
+}
+
+bool pontilhamento_passo(pontilhamento_t *pontilhamento, uint64_t agora_us) {
+    if (!pontilhamento->ativo || agora_us < relogio_quadros_prazo(&pontilhamento->relogio)) {
+        return false;
+    }
+
+    const cor16_t *conteudo = pontilhamento->buffers[pontilhamento->desenho ^ 1].pixels;
+    pontilhamento_quantizar(conteudo, pontilhamento->erro, saida_leds_quadro(pontilhamento->saida), NUM_PIXELS);
+    saida_leds_apresentar(pontilhamento->saida);
+
+    pontilhamento_estatisticas_t *estatisticas = &pontilhamento->estatisticas;
+    estatisticas->renovacoes++;
+    estatisticas->renovacoes_execucao++;
+    estatisticas->ultima_renovacao_us = agora_us;
+    relogio_quadros_avancar(&pontilhamento->relogio, agora_us);
+    return true;
+}
+
+uint64_t pontilhamento_prazo(const pontilhamento_t *pontilhamento) {
+    return pontilhamento->ativo ? relogio_quadros_prazo(&pontilhamento->relogio) : UINT64_MAX;
+}
+
+uint32_t pontilhamento_taxa_medida(const pontilhamento_t *pontilhamento) {
+    const pontilhamento_estatisticas_t *estatisticas = &pontilhamento->estatisticas;
+    uint64_t duracao = estatisticas->ultima_renovacao_us - estatisticas->inicio_execucao_us;
+    if (estatisticas->renovacoes_execucao < 2 || duracao == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)(estatisticas->renovacoes_execucao - 1) * 1000000000u / duracao);
+}
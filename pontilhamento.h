@@ -0,0 +1,81 @@
+#ifndef PONTILHAMENTO_H
+#define PONTILHAMENTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cor.h"
+#include "relogio_quadros.h"
+#include "saida_leds.h"
+
+// Taxa padrão de renovação da matriz com o pontilhamento ligado
+#ifndef MATRIZ_PONTILHAMENTO_HZ
+#define MATRIZ_PONTILHAMENTO_HZ 400
+#endif
+
+// Quadro de conteúdo com 8.8 bits por canal (formato de calcular_cor16)
+typedef struct {
+    cor16_t pixels[NUM_PIXELS];
+} quadro16_t;
+
+// Contadores do pontilhamento
+typedef struct {
+    uint32_t quadros;             // Quadros de conteúdo apresentados
+    uint32_t renovacoes;          // Quadros de 8 bits entregues à saída
+    uint32_t renovacoes_execucao; // Renovações desde que o pontilhamento foi (re)ligado
+    uint64_t inicio_execucao_us;  // Primeira renovação da execução atual
+    uint64_t ultima_renovacao_us;
+} pontilhamento_estatisticas_t;
+
+// Pontilhamento temporal: as animações desenham quadros de 8.8 bits por
+// canal, e a matriz é renovada numa taxa bem maior que a do conteúdo. Em
+// cada renovação a fração que o LED não consegue exibir fica acumulada por
+// pixel e canal e entra na renovação seguinte, então a média no tempo
+// reproduz os 16 bits; 127,5 vira 127 e 128 alternados, por exemplo.
+typedef struct {
+    quadro16_t buffers[2];
+    uint8_t desenho; // Índice do buffer em que as animações desenham
+    bool ativo;      // Há um quadro de conteúdo sendo renovado
+    cor16_t erro[NUM_PIXELS]; // Fração acumulada, nas mesmas metades de cor16_t
+    saida_leds_t *saida;
+    uint32_t mili_fps;         // Taxa de renovação pedida
+    relogio_quadros_t relogio; // Prazos das renovações
+    pontilhamento_estatisticas_t estatisticas;
+} pontilhamento_t;
+
+// Função para inicializar o pontilhamento, desligado até o primeiro quadro
+// Parâmetros:
+// - saida: Saída de 8 bits que recebe as renovações
+// - mili_fps: Taxa de renovação em milésimos de quadro por segundo
+void pontilhamento_iniciar(pontilhamento_t *pontilhamento, saida_leds_t *saida, uint32_t mili_fps);
+
+// Retorna o quadro de 8.8 bits em que o próximo conteúdo deve ser desenhado
+cor16_t *pontilhamento_quadro(pontilhamento_t *pontilhamento);
+
+// Troca o quadro de conteúdo renovado pelo recém-desenhado. Se o
+// pontilhamento estava parado, a primeira renovação é em agora_us.
+void pontilhamento_apresentar(pontilhamento_t *pontilhamento, uint64_t agora_us);
+
+// Para as renovações, deixando a saída para quem desenha em 8 bits
+void pontilhamento_parar(pontilhamento_t *pontilhamento);
+
+// Renova a matriz se o prazo chegou
+// Retorna:
+// - true se uma renovação foi entregue à saída
+bool pontilhamento_passo(pontilhamento_t *pontilhamento, uint64_t agora_us);
+
+// Instante da próxima renovação (UINT64_MAX se parado)
+uint64_t pontilhamento_prazo(const pontilhamento_t *pontilhamento);
+
+// Taxa de renovação medida desde que o pontilhamento foi ligado, em milésimos de Hz
+uint32_t pontilhamento_taxa_medida(const pontilhamento_t *pontilhamento);
+
+// Núcleo do pontilhamento: soma o erro acumulado a cada canal, entrega a
+// parte inteira no formato da fita e guarda a fração para a próxima vez
+// Parâmetros:
+// - quadro: Quadro de conteúdo em 8.8
+// - erro: Fração acumulada por pixel (atualizada)
+// - saida: Quadro de 8 bits no formato de calcular_cor_rgb
+// - num_pixels: Quantidade de pixels
+void pontilhamento_quantizar(const cor16_t *quadro, cor16_t *erro, uint32_t *saida, uint32_t num_pixels);
+
+#endif
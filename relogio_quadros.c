@@ -0,0 +1,40 @@
+#include "relogio_quadros.h"
+
+#define MILI_US_POR_SEGUNDO 1000000000ull // Microssegundos por segundo vezes 1000
+
+static uint64_t prazo_do_indice(const relogio_quadros_t *relogio, uint32_t indice) {
+    return relogio->inicio_us + ((uint64_t)indice * MILI_US_POR_SEGUNDO + relogio->mili_fps / 2) / relogio->mili_fps;
+}
+
+void relogio_quadros_iniciar(relogio_quadros_t *relogio, uint32_t mili_fps, uint64_t agora_us) {
+    relogio->inicio_us = agora_us;
+    relogio->mili_fps = mili_fps ? mili_fps : 1;
+    relogio->indice = 0;
+    relogio->perdidos = 0;
+}
+
+uint64_t relogio_quadros_prazo(const relogio_quadros_t *relogio) {
+    return prazo_do_indice(relogio, relogio->indice);
+}
+
+uint32_t relogio_quadros_avancar(relogio_quadros_t *relogio, uint64_t agora_us) {
+    uint32_t proximo = relogio->indice + 1;
+
+    // Primeiro prazo da grade ainda no futuro; os anteriores foram perdidos
+    if (prazo_do_indice(relogio, proximo) <= agora_us) {
+        uint64_t decorrido = agora_us - relogio->inicio_us;
+        proximo = (uint32_t)(decorrido * relogio->mili_fps / MILI_US_POR_SEGUNDO) + 1;
+        while (prazo_do_indice(relogio, proximo) <= agora_us) {
+            proximo++; // Corrige o arredondamento da divisão acima
+        }
+    }
+
+    uint32_t perdidos = proximo - relogio->indice - 1;
+    relogio->perdidos += perdidos;
+    relogio->indice = proximo;
+    return perdidos;
+}
+
+uint32_t relogio_quadros_periodo_us(const relogio_quadros_t *relogio) {
+    return (uint32_t)((MILI_US_POR_SEGUNDO + relogio->mili_fps / 2) / relogio->mili_fps);
+}
@@ -0,0 +1,45 @@
+#ifndef RELOGIO_QUADROS_H
+#define RELOGIO_QUADROS_H
+
+#include <stdint.h>
+
+// Converte uma taxa em quadros por segundo (pode ser fracionária, como 7.5)
+// em milésimos de quadro por segundo. Com argumento constante a conta é
+// resolvida pelo compilador.
+#define FPS(x) ((uint32_t)((x) * 1000.0 + 0.5))
+
+// Relógio de quadros com prazos absolutos: o prazo do quadro n é
+// inicio_us + n / fps, calculado a partir do início e não somado período a
+// período, então nem o tempo de desenho e envio nem o arredondamento do
+// período se acumulam. Um quadro atrasado não desloca os seguintes; se o
+// atraso passar de um período inteiro, os prazos já vencidos são pulados
+// e contados como perdidos.
+typedef struct {
+    uint64_t inicio_us; // Prazo do quadro 0
+    uint32_t mili_fps;  // Taxa em milésimos de quadro por segundo
+    uint32_t indice;    // Posição do próximo prazo na grade
+    uint32_t perdidos;  // Prazos pulados por atraso desde o início
+} relogio_quadros_t;
+
+// Função para iniciar o relógio com o primeiro prazo em agora_us
+// Parâmetros:
+// - relogio: Relógio a ser iniciado
+// - mili_fps: Taxa em milésimos de quadro por segundo (use FPS())
+// - agora_us: Instante atual em microssegundos
+void relogio_quadros_iniciar(relogio_quadros_t *relogio, uint32_t mili_fps, uint64_t agora_us);
+
+// Retorna o instante em microssegundos do próximo prazo
+uint64_t relogio_quadros_prazo(const relogio_quadros_t *relogio);
+
+// Função para avançar ao prazo seguinte depois de apresentar um quadro
+// Parâmetros:
+// - relogio: Relógio da animação
+// - agora_us: Instante em que o quadro foi apresentado
+// Retorna:
+// - Número de prazos perdidos nesta chamada (0 se o quadro saiu a tempo)
+uint32_t relogio_quadros_avancar(relogio_quadros_t *relogio, uint64_t agora_us);
+
+// Retorna o período nominal em microssegundos, arredondado (para registro)
+uint32_t relogio_quadros_periodo_us(const relogio_quadros_t *relogio);
+
+#endif
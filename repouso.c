@@ -0,0 +1,79 @@
+#include "repouso.h"
+
+void repouso_iniciar(repouso_t *repouso, uint64_t apagar_us, uint64_t dormir_us, uint64_t agora_us) {
+    repouso->apagar_us = apagar_us;
+    repouso->dormir_us = dormir_us;
+    repouso->estado = REPOUSO_ATIVO;
+    repouso->ultima_atividade_us = agora_us;
+    repouso->despertar_us = 0;
+    repouso->aguardando_tecla = false;
+    repouso->ocupado = false;
+    repouso->estatisticas = (repouso_estatisticas_t){0};
+}
+
+bool repouso_atividade(repouso_t *repouso, uint64_t agora_us) {
+    repouso->estado = REPOUSO_ATIVO;
+    repouso->ultima_atividade_us = agora_us;
+    if (!repouso->aguardando_tecla) {
+        return false;
+    }
+
+    repouso_estatisticas_t *estatisticas = &repouso->estatisticas;
+    uint32_t latencia = (uint32_t)(agora_us - repouso->despertar_us);
+    repouso->aguardando_tecla = false;
+    estatisticas->despertares++;
+    estatisticas->ultima_latencia_us = latencia;
+    estatisticas->maior_latencia_us =
+        latencia > estatisticas->maior_latencia_us ? latencia : estatisticas->maior_latencia_us;
+    estatisticas->soma_latencia_us += latencia;
+    return true;
+}
+
+uint64_t repouso_prazo(const repouso_t *repouso) {
+    switch (repouso->estado) {
+        case REPOUSO_ATIVO:
+            return repouso->apagar_us ? repouso->ultima_atividade_us + repouso->apagar_us : UINT64_MAX;
+        case REPOUSO_APAGADO:
+            return repouso->dormir_us ? repouso->ultima_atividade_us + repouso->dormir_us : UINT64_MAX;
+        default:
+            return UINT64_MAX;
+    }
+}
+
+repouso_acao_t repouso_passo(repouso_t *repouso, bool ocupado, uint64_t agora_us) {
+    // Acordou sem a tecla chegar (aperto curto demais para o debounce)
+    if (repouso->aguardando_tecla && agora_us - repouso->despertar_us > REPOUSO_LIMITE_TECLA_US) {
+        repouso->aguardando_tecla = false;
+        repouso->estatisticas.despertares_sem_tecla++;
+    }
+
+    // Animação tocando (inclusive a que apaga a matriz) adia a contagem,
+    // que recomeça no fim dela
+    if (ocupado || repouso->ocupado) {
+        repouso->ocupado = ocupado;
+        repouso->ultima_atividade_us = agora_us;
+        return REPOUSO_NADA;
+    }
+    if (agora_us < repouso_prazo(repouso)) {
+        return REPOUSO_NADA;
+    }
+
+    repouso->ultima_atividade_us = agora_us;
+    if (repouso->estado == REPOUSO_ATIVO) {
+        repouso->estado = REPOUSO_APAGADO;
+        repouso->estatisticas.apagamentos++;
+        return REPOUSO_APAGAR;
+    }
+    repouso->estado = REPOUSO_DORMINDO;
+    repouso->estatisticas.sonos++;
+    return REPOUSO_DORMIR;
+}
+
+void repouso_despertou(repouso_t *repouso, uint64_t despertar_us, uint64_t agora_us) {
+    // A matriz continua apagada até a tecla ser tratada; sem tecla, volta a
+    // contar o tempo até dormir de novo
+    repouso->estado = REPOUSO_APAGADO;
+    repouso->ultima_atividade_us = agora_us;
+    repouso->despertar_us = despertar_us;
+    repouso->aguardando_tecla = true;
+}
@@ -0,0 +1,84 @@
+#ifndef REPOUSO_H
+#define REPOUSO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Depois de um aperto, tempo máximo até a tecla ser tratada para a
+// latência do despertar valer (passado isso o despertar é contado sem tecla)
+#define REPOUSO_LIMITE_TECLA_US 1000000
+
+typedef enum {
+    REPOUSO_ATIVO,    // Matriz acesa, contando a inatividade
+    REPOUSO_APAGADO,  // Matriz apagada, contando até dormir
+    REPOUSO_DORMINDO, // Processador dormindo até um aperto
+} repouso_estado_t;
+
+// O que o laço principal deve fazer depois de repouso_passo()
+typedef enum {
+    REPOUSO_NADA,
+    REPOUSO_APAGAR, // Apagar a matriz
+    REPOUSO_DORMIR, // Dormir até um aperto e chamar repouso_despertou()
+} repouso_acao_t;
+
+typedef struct {
+    uint32_t apagamentos;
+    uint32_t sonos;
+    uint32_t despertares;          // Despertares com a tecla tratada a tempo
+    uint32_t despertares_sem_tecla; // Nenhuma tecla chegou em REPOUSO_LIMITE_TECLA_US
+    uint32_t ultima_latencia_us;   // Do aperto que acordou até a tecla ser tratada
+    uint32_t maior_latencia_us;
+    uint64_t soma_latencia_us;
+} repouso_estatisticas_t;
+
+// Política de repouso: depois de "apagar_us" sem atividade a matriz é
+// apagada, e depois de mais "dormir_us" o processador dorme até um aperto.
+// Só decide; quem apaga e dorme é o laço principal, e todos os instantes
+// vêm de fora, então a mesma lógica roda no computador com o relógio virtual.
+typedef struct {
+    uint64_t apagar_us; // Inatividade até apagar (0 nunca apaga)
+    uint64_t dormir_us; // Tempo apagado até dormir (0 nunca dorme)
+    repouso_estado_t estado;
+    uint64_t ultima_atividade_us; // Início da contagem do estado atual
+    uint64_t despertar_us;        // Instante do aperto que acordou o processador
+    bool aguardando_tecla;        // Acordou e a tecla ainda não foi tratada
+    bool ocupado;                 // Última chamada de repouso_passo() com animação tocando
+    repouso_estatisticas_t estatisticas;
+} repouso_t;
+
+// Função para iniciar a política no estado ativo
+// Parâmetros:
+// - repouso: Política a ser iniciada
+// - apagar_us: Inatividade até apagar a matriz (0 desliga o repouso)
+// - dormir_us: Tempo com a matriz apagada até dormir (0 só apaga)
+// - agora_us: Instante atual em microssegundos
+void repouso_iniciar(repouso_t *repouso, uint64_t apagar_us, uint64_t dormir_us, uint64_t agora_us);
+
+// Função para registrar uma tecla apertada ou outro comando do usuário
+// Parâmetros:
+// - repouso: Política de repouso
+// - agora_us: Instante em que a tecla foi tratada
+// Retorna:
+// - true se foi a tecla que acordou o processador (a latência foi medida)
+bool repouso_atividade(repouso_t *repouso, uint64_t agora_us);
+
+// Função para avançar a política
+// Parâmetros:
+// - repouso: Política de repouso
+// - ocupado: Há animação tocando ou quadros chegando (a inatividade não conta)
+// - agora_us: Instante atual em microssegundos
+// Retorna:
+// - Ação que o laço principal deve executar agora
+repouso_acao_t repouso_passo(repouso_t *repouso, bool ocupado, uint64_t agora_us);
+
+// Retorna o instante da próxima ação de repouso_passo() (UINT64_MAX se nenhuma)
+uint64_t repouso_prazo(const repouso_t *repouso);
+
+// Função para registrar que o processador acordou
+// Parâmetros:
+// - repouso: Política de repouso
+// - despertar_us: Instante atribuído ao aperto que acordou o processador
+// - agora_us: Instante atual em microssegundos
+void repouso_despertou(repouso_t *repouso, uint64_t despertar_us, uint64_t agora_us);
+
+#endif
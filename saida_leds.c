@@ -0,0 +1,84 @@
+#include "saida_leds.h"
+
+#include <string.h>
+
+void saida_leds_iniciar(saida_leds_t *saida, transporte_leds_t *transporte) {
+    memset(saida, 0, sizeof(*saida));
+    saida->transporte = transporte;
+}
+
+uint32_t *saida_leds_quadro(saida_leds_t *saida) {
+    return saida->buffers[saida->desenho].pixels;
+}
+
+static uint32_t contar_alterados(const uint32_t *quadro, const uint32_t *anterior) {
+    uint32_t alterados = 0;
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        alterados += quadro[i] != anterior[i];
+    }
+    return alterados;
+}
+
+void saida_leds_apresentar(saida_leds_t *saida) {
+    transporte_leds_t *transporte = saida->transporte;
+    const uint32_t *quadro = saida->buffers[saida->desenho].pixels;
+    const uint32_t *anterior = saida->buffers[saida->desenho ^ 1].pixels;
+    saida_leds_estatisticas_t *estatisticas = &saida->estatisticas;
+    bool igual;
+
+    estatisticas->apresentados++;
+    if (saida->contar_alterados) {
+        uint32_t alterados = saida->transmitido ? contar_alterados(quadro, anterior) : NUM_PIXELS;
+        estatisticas->ultimo_alterados = alterados;
+        estatisticas->total_alterados += alterados;
+        igual = alterados == 0;
+    } else {
+        igual = memcmp(quadro, anterior, sizeof(framebuffer_t)) == 0;
+    }
+
+    if (saida->transmitido && igual) {
+        estatisticas->suprimidos++;
+        return;
+    }
+
+    // O buffer que vai virar o próximo quadro de desenho ainda pode estar
+    // sendo lido pelo transporte; espera o envio anterior terminar.
+    while (transporte->ocupado(transporte)) {
+    }
+
+    transporte->enviar(transporte, quadro, NUM_PIXELS);
+    saida->desenho ^= 1;
+    saida->transmitido = true;
+    estatisticas->enviados++;
+}
+
+void saida_leds_manter(saida_leds_t *saida, uint64_t agora_us) {
+    // Um envio desde a última chamada reinicia a contagem do intervalo
+    if (saida->estatisticas.enviados != saida->enviados_vistos) {
+        saida->enviados_vistos = saida->estatisticas.enviados;
+        saida->ultimo_envio_us = agora_us;
+        return;
+    }
+
+    if (saida_leds_prazo_manter(saida) > agora_us || saida->transporte->ocupado(saida->transporte)) {
+        return;
+    }
+
+    saida->transporte->enviar(saida->transporte, saida->buffers[saida->desenho ^ 1].pixels, NUM_PIXELS);
+    saida->estatisticas.reenvios++;
+    saida->ultimo_envio_us = agora_us;
+}
+
+uint64_t saida_leds_prazo_manter(const saida_leds_t *saida) {
+    if (saida->intervalo_manter_us == 0 || !saida->transmitido) {
+        return UINT64_MAX;
+    }
+    return saida->ultimo_envio_us + saida->intervalo_manter_us;
+}
+
+void saida_leds_preencher(saida_leds_t *saida, uint32_t cor) {
+    uint32_t *pixels = saida_leds_quadro(saida);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        pixels[i] = cor;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef SAIDA_LEDS_H
+#define SAIDA_LEDS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "formato_pixel.h"
+#include "geometria.h"
+
+// Tempo mínimo em nível baixo entre o último bit de um quadro e o primeiro
+// do seguinte, para a matriz aplicar o quadro recebido (reset do WS2812)
+#ifndef MATRIZ_LATCH_US
+#define MATRIZ_LATCH_US 80
+#endif
+
+// Interface de transporte: quem efetivamente leva os pixels até a matriz.
+// Na placa é o par PIO + DMA (transporte_pio_dma.h); em testes no host pode
+// ser qualquer implementação que apenas capture os quadros recebidos. Com
+// mais de uma via, cada uma recebe o seu trecho de PIXELS_POR_VIA pixels.
+typedef struct transporte_leds {
+    // Inicia o envio de num_pixels palavras no formato de formato_pixel.h
+    // (PIXEL_BITS bits a partir do bit 31) e retorna sem esperar o fim da
+    // transmissão. O buffer deve permanecer válido até que ocupado()
+    // retorne false.
+    void (*enviar)(struct transporte_leds *transporte, const uint32_t *pixels, uint32_t num_pixels);
+    // Retorna true enquanto o envio anterior ainda estiver em andamento,
+    // incluindo os MATRIZ_LATCH_US em nível baixo depois do último bit
+    bool (*ocupado)(struct transporte_leds *transporte);
+} transporte_leds_t;
+
+// Framebuffer: um quadro completo da matriz no formato de calcular_cor_rgb
+typedef struct {
+    uint32_t pixels[NUM_PIXELS];
+} framebuffer_t;
+
+// Contadores da saída, para medir quanto do barramento a supressão economiza
+typedef struct {
+    uint32_t apresentados;      // Chamadas de saida_leds_apresentar()
+    uint32_t enviados;          // Quadros efetivamente transmitidos
+    uint32_t suprimidos;        // Quadros iguais ao que já estava na matriz
+    uint32_t reenvios;          // Reenvios periódicos de saida_leds_manter()
+    uint32_t ultimo_alterados;  // Pixels alterados no último quadro (com contar_alterados)
+    uint64_t total_alterados;   // Soma de ultimo_alterados
+} saida_leds_estatisticas_t;
+
+// Saída da matriz com buffer duplo: as animações desenham no quadro de
+// desenho enquanto o quadro anterior ainda está sendo transmitido. O buffer
+// da frente guarda sempre o último quadro enviado, e um quadro igual a ele
+// não é retransmitido.
+typedef struct {
+    framebuffer_t buffers[2];
+    uint8_t desenho; // Índice do buffer em que as animações desenham
+    transporte_leds_t *transporte;
+    bool transmitido; // O buffer da frente já foi enviado à matriz
+
+    // Conta os pixels diferentes do quadro anterior em vez de só comparar
+    // até a primeira diferença (pode ser ligado por outro núcleo)
+    volatile bool contar_alterados;
+
+    // Reenvio periódico do último quadro por saida_leds_manter() (0 desliga)
+    uint32_t intervalo_manter_us;
+    uint64_t ultimo_envio_us;
+    uint32_t enviados_vistos; // Valor de estatisticas.enviados na última chamada de saida_leds_manter()
+
+    saida_leds_estatisticas_t estatisticas;
+} saida_leds_t;
+
+// Inicializa a saída com os dois buffers apagados
+// Parâmetros:
+// - saida: Saída a ser inicializada
+// - transporte: Transporte usado para enviar os quadros
+void saida_leds_iniciar(saida_leds_t *saida, transporte_leds_t *transporte);
+
+// Retorna o quadro em que a próxima imagem deve ser desenhada
+uint32_t *saida_leds_quadro(saida_leds_t *saida);
+
+// Entrega o quadro de desenho ao transporte e troca os buffers.
+// Só espera se o quadro anterior ainda estiver em transmissão. Se o quadro
+// for igual ao último enviado nada é transmitido e os buffers não trocam;
+// como as animações desenham o quadro inteiro, o próximo desenho o sobrescreve.
+void saida_leds_apresentar(saida_leds_t *saida);
+
+// Reenvia o último quadro se intervalo_manter_us passou sem nenhum envio.
+// Deve ser chamada pelo mesmo núcleo que apresenta os quadros.
+// Parâmetros:
+// - agora_us: Instante atual em microssegundos
+void saida_leds_manter(saida_leds_t *saida, uint64_t agora_us);
+
+// Instante do próximo reenvio periódico (UINT64_MAX se desligado)
+uint64_t saida_leds_prazo_manter(const saida_leds_t *saida);
+
+// Preenche todo o quadro de desenho com uma única cor
+void saida_leds_preencher(saida_leds_t *saida, uint32_t cor);
+
+#endif
@@ -0,0 +1,106 @@
+#include "sono.h"
+
+#include "hardware/clocks.h"
+#include "hardware/structs/scb.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include "teclado.h"
+
+#if MATRIZ_REPOUSO_DORMENTE
+#include "hardware/pll.h"
+#include "hardware/structs/xosc.h"
+#include "hardware/xosc.h"
+#endif
+
+#if MATRIZ_REPOUSO_DORMENTE
+// Partida do cristal configurada no XOSC (ciclos em múltiplos de 256), que
+// passa antes de o temporizador voltar a contar
+static uint32_t partida_cristal_us(void) {
+    uint32_t ciclos = (xosc_hw->startup & XOSC_STARTUP_DELAY_BITS) * 256u;
+    return (uint32_t)((uint64_t)ciclos * 1000000u / XOSC_HZ);
+}
+
+// Volta aos relógios da inicialização do SDK: clk_sys do PLL do sistema,
+// USB, ADC e RTC do PLL de 48 MHz e clk_peri de clk_sys
+static void religar_relogios(void) {
+    pll_init(pll_usb, 1, 1200 * MHZ, 5, 5);
+    clock_configure(clk_usb, 0, CLOCKS_CLK_USB_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    clock_configure(clk_rtc, 0, CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 46875);
+    set_sys_clock_khz(SYS_CLK_KHZ, true);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, SYS_CLK_KHZ * KHZ, SYS_CLK_KHZ * KHZ);
+}
+
+static void dormir(uint64_t *despertar_us) {
+    // Tudo passa a rodar do XOSC e os PLLs param; no modo dormente o XOSC
+    // também para e só uma borda numa coluna o religa
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    clock_stop(clk_rtc);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_XOSC_CLKSRC, XOSC_HZ, XOSC_HZ);
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+
+    teclado_armar_despertar(true);
+    xosc_dormant(); // Retorna com o cristal estável
+    *despertar_us = time_us_64() - partida_cristal_us();
+    teclado_armar_despertar(false);
+
+    religar_relogios();
+    teclado_despertou();
+}
+#else
+// Periféricos parados enquanto os núcleos dormem; o temporizador, o banco de
+// GPIO e o USB continuam com relógio, e o pio1 também quando é ele que varre
+// o teclado (o aperto acorda pela interrupção da FIFO RX)
+#if MATRIZ_TECLADO_PIO
+#define RELOGIO_PIO1_EN0 0
+#else
+#define RELOGIO_PIO1_EN0 CLOCKS_SLEEP_EN0_CLK_SYS_PIO1_BITS
+#endif
+#define RELOGIOS_PARADOS_EN0 (CLOCKS_SLEEP_EN0_CLK_SYS_PIO0_BITS | RELOGIO_PIO1_EN0 | \
+                              CLOCKS_SLEEP_EN0_CLK_SYS_DMA_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_ADC_BITS | \
+                              CLOCKS_SLEEP_EN0_CLK_ADC_ADC_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_PWM_BITS)
+
+static void dormir(uint64_t *despertar_us) {
+    uint32_t sleep_en0 = clocks_hw->sleep_en0;
+    clocks_hw->sleep_en0 = sleep_en0 & ~RELOGIOS_PARADOS_EN0;
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+
+    // O USB e os alarmes também acordam o núcleo; depois de tratar as
+    // interrupções ele volta a dormir até a borda de uma coluna começar a
+    // varredura do teclado
+    *despertar_us = time_us_64();
+    while (true) {
+        uint32_t estado = save_and_disable_interrupts();
+        if (!teclado_ocioso()) {
+            restore_interrupts(estado);
+            break;
+        }
+        __wfi(); // Acorda com a interrupção pendente, tratada depois de restore_interrupts
+        *despertar_us = time_us_64();
+        restore_interrupts(estado);
+    }
+
+    scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+    clocks_hw->sleep_en0 = sleep_en0;
+}
+#endif
+
+bool sono_ate_tecla(uint64_t *despertar_us) {
+    uint32_t estado = save_and_disable_interrupts();
+    if (!teclado_ocioso()) {
+        restore_interrupts(estado);
+        return false;
+    }
+#if MATRIZ_REPOUSO_DORMENTE
+    dormir(despertar_us);
+    restore_interrupts(estado);
+#else
+    restore_interrupts(estado);
+    dormir(despertar_us);
+#endif
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef SONO_H
+#define SONO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Com MATRIZ_REPOUSO_DORMENTE o processador entra no modo dormente: todos os
+// osciladores param, o consumo cai ao mínimo e o USB se desconecta (o
+// console pela UART continua depois de acordar). Sem ele, os núcleos dormem
+// com os relógios do PIO, do DMA, do ADC e do PWM parados (menos o do pio1
+// com MATRIZ_TECLADO_PIO), e o USB e o temporizador continuam ligados.
+#ifndef MATRIZ_REPOUSO_DORMENTE
+#define MATRIZ_REPOUSO_DORMENTE 0
+#endif
+
+// Função para dormir até um aperto no teclado. As linhas ficam todas ativas
+// e as colunas armadas como fontes de despertar; o aperto que acorda vira
+// um evento normal da fila do teclado, confirmado pelo debounce.
+// Parâmetros:
+// - despertar_us: Recebe o instante (time_us_64) atribuído ao aperto. No
+//   modo dormente o temporizador fica parado, então o instante é o da volta
+//   dos relógios menos a partida do cristal.
+// Retorna:
+// - false sem dormir se uma tecla estiver apertada
+bool sono_ate_tecla(uint64_t *despertar_us);
+
+#endif
@@ -0,0 +1,81 @@
+#include "sprite.h"
+
+#include <string.h>
+
+void tela_limpar(tela_t *tela) {
+    memset(tela, 0, sizeof(*tela));
+}
+
+static inline int maior(int a, int b) {
+    return a > b ? a : b;
+}
+
+static inline int menor(int a, int b) {
+    return a < b ? a : b;
+}
+
+// Lê 32 pixels de uma linha a partir da coluna x, alinhados no bit 31 (os
+// que passam do fim da linha vêm apagados)
+static inline uint32_t ler_palavra(const uint32_t *linha, int palavras, int x) {
+    int indice = x >> 5;
+    int deslocamento = x & 31;
+    uint32_t bits = linha[indice] << deslocamento;
+    if (deslocamento && indice + 1 < palavras) {
+        bits |= linha[indice + 1] >> (32 - deslocamento);
+    }
+    return bits;
+}
+
+void sprite_desenhar(tela_t *tela, const janela_t *janela, const bitmap_t *sprite, int origem_x, int largura, int x,
+                     int y) {
+    // Posição do trecho na tela, com as colunas fora do bitmap descartadas
+    int tela_x = janela->x + x;
+    int tela_y = janela->y + y;
+    if (origem_x < 0) {
+        largura += origem_x;
+        tela_x -= origem_x;
+        origem_x = 0;
+    }
+    largura = menor(largura, sprite->largura - origem_x);
+
+    // Recorte pela janela e pela tela
+    int inicio = maior(tela_x, maior(janela->x, 0));
+    int fim = menor(tela_x + largura, menor(janela->x + janela->largura, MATRIZ_LARGURA));
+    int linha_inicio = maior(tela_y, maior(janela->y, 0));
+    int linha_fim = menor(tela_y + sprite->altura, menor(janela->y + janela->altura, MATRIZ_ALTURA));
+    if (inicio >= fim || linha_inicio >= linha_fim) {
+        return;
+    }
+
+    int coluna_origem = origem_x + (inicio - tela_x);
+    for (int ty = linha_inicio; ty < linha_fim; ty++) {
+        const uint32_t *origem = sprite->bits + (ty - tela_y) * sprite->palavras;
+        uint32_t *destino = tela->linhas[ty];
+
+        // Até 32 pixels por volta: uma leitura alinhada da origem e no
+        // máximo duas palavras de destino
+        for (int tx = inicio, sx = coluna_origem; tx < fim; tx += 32, sx += 32) {
+            int quant = menor(fim - tx, 32);
+            uint32_t bits = ler_palavra(origem, sprite->palavras, sx) & (~0u << (32 - quant));
+            int indice = tx >> 5;
+            int deslocamento = tx & 31;
+            destino[indice] |= bits >> deslocamento;
+            if (deslocamento + quant > 32) {
+                destino[indice + 1] |= bits << (32 - deslocamento);
+            }
+        }
+    }
+}
+
+void tela_expandir(uint32_t *quadro, const tela_t *tela, uint32_t cor) {
+    for (int y = 0; y < MATRIZ_ALTURA; y++) {
+        for (int p = 0; p < TELA_PALAVRAS; p++) {
+            uint32_t bits = tela->linhas[y][p];
+            int fim = menor(p * 32 + 32, MATRIZ_LARGURA);
+            for (int x = p * 32; x < fim; x++) {
+                quadro[geometria_led(x, y)] = cor & (0u - (bits >> 31));
+                bits <<= 1;
+            }
+        }
+    }
+}
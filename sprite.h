@@ -0,0 +1,62 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdint.h>
+#include "geometria.h"
+
+// Bitmaps de 1 bit por pixel, linha a linha. O pixel x de uma linha fica no
+// bit 31 - x % 32 da palavra x / 32, então deslocar a linha para a esquerda
+// move o desenho para a esquerda e a cópia entre bitmaps anda 32 pixels por
+// vez, com dois deslocamentos por palavra, em vez de pixel a pixel.
+typedef struct {
+    const uint32_t *bits; // altura * palavras palavras
+    uint16_t largura;
+    uint16_t altura;
+    uint16_t palavras; // Palavras por linha
+} bitmap_t;
+
+// Palavras de uma linha da tela
+#define TELA_PALAVRAS ((MATRIZ_LARGURA + 31) / 32)
+
+// Tela do tamanho da matriz lógica, no mesmo formato dos bitmaps; só vira
+// cores em tela_expandir()
+typedef struct {
+    uint32_t linhas[MATRIZ_ALTURA][TELA_PALAVRAS];
+} tela_t;
+
+// Retângulo da tela, como um painel de uma matriz formada por vários
+// painéis encadeados: as coordenadas de sprite_desenhar() são relativas ao
+// canto superior esquerdo da janela e o desenho é recortado nas bordas dela.
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t largura;
+    int16_t altura;
+} janela_t;
+
+// Janela com a matriz inteira
+#define JANELA_MATRIZ ((janela_t){0, 0, MATRIZ_LARGURA, MATRIZ_ALTURA})
+
+// Apaga todos os pixels da tela
+void tela_limpar(tela_t *tela);
+
+// Função para acender na tela os pixels acesos de um trecho de um bitmap
+// (os apagados não mudam a tela)
+// Parâmetros:
+// - tela: Tela de destino
+// - janela: Área da tela em que o sprite pode aparecer
+// - sprite: Bitmap de origem
+// - origem_x, largura: Colunas do bitmap copiadas (o trecho de um atlas)
+// - x, y: Posição do canto superior esquerdo do trecho, relativa à janela;
+//   pode ser negativa ou passar da janela, e o que sobrar é recortado
+void sprite_desenhar(tela_t *tela, const janela_t *janela, const bitmap_t *sprite, int origem_x, int largura, int x,
+                     int y);
+
+// Função para converter a tela num quadro, passando pelo mapa da geometria
+// Parâmetros:
+// - quadro: Framebuffer de NUM_PIXELS posições
+// - tela: Pixels acesos
+// - cor: Cor dos pixels acesos, no formato de calcular_cor_rgb; os demais ficam apagados
+void tela_expandir(uint32_t *quadro, const tela_t *tela, uint32_t cor);
+
+#endif
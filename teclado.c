@@ -0,0 +1,313 @@
+#include "teclado.h"
+
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+
+#if MATRIZ_TECLADO_PIO
+#include "hardware/clocks.h"
+#include "hardware/pio.h"
+#include "teclado.pio.h"
+#endif
+
+static const char keys[16] = {
+    '1', '2', '3', 'A',
+    '4', '5', '6', 'B',
+    '7', '8', '9', 'C',
+    '*', '0', '#', 'D'};
+
+static const uint colunas[4] = {COL1_PIN, COL2_PIN, COL3_PIN, COL4_PIN};
+
+// Fila circular de eventos: escrita só pela interrupção, lida só pelo laço principal
+static evento_tecla_t fila[TECLADO_TAMANHO_FILA];
+static volatile uint8_t cabeca; // Próxima posição a escrever
+static volatile uint8_t cauda;  // Próxima posição a ler
+static volatile uint32_t eventos_perdidos;
+
+static uint16_t estado_estavel; // Última leitura confirmada pelo debounce
+static uint16_t candidato;      // Leitura que está sendo confirmada
+static uint32_t instante_borda; // Instante da borda que iniciou a varredura
+static volatile bool varrendo;  // Varredura e debounce em andamento (colunas sem interrupção)
+
+static void publicar_evento(char tecla, bool pressionada, uint16_t estado, uint32_t instante_us) {
+    uint8_t proxima = (cabeca + 1) & (TECLADO_TAMANHO_FILA - 1);
+    if (proxima == cauda) {
+        eventos_perdidos++;
+        return;
+    }
+    fila[cabeca] = (evento_tecla_t){tecla, pressionada, estado, instante_us};
+    cabeca = proxima;
+    __sev(); // Acorda o laço principal se ele estiver em __wfe()
+}
+
+// Publica um evento por tecla que mudou entre a leitura confirmada e a
+// nova, que passa a ser a confirmada. Cada evento leva o mapa logo depois
+// dele, então um acorde aparece completo só no evento da última tecla.
+static void confirmar_leitura(uint16_t leitura) {
+    uint16_t mudou = leitura ^ estado_estavel;
+    uint16_t estado = estado_estavel;
+    uint32_t agora = time_us_32();
+    for (int i = 0; i < 16; i++) {
+        if (mudou & (1u << i)) {
+            bool pressionada = leitura & (1u << i);
+            estado ^= 1u << i;
+            publicar_evento(keys[i], pressionada, estado, pressionada ? instante_borda : agora);
+        }
+    }
+    estado_estavel = leitura;
+}
+
+#if MATRIZ_TECLADO_PIO
+// teclado.pio supõe as linhas 4 e 3 no grupo SET de 5 pinos que começa na
+// linha 4, as linhas 2 e 1 logo depois no side-set e as colunas 4 a 1 em sequência
+_Static_assert(TECLADO_PIN_3 == TECLADO_PIN_4 + 4 && TECLADO_PIN_2 == TECLADO_PIN_3 + 1 &&
+               TECLADO_PIN_1 == TECLADO_PIN_2 + 1, "linhas fora da disposição de teclado.pio");
+_Static_assert(COL3_PIN == COL4_PIN + 1 && COL2_PIN == COL4_PIN + 2 && COL1_PIN == COL4_PIN + 3,
+               "colunas fora da disposição de teclado.pio");
+
+// O pio0 fica com as vias da matriz (até 4 máquinas de estado)
+#define TECLADO_PIO pio1
+#define TECLADO_IRQ PIO1_IRQ_0
+
+// Relógio da máquina de estado: 4 ciclos de estabilização por linha dão
+// 10 us, e o teclado inteiro é varrido em 23 ciclos (57,5 us)
+#define TECLADO_PIO_HZ 400000.0f
+
+static uint sm_teclado;
+static uint offset_teclado;
+static alarm_id_t alarme_pendente; // Debounce em andamento (0 se nenhum)
+
+uint16_t teclado_varrer(void) {
+    return candidato;
+}
+
+// Alarme do debounce: a última leitura enviada pela máquina de estado vale
+// depois de TECLADO_DEBOUNCE_US sem nenhuma mudança
+static int64_t alarme_debounce(alarm_id_t id, void *dados) {
+    (void)id;
+    (void)dados;
+
+    alarme_pendente = 0;
+    confirmar_leitura(candidato);
+    varrendo = estado_estavel != 0;
+    return 0;
+}
+
+// Interrupção da FIFO RX: a máquina de estado só envia o mapa quando ele
+// muda, e cada mudança recomeça a contagem do debounce
+static void fifo_teclado(void) {
+    while (!pio_sm_is_rx_fifo_empty(TECLADO_PIO, sm_teclado)) {
+        candidato = (uint16_t)(pio_sm_get(TECLADO_PIO, sm_teclado) >> 16);
+    }
+    if (alarme_pendente > 0) {
+        cancel_alarm(alarme_pendente);
+    } else {
+        instante_borda = time_us_32(); // Primeira mudança desde a última confirmação
+    }
+    varrendo = true;
+    alarme_pendente = add_alarm_in_us(TECLADO_DEBOUNCE_US, alarme_debounce, NULL, true);
+}
+
+void configurar_teclado() {
+    // Configurar pinos das colunas como entrada; o PIO lê os níveis direto
+    for (int col = 0; col < 4; col++) {
+        gpio_init(colunas[col]);
+        gpio_set_dir(colunas[col], GPIO_IN);
+        gpio_pull_down(colunas[col]);
+    }
+
+    // As linhas passam para a máquina de estado, que varre sem parar
+    offset_teclado = pio_add_program(TECLADO_PIO, &teclado_program);
+    sm_teclado = pio_claim_unused_sm(TECLADO_PIO, true);
+    teclado_program_init(TECLADO_PIO, sm_teclado, offset_teclado, TECLADO_PIO_HZ);
+
+    pio_set_irq0_source_enabled(TECLADO_PIO, (enum pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + sm_teclado),
+                                true);
+    irq_set_exclusive_handler(TECLADO_IRQ, fifo_teclado);
+    irq_set_enabled(TECLADO_IRQ, true);
+}
+
+void teclado_armar_despertar(bool armar) {
+    if (armar) {
+        // Sem relógio a máquina de estado para; todas as linhas viram saída
+        // para que qualquer aperto gere uma borda nas colunas
+        pio_sm_set_enabled(TECLADO_PIO, sm_teclado, false);
+        pio_sm_set_pindirs_with_mask(TECLADO_PIO, sm_teclado, TECLADO_MASCARA_LINHAS, TECLADO_MASCARA_LINHAS);
+    }
+    for (int col = 0; col < 4; col++) {
+        gpio_set_dormant_irq_enabled(colunas[col], GPIO_IRQ_EDGE_RISE, armar);
+        if (!armar) {
+            gpio_acknowledge_irq(colunas[col], GPIO_IRQ_EDGE_RISE);
+        }
+    }
+}
+
+void teclado_despertou(void) {
+    // A varredura recomeça da primeira linha com X zerado, então o aperto
+    // que acordou chega à FIFO na primeira volta e passa pelo debounce
+    pio_sm_set_pindirs_with_mask(TECLADO_PIO, sm_teclado, 0, TECLADO_MASCARA_LINHAS);
+    pio_sm_clear_fifos(TECLADO_PIO, sm_teclado);
+    pio_sm_restart(TECLADO_PIO, sm_teclado);
+    pio_sm_exec(TECLADO_PIO, sm_teclado, pio_encode_mov(pio_x, pio_null));
+    pio_sm_exec(TECLADO_PIO, sm_teclado, pio_encode_jmp(offset_teclado + teclado_offset_inicio));
+    pio_sm_set_enabled(TECLADO_PIO, sm_teclado, true);
+}
+#else
+static const uint linhas[4] = {TECLADO_PIN_1, TECLADO_PIN_2, TECLADO_PIN_3, TECLADO_PIN_4};
+
+#define MASCARA_COLUNAS ((1u << COL1_PIN) | (1u << COL2_PIN) | (1u << COL3_PIN) | (1u << COL4_PIN))
+
+static void ativar_todas_linhas(void) {
+    for (int row = 0; row < 4; row++) {
+        gpio_put(linhas[row], 1);
+    }
+}
+
+// Liga ou desliga as interrupções de borda de subida das colunas
+static void interrupcoes_colunas(bool ativar) {
+    for (int col = 0; col < 4; col++) {
+        if (ativar) {
+            // Descarta bordas registradas durante a varredura
+            gpio_acknowledge_irq(colunas[col], GPIO_IRQ_EDGE_RISE);
+        }
+        gpio_set_irq_enabled(colunas[col], GPIO_IRQ_EDGE_RISE, ativar);
+    }
+}
+
+uint16_t teclado_varrer(void) {
+    uint16_t estado = 0;
+
+    for (int row = 0; row < 4; row++) {
+        gpio_put(TECLADO_PIN_1, row == 0);
+        gpio_put(TECLADO_PIN_2, row == 1);
+        gpio_put(TECLADO_PIN_3, row == 2);
+        gpio_put(TECLADO_PIN_4, row == 3);
+
+        busy_wait_us(10); // Tempo para estabilizar
+
+        uint32_t entradas = gpio_get_all();
+        for (int col = 0; col < 4; col++) {
+            if (entradas & (1u << colunas[col])) {
+                estado |= 1u << (row * 4 + col);
+            }
+        }
+    }
+
+    // Com todas as linhas ativas, qualquer aperto gera uma borda nas colunas
+    ativar_todas_linhas();
+    return estado;
+}
+
+// Alarme do debounce: a leitura só vale depois de se repetir com
+// TECLADO_DEBOUNCE_US de intervalo. Enquanto houver tecla apertada o alarme
+// continua varrendo, para detectar a soltura.
+static int64_t alarme_debounce(alarm_id_t id, void *dados) {
+    (void)id;
+    (void)dados;
+
+    uint16_t leitura = teclado_varrer();
+    if (leitura != candidato) {
+        candidato = leitura; // Ainda oscilando: confirma na próxima rodada
+        return TECLADO_DEBOUNCE_US;
+    }
+
+    confirmar_leitura(leitura);
+    if (leitura) {
+        return TECLADO_DEBOUNCE_US;
+    }
+
+    // Nenhuma tecla apertada: volta a esperar uma borda
+    varrendo = false;
+    interrupcoes_colunas(true);
+    return 0;
+}
+
+// Começa a varredura de um aperto e agenda a confirmação pelo debounce
+static void iniciar_varredura(void) {
+    // Enquanto a varredura e o debounce estiverem em andamento as colunas
+    // ficam sem interrupção, já que trocar a linha ativa também gera bordas
+    interrupcoes_colunas(false);
+    for (int col = 0; col < 4; col++) {
+        gpio_acknowledge_irq(colunas[col], GPIO_IRQ_EDGE_RISE);
+    }
+
+    varrendo = true;
+    instante_borda = time_us_32();
+    candidato = teclado_varrer();
+    add_alarm_in_us(TECLADO_DEBOUNCE_US, alarme_debounce, NULL, true);
+}
+
+static void borda_coluna(void) {
+    if (!(gpio_get_irq_event_mask(COL1_PIN) | gpio_get_irq_event_mask(COL2_PIN) |
+          gpio_get_irq_event_mask(COL3_PIN) | gpio_get_irq_event_mask(COL4_PIN))) {
+        return;
+    }
+    iniciar_varredura();
+}
+
+void configurar_teclado() {
+    // Configurar pinos das linhas como saída
+    for (int row = 0; row < 4; row++) {
+        gpio_init(linhas[row]);
+        gpio_set_dir(linhas[row], GPIO_OUT);
+    }
+
+    // Configurar pinos das colunas como entrada
+    for (int col = 0; col < 4; col++) {
+        gpio_init(colunas[col]);
+        gpio_set_dir(colunas[col], GPIO_IN);
+        gpio_pull_down(colunas[col]);
+    }
+
+    ativar_todas_linhas();
+    gpio_add_raw_irq_handler_masked(MASCARA_COLUNAS, borda_coluna);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    interrupcoes_colunas(true);
+}
+
+void teclado_armar_despertar(bool armar) {
+    for (int col = 0; col < 4; col++) {
+        gpio_set_dormant_irq_enabled(colunas[col], GPIO_IRQ_EDGE_RISE, armar);
+        if (!armar) {
+            gpio_acknowledge_irq(colunas[col], GPIO_IRQ_EDGE_RISE);
+        }
+    }
+}
+
+void teclado_despertou(void) {
+    // A borda chegou com os relógios parados e não gerou a interrupção
+    // normal; a varredura começa agora e o debounce confirma o aperto
+    uint32_t estado = save_and_disable_interrupts();
+    if (!varrendo) {
+        iniciar_varredura();
+    }
+    restore_interrupts(estado);
+}
+#endif
+
+bool teclado_ocioso(void) {
+    return !varrendo;
+}
+
+uint16_t teclado_mascara(char tecla) {
+    for (int i = 0; i < 16; i++) {
+        if (keys[i] == tecla) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+bool teclado_obter_evento(evento_tecla_t *evento) {
+    if (cauda == cabeca) {
+        return false;
+    }
+    *evento = fila[cauda];
+    cauda = (cauda + 1) & (TECLADO_TAMANHO_FILA - 1);
+    return true;
+}
+
+uint32_t teclado_eventos_perdidos(void) {
+    return eventos_perdidos;
+}
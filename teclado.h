@@ -0,0 +1,79 @@
+#ifndef TECLADO_H
+#define TECLADO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Configurações para o teclado matricial
+#define TECLADO_PIN_1 28 // GPIO conectado à linha 1 
+#define TECLADO_PIN_2 27 // GPIO conectado à linha 2 
+#define TECLADO_PIN_3 26 // GPIO conectado à linha 3 
+#define TECLADO_PIN_4 22 // GPIO conectado à linha 4
+#define COL1_PIN 21 // GPIO conectado à coluna 1
+#define COL2_PIN 20 // GPIO conectado à coluna 2
+#define COL3_PIN 19 // GPIO conectado à coluna 3
+#define COL4_PIN 18 // GPIO conectado à coluna 4
+
+// Com MATRIZ_TECLADO_PIO uma máquina de estado do pio1 (teclado.pio) varre
+// o teclado sem parar e só interrompe o processador quando o mapa de teclas
+// muda; sem ele, uma borda nas colunas começa a varredura pelos GPIO, que o
+// alarme do debounce repete enquanto houver tecla apertada.
+#ifndef MATRIZ_TECLADO_PIO
+#define MATRIZ_TECLADO_PIO 0
+#endif
+
+// Tempo que a leitura do teclado precisa ficar estável para valer
+#ifndef TECLADO_DEBOUNCE_US
+#define TECLADO_DEBOUNCE_US 10000
+#endif
+
+// Capacidade da fila de eventos (potência de 2)
+#define TECLADO_TAMANHO_FILA 16
+
+// Evento de tecla produzido pela interrupção do teclado
+typedef struct {
+    char tecla;           // Caractere da tecla
+    bool pressionada;     // true no aperto, false ao soltar
+    uint16_t estado;      // Teclas apertadas logo depois deste evento (bits de teclado_mascara)
+    uint32_t instante_us; // Instante da borda (aperto) ou da confirmação (soltura)
+} evento_tecla_t;
+
+// Função para configurar os pinos utilizados pelo teclado matricial.
+// Configura as linhas como saída e as colunas como entrada, deixa todas as
+// linhas ativas e arma as interrupções de borda de subida das colunas. Com
+// MATRIZ_TECLADO_PIO as linhas passam para a máquina de estado e a
+// interrupção passa a ser a da FIFO RX dela.
+void configurar_teclado();
+
+// Varre as 4 linhas do teclado (com MATRIZ_TECLADO_PIO, retorna a última
+// leitura enviada pela máquina de estado, ainda sem debounce)
+// Retorna:
+// - Mapa de 16 bits com um bit por tecla (bit linha * 4 + coluna)
+uint16_t teclado_varrer(void);
+
+// Retorna o bit da tecla no mapa de teclado_varrer() (0 se não existir),
+// para montar acordes a comparar com evento_tecla_t.estado
+uint16_t teclado_mascara(char tecla);
+
+// Retira o evento mais antigo da fila
+// Retorna:
+// - false se a fila estiver vazia
+bool teclado_obter_evento(evento_tecla_t *evento);
+
+// Retorna true se nenhuma tecla está apertada: todas as linhas ficam
+// ativas e as colunas armadas, então qualquer aperto gera uma borda (com
+// MATRIZ_TECLADO_PIO, a máquina de estado segue varrendo e o aperto chega
+// pela interrupção da FIFO RX)
+bool teclado_ocioso(void);
+
+// Liga ou desliga as colunas como fontes de despertar do modo dormente
+void teclado_armar_despertar(bool armar);
+
+// Trata o aperto que acordou o processador do modo dormente, quando a borda
+// aconteceu com os relógios parados
+void teclado_despertou(void);
+
+// Quantidade de eventos descartados porque a fila estava cheia
+uint32_t teclado_eventos_perdidos(void);
+
+#endif
@@ -0,0 +1,134 @@
+#include "texto.h"
+
+#include <string.h>
+#include "fonte_gerada.h"
+
+#if MATRIZ_ALTURA < FONTE_ALTURA
+#error "a matriz precisa ter pelo menos a altura da fonte"
+#endif
+
+const bitmap_t fonte_bitmap = {fonte_atlas, FONTE_ATLAS_LARGURA, FONTE_ALTURA, FONTE_ATLAS_PALAVRAS};
+
+const glifo_fonte_t *fonte_glifo(char caractere) {
+    unsigned indice = (unsigned char)caractere - (unsigned)FONTE_PRIMEIRO;
+    return &fonte_glifos[indice < FONTE_CARACTERES ? indice : '?' - FONTE_PRIMEIRO];
+}
+
+uint32_t texto_largura(const char *texto) {
+    uint32_t largura = 0;
+    for (; *texto; texto++) {
+        largura += fonte_glifo(*texto)->largura + FONTE_ESPACAMENTO;
+    }
+    return largura ? largura - FONTE_ESPACAMENTO : 0;
+}
+
+void texto_desenhar(tela_t *tela, const janela_t *janela, const char *texto, int x, int y) {
+    // Cada caractere é um trecho do atlas de no máximo 8 colunas, copiado
+    // com uma palavra por linha
+    for (; *texto && x < janela->largura; texto++) {
+        const glifo_fonte_t *glifo = fonte_glifo(*texto);
+        if (x + glifo->largura > 0) {
+            sprite_desenhar(tela, janela, &fonte_bitmap, glifo->x, glifo->largura, x, y);
+        }
+        x += glifo->largura + FONTE_ESPACAMENTO;
+    }
+}
+
+// Quadro "indice": o texto começa com a primeira coluna na borda direita
+// da janela e termina com a janela vazia
+static void desenhar_texto_rolante(const animacao_t *animacao, uint32_t *quadro, uint16_t indice) {
+    const texto_rolante_t *rolante = (const texto_rolante_t *)animacao;
+    static tela_t tela; // Fora da pilha: em painéis grandes passa de alguns KB
+    tela_limpar(&tela);
+    texto_desenhar(&tela, &rolante->janela, rolante->texto, rolante->janela.largura - 1 - indice, rolante->y);
+    tela_expandir(quadro, &tela, calcular_cor_rgb(rolante->b, rolante->r, rolante->g));
+}
+
+void texto_rolante_iniciar(texto_rolante_t *rolante, const char *texto, intensidade_t r, intensidade_t g,
+                           intensidade_t b, uint32_t mili_fps) {
+    rolante->animacao = (animacao_t){desenhar_texto_rolante, NULL, NULL, 0, "texto_rolante"};
+    rolante->r = r;
+    rolante->g = g;
+    rolante->b = b;
+    rolante->mili_fps = mili_fps;
+    rolante->janela = JANELA_MATRIZ;
+    rolante->y = (MATRIZ_ALTURA - FONTE_ALTURA) / 2;
+    texto_rolante_definir(rolante, texto);
+}
+
+void texto_rolante_definir(texto_rolante_t *rolante, const char *texto) {
+    strncpy(rolante->texto, texto, MATRIZ_TEXTO_MAX);
+    rolante->texto[MATRIZ_TEXTO_MAX] = '\0';
+    uint32_t quadros = texto_largura(rolante->texto) + (uint32_t)rolante->janela.largura;
+    rolante->animacao.quant_quadros = (uint16_t)(quadros < UINT16_MAX ? quadros : UINT16_MAX);
+}
+
+// Lê um número decimal de até 1000, com até três casas depois do ponto
+// Retorna:
+// - false se o texto não for um número nesse formato
+static bool ler_milesimos(const char *texto, uint32_t *milesimos) {
+    uint32_t inteiro = 0, fracao = 0, escala = 1000;
+    const char *c = texto;
+    for (; *c >= '0' && *c <= '9'; c++) {
+        inteiro = inteiro * 10 + (uint32_t)(*c - '0');
+        if (inteiro > 1000) {
+            return false;
+        }
+    }
+    if (*c == '.') {
+        for (c++; *c >= '0' && *c <= '9' && escala > 1; c++) {
+            escala /= 10;
+            fracao += (uint32_t)(*c - '0') * escala;
+        }
+    }
+    *milesimos = inteiro * 1000 + fracao;
+    return c != texto && *c == '\0' && *milesimos <= 1000000;
+}
+
+// Lê RRGGBB em hexadecimal
+static bool ler_cor(const char *texto, uint32_t *cor) {
+    uint32_t valor = 0;
+    for (int i = 0; i < 6; i++) {
+        char c = texto[i];
+        uint32_t digito;
+        if (c >= '0' && c <= '9') {
+            digito = (uint32_t)(c - '0');
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            digito = (uint32_t)((c | 0x20) - 'a' + 10);
+        } else {
+            return false;
+        }
+        valor = valor << 4 | digito;
+    }
+    *cor = valor;
+    return texto[6] == '\0';
+}
+
+bool texto_rolante_comando(texto_rolante_t *rolante, char comando, const char *argumento) {
+    switch (comando) {
+        case 't':
+            texto_rolante_definir(rolante, argumento);
+            return true;
+        case 'v': {
+            uint32_t mili_fps;
+            if (!ler_milesimos(argumento, &mili_fps) || mili_fps == 0) {
+                return false;
+            }
+            rolante->mili_fps = mili_fps;
+            return true;
+        }
+        case 'k': {
+            uint32_t cor;
+            if (!ler_cor(argumento, &cor)) {
+                return false;
+            }
+            // 0xFF vira 65535, a intensidade máxima
+            rolante->r = (intensidade_t)(((cor >> 16) & 0xFF) * 257);
+            rolante->g = (intensidade_t)(((cor >> 8) & 0xFF) * 257);
+            rolante->b = (intensidade_t)((cor & 0xFF) * 257);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
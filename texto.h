@@ -0,0 +1,85 @@
+#ifndef TEXTO_H
+#define TEXTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "animacoes.h"
+#include "sprite.h"
+
+// Fonte de fonte.txt: 5 linhas de altura, largura de 1 a 8 por caractere
+#define FONTE_ALTURA 5
+#define FONTE_PRIMEIRO ' '
+#define FONTE_CARACTERES 95 // ' ' a '~'
+#define FONTE_ESPACAMENTO 1 // Colunas apagadas entre dois caracteres
+
+// Posição de um caractere no atlas (fonte_gerada.c)
+typedef struct {
+    uint16_t x;
+    uint8_t largura;
+} glifo_fonte_t;
+
+// Atlas da fonte como bitmap, para sprite_desenhar()
+extern const bitmap_t fonte_bitmap;
+
+// Retorna a posição no atlas do caractere (minúsculas usam as maiúsculas e
+// os caracteres sem desenho, o '?')
+const glifo_fonte_t *fonte_glifo(char caractere);
+
+// Largura do texto em pixels, com o espaçamento entre os caracteres
+uint32_t texto_largura(const char *texto);
+
+// Função para desenhar um texto numa linha
+// Parâmetros:
+// - tela: Tela de destino
+// - janela: Área da tela em que o texto aparece (recorta o resto)
+// - texto: Texto terminado em '\0'
+// - x, y: Canto superior esquerdo do primeiro caractere, relativo à janela;
+//   x negativo começa o texto antes da borda, e os caracteres inteiramente
+//   fora da janela nem são copiados
+void texto_desenhar(tela_t *tela, const janela_t *janela, const char *texto, int x, int y);
+
+// Tamanho máximo do texto rolante, sem o '\0'
+#ifndef MATRIZ_TEXTO_MAX
+#define MATRIZ_TEXTO_MAX 127
+#endif
+
+// Texto que entra pela direita da janela e sai pela esquerda, uma coluna
+// por quadro: o quadro n desenha o texto na coluna largura da janela - n,
+// então cada quadro depende só do índice, como nas demais animações, e a
+// velocidade é a taxa de quadros (colunas por segundo).
+typedef struct {
+    animacao_t animacao; // Deve ser o primeiro campo
+    char texto[MATRIZ_TEXTO_MAX + 1];
+    intensidade_t r;
+    intensidade_t g;
+    intensidade_t b;
+    uint32_t mili_fps; // Colunas por segundo, em milésimos (use FPS())
+    janela_t janela;
+    int16_t y; // Linha do topo do texto dentro da janela
+} texto_rolante_t;
+
+// Função para preparar um texto rolante na janela da matriz inteira,
+// centralizado na vertical
+// Parâmetros:
+// - rolante: Texto rolante a ser preparado
+// - texto: Texto inicial (cortado em MATRIZ_TEXTO_MAX caracteres)
+// - r, g, b: Cor dos pixels acesos
+// - mili_fps: Velocidade em colunas por segundo, em milésimos
+void texto_rolante_iniciar(texto_rolante_t *rolante, const char *texto, intensidade_t r, intensidade_t g,
+                           intensidade_t b, uint32_t mili_fps);
+
+// Troca o texto e recalcula o número de quadros. Se a animação estiver no
+// cache de quadros, ela deve ser esquecida (cache_quadros_esquecer()).
+void texto_rolante_definir(texto_rolante_t *rolante, const char *texto);
+
+// Função para aplicar uma linha dos comandos de texto do console
+// Parâmetros:
+// - rolante: Texto rolante alterado
+// - comando: 't' troca o texto, 'v' a velocidade (colunas por segundo,
+//   aceita fração com ponto) e 'k' a cor (RRGGBB em hexadecimal)
+// - argumento: Resto da linha
+// Retorna:
+// - false se o comando ou o argumento for inválido (nada muda)
+bool texto_rolante_comando(texto_rolante_t *rolante, char comando, const char *argumento);
+
+#endif
@@ -0,0 +1,87 @@
+#include "transporte_pio_dma.h"
+
+#include "hardware/dma.h"
+#include "instrumentacao.h"
+#include "pico/stdlib.h"
+
+#if MATRIZ_INSTRUMENTACAO
+#include "hardware/irq.h"
+
+static uint canal_instrumentado;
+
+// Interrupção de fim de transferência: marca o instante em que a última
+// palavra do quadro saiu do framebuffer para a FIFO. Todas as vias têm o
+// mesmo tamanho, então basta acompanhar a última via disparada.
+static void dma_concluido(void) {
+    if (dma_channel_get_irq1_status(canal_instrumentado)) {
+        dma_channel_acknowledge_irq1(canal_instrumentado);
+        instrumentacao_envio_concluido(time_us_32());
+    }
+}
+#endif
+
+static void enviar(transporte_leds_t *base, const uint32_t *pixels, uint32_t num_pixels) {
+    transporte_pio_dma_t *transporte = (transporte_pio_dma_t *)base;
+    uint32_t por_via = num_pixels / MATRIZ_VIAS;
+
+    // Cada via recebe o seu trecho do framebuffer e todas partem juntas
+    for (int via = 0; via < MATRIZ_VIAS; via++) {
+        dma_channel_set_read_addr(transporte->canal_dma[via], pixels + via * por_via, false);
+        dma_channel_set_trans_count(transporte->canal_dma[via], por_via, false);
+    }
+    fim_envio_iniciar(&transporte->fim);
+    dma_start_channel_mask(transporte->mascara_canais);
+}
+
+static bool ocupado(transporte_leds_t *base) {
+    transporte_pio_dma_t *transporte = (transporte_pio_dma_t *)base;
+    bool dma_ocupado = false;
+    for (int via = 0; via < MATRIZ_VIAS; via++) {
+        dma_ocupado |= dma_channel_is_busy(transporte->canal_dma[via]);
+    }
+    bool vias_paradas = (transporte->pio->fdebug & transporte->mascara_paradas) == transporte->mascara_paradas;
+
+    switch (fim_envio_passo(&transporte->fim, dma_ocupado, vias_paradas, time_us_64())) {
+        case FIM_ENVIO_LIMPAR_PARADAS:
+            transporte->pio->fdebug = transporte->mascara_paradas; // Escrita de 1 limpa os TXSTALL
+            return true;
+        case FIM_ENVIO_LIVRE:
+            return false;
+        default:
+            return true;
+    }
+}
+
+void transporte_pio_dma_iniciar(transporte_pio_dma_t *transporte, PIO pio, const uint *sm) {
+    transporte->base.enviar = enviar;
+    transporte->base.ocupado = ocupado;
+    transporte->pio = pio;
+    transporte->mascara_canais = 0;
+    transporte->mascara_paradas = 0;
+    fim_envio_iniciar(&transporte->fim);
+
+    for (int via = 0; via < MATRIZ_VIAS; via++) {
+        uint canal = dma_claim_unused_channel(true);
+        transporte->sm[via] = sm[via];
+        transporte->canal_dma[via] = canal;
+        transporte->mascara_canais |= 1u << canal;
+        transporte->mascara_paradas |= 1u << (PIO_FDEBUG_TXSTALL_LSB + sm[via]);
+
+        // Palavras de 32 bits lidas do framebuffer e escritas sempre no mesmo
+        // endereço (FIFO TX), uma a cada pedido da máquina de estado
+        dma_channel_config c = dma_channel_get_default_config(canal);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, pio_get_dreq(pio, sm[via], true));
+
+        dma_channel_configure(canal, &c, &pio->txf[sm[via]], NULL, 0, false);
+    }
+
+#if MATRIZ_INSTRUMENTACAO
+    canal_instrumentado = transporte->canal_dma[MATRIZ_VIAS - 1];
+    dma_channel_set_irq1_enabled(canal_instrumentado, true);
+    irq_add_shared_handler(DMA_IRQ_1, dma_concluido, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef TRANSPORTE_PIO_DMA_H
+#define TRANSPORTE_PIO_DMA_H
+
+#include "hardware/pio.h"
+#include "fim_envio.h"
+#include "saida_leds.h"
+
+// Transporte que envia o quadro por DMA para as FIFOs TX das máquinas de
+// estado do programa animacao_MatrizLED, uma máquina e um canal por via, no
+// ritmo do DREQ de cada máquina. As vias transmitem em paralelo, então o
+// tempo de envio de um quadro é o de PIXELS_POR_VIA pixels. O fim do DMA
+// não é o fim do quadro: a FIFO e o OSR ainda guardam até 9 pixels, então
+// o transporte só fica livre MATRIZ_LATCH_US depois de as máquinas pararem
+// por falta de dados (fim_envio.h).
+typedef struct {
+    transporte_leds_t base; // Deve ser o primeiro campo
+    PIO pio;
+    uint sm[MATRIZ_VIAS];
+    uint canal_dma[MATRIZ_VIAS];
+    uint32_t mascara_canais; // Canais disparados juntos a cada quadro
+    uint32_t mascara_paradas; // Bits TXSTALL (FDEBUG) das máquinas das vias
+    fim_envio_t fim; // Espera pelo fim do quadro e pelo latch
+} transporte_pio_dma_t;
+
+// Reserva um canal de DMA por via e os configura para alimentar as máquinas de estado
+// Parâmetros:
+// - transporte: Transporte a ser inicializado
+// - pio: Instância do bloco PIO
+// - sm: Máquinas de estado já configuradas com o programa animacao_MatrizLED,
+//   uma por via (MATRIZ_VIAS)
+void transporte_pio_dma_iniciar(transporte_pio_dma_t *transporte, PIO pio, const uint *sm);
+
+#endif
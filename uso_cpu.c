@@ -0,0 +1,24 @@
+#include "uso_cpu.h"
+
+uso_cpu_t uso_nucleos[2];
+
+void uso_cpu_acordou(uso_cpu_t *uso, uint32_t agora_us) {
+    uso->inicio_trabalho_us = agora_us;
+}
+
+void uso_cpu_dormindo(uso_cpu_t *uso, uint32_t agora_us) {
+    uso->ocupado_us += agora_us - uso->inicio_trabalho_us;
+}
+
+uint32_t uso_cpu_medir(const uso_cpu_t *uso, uso_cpu_amostra_t *anterior, uint32_t agora_us) {
+    uint32_t ocupado = uso->ocupado_us;
+    uint32_t delta_ocupado = ocupado - anterior->ocupado_us;
+    uint32_t janela = agora_us - anterior->instante_us;
+
+    anterior->ocupado_us = ocupado;
+    anterior->instante_us = agora_us;
+    if (janela == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)delta_ocupado * 1000) / janela);
+}
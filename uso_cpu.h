@@ -0,0 +1,34 @@
+#ifndef USO_CPU_H
+#define USO_CPU_H
+
+#include <stdint.h>
+
+// Contador de utilização de um núcleo: acumula o tempo em que o núcleo ficou
+// trabalhando (fora da espera pelo próximo prazo). Cada contador só é
+// escrito pelo próprio núcleo; o outro núcleo apenas lê.
+typedef struct {
+    volatile uint32_t ocupado_us; // Tempo ocupado acumulado (dá a volta em ~71 min)
+    uint32_t inicio_trabalho_us;  // Início do trecho ocupado em andamento
+} uso_cpu_t;
+
+// Leitura anterior de um contador, guardada por quem calcula a utilização
+typedef struct {
+    uint32_t ocupado_us;
+    uint32_t instante_us;
+} uso_cpu_amostra_t;
+
+// Um contador por núcleo do RP2040
+extern uso_cpu_t uso_nucleos[2];
+
+// Marca o início de um trecho de trabalho (o núcleo acabou de acordar)
+void uso_cpu_acordou(uso_cpu_t *uso, uint32_t agora_us);
+
+// Marca o fim de um trecho de trabalho (o núcleo vai esperar)
+void uso_cpu_dormindo(uso_cpu_t *uso, uint32_t agora_us);
+
+// Calcula a utilização desde a amostra anterior e atualiza a amostra
+// Retorna:
+// - Utilização em décimos de porcento (0 a 1000)
+uint32_t uso_cpu_medir(const uso_cpu_t *uso, uso_cpu_amostra_t *anterior, uint32_t agora_us);
+
+#endif